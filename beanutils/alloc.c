@@ -0,0 +1,317 @@
+/* beanutils: Some data structure implementations and utility functions, I
+ * guess.
+ *
+ * Copyright (c) Eason Qin, 2024.
+ *
+ * NOTE: This source code form is licensed under the MIT license and comes
+ * with ABSOLUTELY NO WARRANTY. For more information, please view the
+ * `LICENSE` file at the root of the project.
+ */
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "alloc.h"
+#include "common.h"
+#include "logger.h"
+
+// Keeps the memory after the header aligned for any type.
+#define _BEAN_ALLOC_HEADER_SIZE _Alignof(max_align_t)
+
+static void* b_alloc_libc_alloc(void* ctx, size_t size, b_alloctag_t tag) {
+    (void)ctx;
+    (void)tag;
+    return malloc(size);
+}
+
+static void* b_alloc_libc_realloc(void* ctx, void* ptr, size_t size,
+                                  b_alloctag_t tag) {
+    (void)ctx;
+    (void)tag;
+    return realloc(ptr, size);
+}
+
+static void b_alloc_libc_free(void* ctx, void* ptr, b_alloctag_t tag) {
+    (void)ctx;
+    (void)tag;
+    free(ptr);
+}
+
+static const BeanAllocator b_alloc_libc = {
+    .alloc = b_alloc_libc_alloc,
+    .realloc = b_alloc_libc_realloc,
+    .free = b_alloc_libc_free,
+};
+
+static _Atomic(const BeanAllocator*) b_alloc_global = &b_alloc_libc;
+
+static const char* b_alloctag_names[_BEAN_ALLOC_TAGS] = {
+    [ALLOCTAG_OTHER] = "other",     [ALLOCTAG_ARRAY] = "array",
+    [ALLOCTAG_ARRAY_ELEM] = "elems", [ALLOCTAG_STRING] = "string",
+    [ALLOCTAG_VEC] = "vec",         [ALLOCTAG_HASHMAP] = "hashmap",
+    [ALLOCTAG_ARENA] = "arena",     [ALLOCTAG_POOL] = "pool",
+    [ALLOCTAG_BUILDER] = "builder", [ALLOCTAG_LINEREADER] = "reader",
+    [ALLOCTAG_QUEUE] = "queue",     [ALLOCTAG_INTERNER] = "intern",
+};
+
+const BeanAllocator* b_allocator_libc(void) {
+    return &b_alloc_libc;
+}
+
+const BeanAllocator* b_allocator_get(void) {
+    return atomic_load_explicit(&b_alloc_global, memory_order_acquire);
+}
+
+b_errno_t b_allocator_set(const BeanAllocator* allocator) {
+    atomic_store_explicit(&b_alloc_global,
+                          allocator != NULL ? allocator : &b_alloc_libc,
+                          memory_order_release);
+
+    return STATUS_SUCCESS;
+}
+
+void* b_alloc(const BeanAllocator* allocator, size_t size, b_alloctag_t tag) {
+    if (allocator == NULL)
+        allocator = b_allocator_get();
+
+    return allocator->alloc(allocator->ctx, size, tag);
+}
+
+void* b_calloc(const BeanAllocator* allocator, size_t count, size_t size,
+               b_alloctag_t tag) {
+    void* res;
+
+    if (allocator == NULL)
+        allocator = b_allocator_get();
+
+    // `calloc` can hand out pages that are already zeroed.
+    if (allocator == &b_alloc_libc)
+        return calloc(count, size);
+
+    if (size != 0 && count > SIZE_MAX / size)
+        return NULL;
+
+    if ((res = allocator->alloc(allocator->ctx, count * size, tag)) != NULL)
+        memset(res, 0, count * size);
+
+    return res;
+}
+
+void* b_realloc(const BeanAllocator* allocator, void* ptr, size_t size,
+                b_alloctag_t tag) {
+    if (allocator == NULL)
+        allocator = b_allocator_get();
+
+    return allocator->realloc(allocator->ctx, ptr, size, tag);
+}
+
+void b_free(const BeanAllocator* allocator, void* ptr, b_alloctag_t tag) {
+    if (ptr == NULL)
+        return;
+
+    if (allocator == NULL)
+        allocator = b_allocator_get();
+
+    allocator->free(allocator->ctx, ptr, tag);
+}
+
+void* b_alloc_aligned(const BeanAllocator* allocator, size_t size,
+                      size_t align, b_alloctag_t tag) {
+    unsigned char* raw;
+    uintptr_t res;
+
+    if (align < _Alignof(max_align_t))
+        align = _Alignof(max_align_t);
+    if (size > SIZE_MAX - align - sizeof(void*))
+        return NULL;
+
+    // The pointer to give back sits just below the aligned block.
+    raw = b_alloc(allocator, size + align + sizeof(void*), tag);
+    if (raw == NULL)
+        return NULL;
+
+    res = ((uintptr_t)raw + sizeof(void*) + align - 1) &
+          ~(uintptr_t)(align - 1);
+    memcpy((void*)(res - sizeof(void*)), &raw, sizeof(raw));
+
+    return (void*)res;
+}
+
+void b_free_aligned(const BeanAllocator* allocator, void* ptr,
+                    b_alloctag_t tag) {
+    void* raw;
+
+    if (ptr == NULL)
+        return;
+
+    memcpy(&raw, (unsigned char*)ptr - sizeof(void*), sizeof(raw));
+    b_free(allocator, raw, tag);
+}
+
+// Unknown tags are counted as `ALLOCTAG_OTHER`.
+static size_t b_alloctag_index(b_alloctag_t tag) {
+    return (unsigned)tag < _BEAN_ALLOC_TAGS ? (size_t)tag : ALLOCTAG_OTHER;
+}
+
+static BeanAllocCounters* b_stats_counters(BeanStatsAllocator* stats,
+                                           b_alloctag_t tag) {
+    return &stats->counters[b_alloctag_index(tag)];
+}
+
+static void b_stats_grow(BeanAllocCounters* counters, size_t size) {
+    size_t live = atomic_fetch_add_explicit(&counters->live, size,
+                                            memory_order_relaxed) +
+                  size;
+    size_t peak = atomic_load_explicit(&counters->peak, memory_order_relaxed);
+
+    atomic_fetch_add_explicit(&counters->bytes, size, memory_order_relaxed);
+    while (live > peak &&
+           !atomic_compare_exchange_weak_explicit(&counters->peak, &peak, live,
+                                                  memory_order_relaxed,
+                                                  memory_order_relaxed))
+        ;
+}
+
+static void* b_stats_alloc(void* ctx, size_t size, b_alloctag_t tag) {
+    BeanStatsAllocator* stats = ctx;
+    BeanAllocCounters* counters = b_stats_counters(stats, tag);
+    unsigned char* header;
+
+    if (size > SIZE_MAX - _BEAN_ALLOC_HEADER_SIZE)
+        return NULL;
+
+    header = b_alloc(stats->parent, _BEAN_ALLOC_HEADER_SIZE + size, tag);
+    if (header == NULL)
+        return NULL;
+
+    memcpy(header, &size, sizeof(size));
+    atomic_fetch_add_explicit(&counters->allocs, 1, memory_order_relaxed);
+    b_stats_grow(counters, size);
+
+    return header + _BEAN_ALLOC_HEADER_SIZE;
+}
+
+static void* b_stats_realloc(void* ctx, void* ptr, size_t size,
+                             b_alloctag_t tag) {
+    BeanStatsAllocator* stats = ctx;
+    BeanAllocCounters* counters = b_stats_counters(stats, tag);
+    unsigned char* header;
+    unsigned char* newheader;
+    uintptr_t old;
+    size_t oldsize;
+
+    if (ptr == NULL)
+        return b_stats_alloc(ctx, size, tag);
+
+    if (size > SIZE_MAX - _BEAN_ALLOC_HEADER_SIZE)
+        return NULL;
+
+    header = (unsigned char*)ptr - _BEAN_ALLOC_HEADER_SIZE;
+    old = (uintptr_t)header;
+    memcpy(&oldsize, header, sizeof(oldsize));
+
+    newheader =
+        b_realloc(stats->parent, header, _BEAN_ALLOC_HEADER_SIZE + size, tag);
+    if (newheader == NULL)
+        return NULL;
+
+    memcpy(newheader, &size, sizeof(size));
+    atomic_fetch_add_explicit(&counters->reallocs, 1, memory_order_relaxed);
+    if ((uintptr_t)newheader != old)
+        atomic_fetch_add_explicit(&counters->moves, 1, memory_order_relaxed);
+
+    if (size > oldsize)
+        b_stats_grow(counters, size - oldsize);
+    else
+        atomic_fetch_sub_explicit(&counters->live, oldsize - size,
+                                  memory_order_relaxed);
+
+    return newheader + _BEAN_ALLOC_HEADER_SIZE;
+}
+
+static void b_stats_free(void* ctx, void* ptr, b_alloctag_t tag) {
+    BeanStatsAllocator* stats = ctx;
+    BeanAllocCounters* counters = b_stats_counters(stats, tag);
+    unsigned char* header = (unsigned char*)ptr - _BEAN_ALLOC_HEADER_SIZE;
+    size_t size;
+
+    memcpy(&size, header, sizeof(size));
+    atomic_fetch_add_explicit(&counters->frees, 1, memory_order_relaxed);
+    atomic_fetch_sub_explicit(&counters->live, size, memory_order_relaxed);
+
+    b_free(stats->parent, header, tag);
+}
+
+b_errno_t b_stats_allocator_init(BeanStatsAllocator* stats,
+                                 const BeanAllocator* parent) {
+    *stats = (BeanStatsAllocator){
+        .allocator =
+            {
+                .alloc = b_stats_alloc,
+                .realloc = b_stats_realloc,
+                .free = b_stats_free,
+                .ctx = stats,
+            },
+        .parent = parent != NULL ? parent : &b_alloc_libc,
+    };
+
+    return STATUS_SUCCESS;
+}
+
+BeanAllocStats b_stats_allocator_get(const BeanStatsAllocator* stats,
+                                     b_alloctag_t tag) {
+    const BeanAllocCounters* counters =
+        &stats->counters[b_alloctag_index(tag)];
+
+    return (BeanAllocStats){
+        .allocs = atomic_load_explicit(&counters->allocs, memory_order_relaxed),
+        .reallocs =
+            atomic_load_explicit(&counters->reallocs, memory_order_relaxed),
+        .frees = atomic_load_explicit(&counters->frees, memory_order_relaxed),
+        .moves = atomic_load_explicit(&counters->moves, memory_order_relaxed),
+        .bytes = atomic_load_explicit(&counters->bytes, memory_order_relaxed),
+        .live = atomic_load_explicit(&counters->live, memory_order_relaxed),
+        .peak = atomic_load_explicit(&counters->peak, memory_order_relaxed),
+    };
+}
+
+BeanAllocStats b_stats_allocator_total(const BeanStatsAllocator* stats) {
+    BeanAllocStats total = {0};
+
+    for (int tag = 0; tag < _BEAN_ALLOC_TAGS; tag++) {
+        BeanAllocStats s = b_stats_allocator_get(stats, (b_alloctag_t)tag);
+
+        total.allocs += s.allocs;
+        total.reallocs += s.reallocs;
+        total.frees += s.frees;
+        total.moves += s.moves;
+        total.bytes += s.bytes;
+        total.live += s.live;
+        total.peak += s.peak;
+    }
+
+    return total;
+}
+
+void b_stats_allocator_dump(const BeanStatsAllocator* stats,
+                            b_loglevel_t lvl) {
+    for (int tag = 0; tag < _BEAN_ALLOC_TAGS; tag++) {
+        BeanAllocStats s = b_stats_allocator_get(stats, (b_alloctag_t)tag);
+
+        if (s.allocs == 0 && s.reallocs == 0)
+            continue;
+
+        b_log(lvl,
+              "alloc %-7s %zu allocs, %zu reallocs (%zu moved), %zu frees, "
+              "%zu B live, %zu B peak, %zu B total",
+              b_alloctag_names[tag], s.allocs, s.reallocs, s.moves, s.frees,
+              s.live, s.peak, s.bytes);
+    }
+}
+
+const char* b_alloctag_name(b_alloctag_t tag) {
+    return b_alloctag_names[b_alloctag_index(tag)];
+}
@@ -0,0 +1,193 @@
+/* beanutils: Some data structure implementations and utility functions, I
+ * guess.
+ *
+ * Copyright (c) Eason Qin, 2024.
+ *
+ * NOTE: This source code form is licensed under the MIT license and comes
+ * with ABSOLUTELY NO WARRANTY. For more information, please view the
+ * `LICENSE` file at the root of the project.
+ */
+
+#pragma once
+
+#include <stdatomic.h>
+#include <stddef.h>
+
+#include "common.h"
+#include "logger.h"
+
+/**
+ * What an allocation is for, so an allocator can tell containers apart.
+ */
+typedef enum {
+    ALLOCTAG_OTHER = 0,
+    /** The pointer buffer of a `BeanArray`. */
+    ALLOCTAG_ARRAY,
+    /** Elements allocated through `b_array_alloc_elem`. */
+    ALLOCTAG_ARRAY_ELEM,
+    ALLOCTAG_STRING,
+    ALLOCTAG_VEC,
+    ALLOCTAG_HASHMAP,
+    ALLOCTAG_ARENA,
+    ALLOCTAG_POOL,
+    /** The chunks of a `BeanStringBuilder`. */
+    ALLOCTAG_BUILDER,
+    /** The buffer of a `BeanLineReader`. */
+    ALLOCTAG_LINEREADER,
+    /** The cells of a `BeanQueue` and the slots of a `BeanRing`. */
+    ALLOCTAG_QUEUE,
+    /** The shards and tables of a `BeanInterner`. */
+    ALLOCTAG_INTERNER,
+} b_alloctag_t;
+
+#define _BEAN_ALLOC_TAGS (ALLOCTAG_INTERNER + 1)
+
+/**
+ * A set of allocation functions that containers call instead of `malloc`,
+ * `realloc` and `free`. Memory has to be given back to the allocator it came
+ * from, and every allocation has to be aligned for any type.
+ *
+ * `ctx` is passed to every function as is.
+ *
+ * Short-lived scratch buffers are left on the C library allocator: those of
+ * the sorts (`sort.h`), the parallel algorithms (`parallel.h`) and the tasks
+ * and workers of a `BeanThreadPool`. So are the asynchronous logger's ring
+ * and the trace buffers, which live as long as the process, and memory the
+ * caller is told to `free`.
+ */
+typedef struct {
+    void* (*alloc)(void* ctx, size_t size, b_alloctag_t tag);
+    void* (*realloc)(void* ctx, void* ptr, size_t size, b_alloctag_t tag);
+    void (*free)(void* ctx, void* ptr, b_alloctag_t tag);
+    void* ctx;
+} BeanAllocator;
+
+/**
+ * Gets the allocator that wraps the C library's `malloc`, `realloc` and
+ * `free`. It is the global allocator until `b_allocator_set` is called.
+ */
+const BeanAllocator* b_allocator_libc(void);
+
+/**
+ * Gets the global allocator, which containers pick up when they are
+ * initialized.
+ */
+const BeanAllocator* b_allocator_get(void);
+
+/**
+ * Replaces the global allocator. Containers that are already initialized
+ * keep using the allocator they started with.
+ *
+ *  @param allocator  Has to outlive every container that uses it. `NULL`
+ *                    restores the C library allocator.
+ */
+b_errno_t b_allocator_set(const BeanAllocator* allocator);
+
+/**
+ * Allocates `size` bytes from `allocator`, or from the global allocator if
+ * it is `NULL`.
+ */
+void* b_alloc(const BeanAllocator* allocator, size_t size, b_alloctag_t tag);
+
+/**
+ * Allocates `count` zeroed elements of `size` bytes from `allocator`.
+ */
+void* b_calloc(const BeanAllocator* allocator, size_t count, size_t size,
+               b_alloctag_t tag);
+
+/**
+ * Resizes an allocation made from `allocator`. `ptr` may be `NULL`.
+ */
+void* b_realloc(const BeanAllocator* allocator, void* ptr, size_t size,
+                b_alloctag_t tag);
+
+/**
+ * Gives an allocation back to `allocator`. `ptr` may be `NULL`.
+ */
+void b_free(const BeanAllocator* allocator, void* ptr, b_alloctag_t tag);
+
+/**
+ * Allocates `size` bytes aligned to `align`, a power of two, from
+ * `allocator`, e.g. to keep data on its own cache lines. The allocation is
+ * padded to make room for the alignment.
+ */
+void* b_alloc_aligned(const BeanAllocator* allocator, size_t size,
+                      size_t align, b_alloctag_t tag);
+
+/**
+ * Gives an allocation made by `b_alloc_aligned` back to `allocator`. `ptr`
+ * may be `NULL`.
+ */
+void b_free_aligned(const BeanAllocator* allocator, void* ptr,
+                    b_alloctag_t tag);
+
+/**
+ * Allocation counters for one tag of a `BeanStatsAllocator`.
+ */
+typedef struct {
+    /** Calls to `alloc`, `realloc` and `free`. */
+    size_t allocs;
+    size_t reallocs;
+    size_t frees;
+    /** Reallocations that had to move the allocation. */
+    size_t moves;
+    /** Bytes requested over the allocator's lifetime. */
+    size_t bytes;
+    /** Bytes currently allocated, and the most there have ever been. */
+    size_t live;
+    size_t peak;
+} BeanAllocStats;
+
+typedef struct {
+    atomic_size_t allocs;
+    atomic_size_t reallocs;
+    atomic_size_t frees;
+    atomic_size_t moves;
+    atomic_size_t bytes;
+    atomic_size_t live;
+    atomic_size_t peak;
+} BeanAllocCounters;
+
+/**
+ * An allocator that passes every call on to `parent` and counts calls,
+ * bytes, moves and peak usage per `b_alloctag_t`. Hand `&stats->allocator`
+ * to `b_allocator_set` or to a container.
+ *
+ * Each allocation carries a small header recording its size. The counters are
+ * updated atomically, so it may be shared between threads if `parent` may.
+ */
+typedef struct {
+    BeanAllocator allocator;
+    const BeanAllocator* parent;
+    BeanAllocCounters counters[_BEAN_ALLOC_TAGS];
+} BeanStatsAllocator;
+
+/**
+ * Initializes a new `BeanStatsAllocator` on top of `parent`, or on top of the
+ * C library allocator if `parent` is `NULL`.
+ */
+b_errno_t b_stats_allocator_init(BeanStatsAllocator* stats,
+                                 const BeanAllocator* parent);
+
+/**
+ * Gets a snapshot of the counters of `tag`.
+ */
+BeanAllocStats b_stats_allocator_get(const BeanStatsAllocator* stats,
+                                     b_alloctag_t tag);
+
+/**
+ * Sums the counters of every tag. The peak is the sum of the peaks of each
+ * tag, which may be more than the peak of the whole.
+ */
+BeanAllocStats b_stats_allocator_total(const BeanStatsAllocator* stats);
+
+/**
+ * Logs one line of counters for every tag that has been used.
+ */
+void b_stats_allocator_dump(const BeanStatsAllocator* stats,
+                            b_loglevel_t lvl);
+
+/**
+ * Gets the name of an allocation tag, e.g. `"array"`.
+ */
+const char* b_alloctag_name(b_alloctag_t tag);
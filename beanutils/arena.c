@@ -0,0 +1,187 @@
+/* beanutils: Some data structure implementations and utility functions, I
+ * guess.
+ *
+ * Copyright (c) Eason Qin, 2024.
+ *
+ * NOTE: This source code form is licensed under the MIT license and comes
+ * with ABSOLUTELY NO WARRANTY. For more information, please view the
+ * `LICENSE` file at the root of the project.
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+#include "common.h"
+#include "trace.h"
+
+#define _BEAN_ARENA_ALIGNMENT _Alignof(max_align_t)
+
+struct BeanArenaBlock {
+    BeanArenaBlock* next;
+    size_t cap;
+    size_t used;
+    _Alignas(max_align_t) unsigned char data[];
+};
+
+static size_t b_arena_align(size_t size) {
+    return (size + _BEAN_ARENA_ALIGNMENT - 1) & ~(_BEAN_ARENA_ALIGNMENT - 1);
+}
+
+static BeanArenaBlock* b_arena_new_block(BeanArena* arena, size_t cap) {
+    B_TRACE_FUNC();
+    BeanArenaBlock* block =
+        b_alloc(arena->allocator, sizeof(BeanArenaBlock) + cap, ALLOCTAG_ARENA);
+
+    if (block == NULL)
+        return NULL;
+
+    block->next = NULL;
+    block->cap = cap;
+    block->used = 0;
+
+    return block;
+}
+
+b_errno_t b_arena_init(BeanArena* arena) {
+    return b_arena_init_with_size(arena, _BEAN_ARENA_DEFAULT_BLOCK_SIZE);
+}
+
+b_errno_t b_arena_init_with_size(BeanArena* arena, size_t blocksize) {
+    if (blocksize == 0)
+        return STATUS_INVALID_OPERATION;
+
+    *arena = (BeanArena){
+        .head = NULL,
+        .blocksize = b_arena_align(blocksize),
+        .allocator = b_allocator_get(),
+    };
+
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_arena_deinit(BeanArena* arena) {
+    BeanArenaBlock* block = arena->head;
+
+    if (arena->blocksize == 0)
+        return STATUS_INVALID_OPERATION;
+
+    while (block != NULL) {
+        BeanArenaBlock* next = block->next;
+        b_free(arena->allocator, block, ALLOCTAG_ARENA);
+        block = next;
+    }
+
+    *arena = (BeanArena){0};
+
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_arena_set_allocator(BeanArena* arena,
+                                const BeanAllocator* allocator) {
+    if (arena->head != NULL)
+        return STATUS_INVALID_OPERATION;
+
+    arena->allocator = allocator != NULL ? allocator : b_allocator_get();
+
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_arena_reset(BeanArena* arena) {
+    BeanArenaBlock* keep = NULL;
+    BeanArenaBlock* block = arena->head;
+
+    if (arena->blocksize == 0)
+        return STATUS_INVALID_OPERATION;
+
+    while (block != NULL) {
+        BeanArenaBlock* next = block->next;
+
+        if (keep == NULL && block->cap == arena->blocksize) {
+            keep = block;
+            keep->next = NULL;
+            keep->used = 0;
+        } else {
+            b_free(arena->allocator, block, ALLOCTAG_ARENA);
+        }
+
+        block = next;
+    }
+
+    arena->head = keep;
+
+    return STATUS_SUCCESS;
+}
+
+void* b_arena_alloc(BeanArena* arena, size_t size) {
+    BeanArenaBlock* block = arena->head;
+    void* res;
+
+    if (arena->blocksize == 0)
+        return NULL;
+
+    size = b_arena_align(size == 0 ? 1 : size);
+
+    if (block == NULL || block->cap - block->used < size) {
+        if (size > arena->blocksize / 2) {
+            // Big allocations get a dedicated block, which is linked behind
+            // the current one so that its free space is not thrown away.
+            if ((block = b_arena_new_block(arena, size)) == NULL)
+                return NULL;
+
+            block->used = size;
+            if (arena->head != NULL) {
+                block->next = arena->head->next;
+                arena->head->next = block;
+            } else {
+                arena->head = block;
+            }
+
+            return block->data;
+        }
+
+        if ((block = b_arena_new_block(arena, arena->blocksize)) == NULL)
+            return NULL;
+
+        block->next = arena->head;
+        arena->head = block;
+    }
+
+    res = &block->data[block->used];
+    block->used += size;
+
+    return res;
+}
+
+void* b_arena_realloc(BeanArena* arena, void* ptr, size_t oldsize,
+                      size_t newsize) {
+    BeanArenaBlock* block = arena->head;
+    void* res;
+
+    if (ptr == NULL)
+        return b_arena_alloc(arena, newsize);
+
+    if (newsize <= oldsize)
+        return ptr;
+
+    oldsize = b_arena_align(oldsize == 0 ? 1 : oldsize);
+
+    // The most recent allocation can simply be bumped further.
+    if (block != NULL &&
+        (unsigned char*)ptr + oldsize == &block->data[block->used]) {
+        size_t extra = b_arena_align(newsize) - oldsize;
+
+        if (block->cap - block->used >= extra) {
+            block->used += extra;
+            return ptr;
+        }
+    }
+
+    if ((res = b_arena_alloc(arena, newsize)) == NULL)
+        return NULL;
+
+    memcpy(res, ptr, oldsize < newsize ? oldsize : newsize);
+
+    return res;
+}
@@ -0,0 +1,75 @@
+/* beanutils: Some data structure implementations and utility functions, I
+ * guess.
+ *
+ * Copyright (c) Eason Qin, 2024.
+ *
+ * NOTE: This source code form is licensed under the MIT license and comes
+ * with ABSOLUTELY NO WARRANTY. For more information, please view the
+ * `LICENSE` file at the root of the project.
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#include "alloc.h"
+#include "common.h"
+
+#define _BEAN_ARENA_DEFAULT_BLOCK_SIZE (64 * 1024)
+
+typedef struct BeanArenaBlock BeanArenaBlock;
+
+/**
+ * A bump allocator that hands out memory from large blocks. Individual
+ * allocations are never freed; everything is released at once with
+ * `b_arena_reset` or `b_arena_deinit`.
+ *
+ * Blocks come from `allocator`, the global allocator at initialization
+ * unless changed with `b_arena_set_allocator`.
+ */
+typedef struct {
+    BeanArenaBlock* head;
+    size_t blocksize;
+    const BeanAllocator* allocator;
+} BeanArena;
+
+/**
+ * Initializes a new `BeanArena`.
+ */
+b_errno_t b_arena_init(BeanArena* arena);
+
+/**
+ * Initializes a new `BeanArena` that allocates blocks of `blocksize` bytes.
+ */
+b_errno_t b_arena_init_with_size(BeanArena* arena, size_t blocksize);
+
+/**
+ * Frees every block owned by a `BeanArena`.
+ */
+b_errno_t b_arena_deinit(BeanArena* arena);
+
+/**
+ * Makes a `BeanArena` that owns no blocks allocate them from `allocator`, or
+ * from the global allocator if it is `NULL`.
+ */
+b_errno_t b_arena_set_allocator(BeanArena* arena,
+                                const BeanAllocator* allocator);
+
+/**
+ * Releases every allocation made from a `BeanArena`, keeping one block around
+ * for reuse.
+ */
+b_errno_t b_arena_reset(BeanArena* arena);
+
+/**
+ * Allocates `size` bytes from a `BeanArena`. Returns `NULL` on failure.
+ */
+void* b_arena_alloc(BeanArena* arena, size_t size);
+
+/**
+ * Resizes an allocation made from a `BeanArena`. The most recent allocation
+ * is grown in place when there is room; otherwise the contents are copied to
+ * a new allocation.
+ */
+void* b_arena_realloc(BeanArena* arena, void* ptr, size_t oldsize,
+                      size_t newsize);
@@ -13,12 +13,57 @@
 
 #include "array.h"
 #include "common.h"
+#include "trace.h"
+
+static void b_array_free_elem(BeanArray* array, void* elem) {
+    if (array->freefn != NULL)
+        array->freefn(elem);
+    else if (array->arena != NULL)
+        return;
+    else if (array->pool != NULL)
+        b_pool_free(array->pool, elem);
+    else
+        b_free(array->elem_allocator, elem, ALLOCTAG_ARRAY_ELEM);
+}
 
-b_errno_t b_array_init(BeanArray* array) {
-    return b_array_init_with_size(array, _BEAN_ARRAY_GROWTH_FACTOR);
+// Releases the elements in [`start`, `finish`), unless there is nothing to
+// release them with.
+static void b_array_free_range(BeanArray* array, size_t start, size_t finish) {
+    if (array->freefn == b_array_free_nothing ||
+        (array->freefn == NULL && array->arena != NULL))
+        return;
+
+    for (size_t i = start; i < finish; i++)
+        b_array_free_elem(array, array->data[i]);
 }
 
-b_errno_t b_array_init_with_size(BeanArray* array, size_t cap) {
+/**
+ * Grows the buffer of a `Bean_Array` so that it can hold `len` elements.
+ */
+static b_errno_t b_array_grow_to(BeanArray* array, size_t len) {
+    if (len <= array->cap)
+        return STATUS_SUCCESS;
+
+    return b_array_reserve(
+        array, b_growth_next(&array->policy, array->cap, len, sizeof(void*)));
+}
+
+/**
+ * Hands memory back once a `Bean_Array` has emptied enough, as its shrink
+ * policy allows. Failing to do so leaves the array intact, so it is not an
+ * error.
+ */
+static void b_array_shrink_after_removal(BeanArray* array) {
+    size_t newcap = b_growth_shrink(&array->policy, array->len, array->cap,
+                                    _BEAN_ARRAY_INITIAL_CAPACITY);
+
+    if (newcap < array->cap)
+        b_array_reserve(array, newcap);
+}
+
+static b_errno_t b_array_init_from(BeanArray* array, size_t cap,
+                                   BeanArena* arena,
+                                   const BeanAllocator* allocator) {
     if (array->cap != 0)
         return STATUS_INVALID_OPERATION;
 
@@ -26,9 +71,17 @@ b_errno_t b_array_init_with_size(BeanArray* array, size_t cap) {
         .len = 0,
         .cap = cap,
         .data = NULL,
+        .arena = arena,
+        .allocator = allocator,
+        .elem_allocator = b_allocator_libc(),
     };
 
-    array->data = calloc(cap, sizeof(void*));
+    if (arena != NULL)
+        array->data = b_arena_alloc(arena, sizeof(void*) * cap);
+    else
+        array->data =
+            b_calloc(array->allocator, cap, sizeof(void*), ALLOCTAG_ARRAY);
+
     if (array->data == NULL) {
         array->cap = 0;
         return STATUS_FAILED_ALLOC;
@@ -37,59 +90,170 @@ b_errno_t b_array_init_with_size(BeanArray* array, size_t cap) {
     return STATUS_SUCCESS;
 }
 
+/**
+ * Initializes `res` to hold copies of the elements of `array`: same arena,
+ * allocator, pool and growth policy.
+ */
+static b_errno_t b_array_init_like(BeanArray* res, const BeanArray* array) {
+    b_errno_t stat = b_array_init_from(res, _BEAN_ARRAY_INITIAL_CAPACITY,
+                                       array->arena, array->allocator);
+
+    if (stat != STATUS_SUCCESS)
+        return stat;
+
+    res->pool = array->pool;
+    res->policy = array->policy;
+    res->elem_allocator = array->elem_allocator;
+
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_array_init(BeanArray* array) {
+    return b_array_init_with_size(array, _BEAN_ARRAY_INITIAL_CAPACITY);
+}
+
+b_errno_t b_array_init_with_size(BeanArray* array, size_t cap) {
+    return b_array_init_with_size_in(array, cap, NULL);
+}
+
+b_errno_t b_array_init_in(BeanArray* array, BeanArena* arena) {
+    return b_array_init_with_size_in(array, _BEAN_ARRAY_INITIAL_CAPACITY,
+                                     arena);
+}
+
+b_errno_t b_array_init_with_size_in(BeanArray* array, size_t cap,
+                                    BeanArena* arena) {
+    return b_array_init_from(array, cap, arena, b_allocator_get());
+}
+
+b_errno_t b_array_bind_pool(BeanArray* array, BeanPool* pool) {
+    if (array->len != 0 || array->arena != NULL)
+        return STATUS_INVALID_OPERATION;
+
+    array->pool = pool;
+
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_array_set_allocator(BeanArray* array,
+                                const BeanAllocator* allocator) {
+    void** newdata;
+
+    if (array->len != 0 || array->arena != NULL)
+        return STATUS_INVALID_OPERATION;
+
+    if (allocator == NULL)
+        allocator = b_allocator_get();
+    if (allocator == array->allocator)
+        return STATUS_SUCCESS;
+
+    newdata = b_alloc(allocator, sizeof(void*) * array->cap, ALLOCTAG_ARRAY);
+    if (newdata == NULL)
+        return STATUS_FAILED_ALLOC;
+
+    b_free(array->allocator, array->data, ALLOCTAG_ARRAY);
+    array->data = newdata;
+    array->allocator = allocator;
+
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_array_set_elem_allocator(BeanArray* array,
+                                     const BeanAllocator* allocator) {
+    if (array->len != 0 || array->arena != NULL)
+        return STATUS_INVALID_OPERATION;
+
+    array->elem_allocator = allocator != NULL ? allocator : b_allocator_libc();
+
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_array_set_policy(BeanArray* array, BeanGrowthPolicy policy) {
+    array->policy = policy;
+
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_array_set_free_fn(BeanArray* array, b_freefn_t freefn) {
+    array->freefn = freefn;
+
+    return STATUS_SUCCESS;
+}
+
+void b_array_free_nothing(void* elem) {
+    (void)elem;
+}
+
+void* b_array_alloc_elem(BeanArray* array, size_t elemsize) {
+    if (array->arena != NULL)
+        return b_arena_alloc(array->arena, elemsize);
+    else if (array->pool != NULL)
+        return elemsize <= array->pool->elemsize ? b_pool_alloc(array->pool)
+                                                 : NULL;
+
+    return b_alloc(array->elem_allocator, elemsize, ALLOCTAG_ARRAY_ELEM);
+}
+
 b_errno_t b_array_deinit(BeanArray* array) {
     if (array->cap == 0)
         return STATUS_INVALID_OPERATION;
 
-    for (size_t i = 0; i < array->len; i++) {
-        free(array->data[i]);
-    }
+    b_array_free_range(array, 0, array->len);
+
+    // Arena-backed arrays are reclaimed all at once by the arena.
+    if (array->arena == NULL)
+        b_free(array->allocator, array->data, ALLOCTAG_ARRAY);
 
-    free(array->data);
     array->cap = 0;
 
     return STATUS_SUCCESS;
 }
 
 b_errno_t b_array_reserve(BeanArray* array, size_t size) {
+    B_TRACE_FUNC();
+    void** newdata;
+
     if (size == 0 && array->cap != 0)
         return STATUS_INVALID_OPERATION;
 
-    array->data = (void**)realloc(array->data, sizeof(void*) * size);
+    if (array->arena != NULL)
+        newdata = b_arena_realloc(array->arena, array->data,
+                                  sizeof(void*) * array->cap,
+                                  sizeof(void*) * size);
+    else
+        newdata = b_realloc(array->allocator, array->data,
+                            sizeof(void*) * size, ALLOCTAG_ARRAY);
 
-    if (array->data == NULL) {
-        array->cap = 0;
+    if (newdata == NULL)
         return STATUS_FAILED_ALLOC;
-    } else {
-        array->cap = size;
-        return STATUS_SUCCESS;
-    }
+
+    array->data = newdata;
+    array->cap = size;
+
+    return STATUS_SUCCESS;
 }
 
 b_errno_t b_array_expand(BeanArray* array) {
-    size_t newcap = array->cap * _BEAN_ARRAY_GROWTH_FACTOR;
+    size_t newcap = b_growth_next(&array->policy, array->cap, array->cap + 1,
+                                  sizeof(void*));
     return b_array_reserve(array, newcap);
 }
 
 b_errno_t b_array_shrink(BeanArray* array) {
-    size_t newcap = array->cap / _BEAN_ARRAY_GROWTH_FACTOR;
+    size_t newcap = array->len > 0 ? array->len : 1;
 
-    if (newcap == 0)
-        return STATUS_INVALID_OPERATION;
+    if (newcap == array->cap)
+        return STATUS_OPERATION_UNNECESSARY;
 
     return b_array_reserve(array, newcap);
 }
 
 b_errno_t b_array_pop(BeanArray* array) {
-    if (array->len - 1 < array->cap / _BEAN_ARRAY_GROWTH_FACTOR) {
-        b_errno_t stat;
-        if ((stat = b_array_shrink(array)) != STATUS_SUCCESS)
-            return stat;
-    }
+    if (array->len == 0)
+        return STATUS_INVALID_OPERATION;
 
-    void* elem = array->data[--array->len];
-    free(elem);
-    elem = NULL;
+    b_array_free_elem(array, array->data[--array->len]);
+    b_array_shrink_after_removal(array);
 
     return STATUS_SUCCESS;
 }
@@ -106,32 +270,34 @@ b_errno_t b_array_push(BeanArray* array, void* newelem) {
     return STATUS_SUCCESS;
 }
 
-b_errno_t b_array_append(BeanArray* first, BeanArray* second) {
+b_errno_t b_array_push_many(BeanArray* array, void* const* elems,
+                            size_t count) {
     b_errno_t stat;
-    size_t newlen = first->len + second->len;
-    size_t currcap;
 
-    if (first->cap >= second->cap)
-        currcap = first->cap;
-    else
-        currcap = second->cap;
+    if ((stat = b_array_grow_to(array, array->len + count)) != STATUS_SUCCESS)
+        return stat;
 
-    while (newlen < (currcap *= _BEAN_ARRAY_GROWTH_FACTOR))
-        ;
+    memcpy(&array->data[array->len], elems, sizeof(void*) * count);
+    array->len += count;
 
-    if ((stat = b_array_reserve(first, currcap)) != STATUS_SUCCESS)
-        return stat;
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_array_append(BeanArray* first, BeanArray* second) {
+    b_errno_t stat;
 
-    memcpy(&first->data[first->len], second->data, sizeof(void*) * second->len);
+    if ((stat = b_array_push_many(first, second->data, second->len)) !=
+        STATUS_SUCCESS)
+        return stat;
 
-    first->len += second->len;
-    free(second->data);
+    if (second->arena == NULL)
+        b_free(second->allocator, second->data, ALLOCTAG_ARRAY);
     second->cap = 0;
 
     return STATUS_SUCCESS;
 }
 
-bool b_array_is_equal(BeanArray* array, BeanArray* rhs, size_t size) {
+bool b_array_equal(BeanArray* array, BeanArray* rhs, size_t size) {
     if (array->len != rhs->len)
         return false;
 
@@ -143,29 +309,57 @@ bool b_array_is_equal(BeanArray* array, BeanArray* rhs, size_t size) {
 }
 
 b_errno_t b_array_insert(BeanArray* array, void* elem, size_t index) {
-    if (array->len + 1 > array->cap) {
-        b_errno_t stat;
-        if ((stat = b_array_expand(array)) != STATUS_SUCCESS)
-            return stat;
-    }
+    return b_array_insert_range(array, &elem, 1, index);
+}
+
+b_errno_t b_array_insert_range(BeanArray* array, void* const* elems,
+                               size_t count, size_t index) {
+    b_errno_t stat;
+
+    if (index > array->len)
+        return STATUS_INVALID_OPERATION;
+
+    if ((stat = b_array_grow_to(array, array->len + count)) != STATUS_SUCCESS)
+        return stat;
 
-    memmove(&array->data[index], &array->data[index + 1],
-            sizeof(void*) * array->len - index);
-    array->data[index] = elem;
+    memmove(&array->data[index + count], &array->data[index],
+            sizeof(void*) * (array->len - index));
+    memcpy(&array->data[index], elems, sizeof(void*) * count);
+    array->len += count;
 
     return STATUS_SUCCESS;
 }
 
 b_errno_t b_array_remove(BeanArray* array, size_t index) {
-    if (array->len - 1 < array->cap / _BEAN_ARRAY_GROWTH_FACTOR) {
-        b_errno_t stat;
-        if ((stat = b_array_shrink(array)) != STATUS_SUCCESS)
-            return stat;
-    }
+    b_errno_t stat;
 
-    free(array->data[index]);
-    memmove(&array->data[index + 1], &array->data[index],
-            sizeof(void*) * array->len - index);
+    if ((stat = b_array_remove_range(array, index, index + 1)) !=
+        STATUS_SUCCESS)
+        return stat;
+
+    b_array_shrink_after_removal(array);
+
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_array_remove_range(BeanArray* array, size_t start, size_t finish) {
+    if (start > finish || finish > array->len)
+        return STATUS_INVALID_OPERATION;
+
+    b_array_free_range(array, start, finish);
+    memmove(&array->data[start], &array->data[finish],
+            sizeof(void*) * (array->len - finish));
+    array->len -= finish - start;
+
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_array_truncate(BeanArray* array, size_t len) {
+    if (len > array->len)
+        return STATUS_INVALID_OPERATION;
+
+    b_array_free_range(array, len, array->len);
+    array->len = len;
 
     return STATUS_SUCCESS;
 }
@@ -182,7 +376,10 @@ BeanArrayView b_array_get_view(BeanArray* array, size_t start, size_t finish) {
 b_errno_t b_array_slice(BeanArray* array, BeanArray* newarray, size_t start,
                         size_t finish, size_t elemsize) {
     BeanArray res = {0};
-    b_array_init(&res);
+    b_errno_t stat;
+
+    if ((stat = b_array_init_like(&res, array)) != STATUS_SUCCESS)
+        return stat;
 
     if (start < 0)
         start = 0;
@@ -191,11 +388,18 @@ b_errno_t b_array_slice(BeanArray* array, BeanArray* newarray, size_t start,
 
     for (size_t i = start; i != finish; i++) {
         b_errno_t pushstat;
-        void* elem = malloc(elemsize);
+        void* elem = b_array_alloc_elem(array, elemsize);
 
+        if (elem == NULL) {
+            b_array_deinit(&res);
+            return STATUS_FAILED_ALLOC;
+        }
         memcpy(elem, array->data[i], elemsize);
-        if ((pushstat = b_array_push(&res, elem)) != STATUS_SUCCESS)
+        if ((pushstat = b_array_push(&res, elem)) != STATUS_SUCCESS) {
+            b_array_free_elem(&res, elem);
+            b_array_deinit(&res);
             return pushstat;
+        }
     }
 
     *newarray = res;
@@ -206,15 +410,25 @@ b_errno_t b_array_slice(BeanArray* array, BeanArray* newarray, size_t start,
 b_errno_t b_array_clone(BeanArray* array, BeanArray* newarray,
                         size_t elemsize) {
     BeanArray res = {0};
-    b_array_init(&res);
+    b_errno_t stat;
+
+    if ((stat = b_array_init_like(&res, array)) != STATUS_SUCCESS)
+        return stat;
 
     for (size_t i = 0; i < array->len; i++) {
         b_errno_t pushstat;
-        void* elem = malloc(elemsize);
+        void* elem = b_array_alloc_elem(array, elemsize);
 
+        if (elem == NULL) {
+            b_array_deinit(&res);
+            return STATUS_FAILED_ALLOC;
+        }
         memcpy(elem, array->data[i], elemsize);
-        if ((pushstat = b_array_push(&res, elem)) != STATUS_SUCCESS)
+        if ((pushstat = b_array_push(&res, elem)) != STATUS_SUCCESS) {
+            b_array_free_elem(&res, elem);
+            b_array_deinit(&res);
             return pushstat;
+        }
     }
 
     *newarray = res;
@@ -13,14 +13,51 @@
 #include <stdbool.h>
 #include <stddef.h>
 
+#include "alloc.h"
+#include "arena.h"
 #include "common.h"
+#include "growth.h"
+#include "pool.h"
 
-#define _BEAN_ARRAY_GROWTH_FACTOR 5
+#define _BEAN_ARRAY_INITIAL_CAPACITY 8
 
+/**
+ * Releases one element of a `BeanArray`.
+ */
+typedef void (*b_freefn_t)(void* elem);
+
+/**
+ * A dynamic array of pointers to heap-allocated elements.
+ *
+ * If `arena` is set, both the pointer buffer and the elements created by
+ * `b_array_clone`/`b_array_slice` live in that `BeanArena`, and elements are
+ * never freed individually.
+ *
+ * If `pool` is set (see `b_array_bind_pool`), elements come from and are
+ * returned to that `BeanPool` instead of the heap.
+ *
+ * Otherwise the pointer buffer comes from `allocator`, which is the global
+ * allocator at initialization unless changed with `b_array_set_allocator`,
+ * and the elements from `elem_allocator`. That is the C library allocator
+ * unless changed with `b_array_set_elem_allocator`, so elements from
+ * `malloc` can be pushed and are released with `free`.
+ *
+ * If `freefn` is set (see `b_array_set_free_fn`), it releases elements
+ * instead, whatever the array is backed by.
+ *
+ * `policy` decides how the pointer buffer grows and shrinks (see
+ * `b_array_set_policy`).
+ */
 typedef struct {
     void** data;
     size_t len;
     size_t cap;
+    BeanArena* arena;
+    BeanPool* pool;
+    b_freefn_t freefn;
+    BeanGrowthPolicy policy;
+    const BeanAllocator* allocator;
+    const BeanAllocator* elem_allocator;
 } BeanArray;
 
 typedef struct {
@@ -38,6 +75,63 @@ b_errno_t b_array_init(BeanArray* array);
  */
 b_errno_t b_array_init_with_size(BeanArray* array, size_t cap);
 
+/**
+ * Initializes a new `Bean_Array` whose storage is allocated from `arena`.
+ */
+b_errno_t b_array_init_in(BeanArray* array, BeanArena* arena);
+
+/**
+ * Initializes a new `Bean_Array` in `arena` with the specified capacity.
+ */
+b_errno_t b_array_init_with_size_in(BeanArray* array, size_t cap,
+                                    BeanArena* arena);
+
+/**
+ * Binds an empty `Bean_Array` to a `BeanPool`, so that its elements are
+ * allocated from and released to the pool.
+ */
+b_errno_t b_array_bind_pool(BeanArray* array, BeanPool* pool);
+
+/**
+ * Moves the pointer buffer of an empty, heap-backed `Bean_Array` to
+ * `allocator`. `NULL` selects the global allocator.
+ */
+b_errno_t b_array_set_allocator(BeanArray* array,
+                                const BeanAllocator* allocator);
+
+/**
+ * Sets the allocator the elements of an empty, heap-backed `Bean_Array` are
+ * allocated from and released to. Every element pushed afterwards has to
+ * come from it, e.g. through `b_array_alloc_elem`. `NULL` selects the C
+ * library allocator.
+ */
+b_errno_t b_array_set_elem_allocator(BeanArray* array,
+                                     const BeanAllocator* allocator);
+
+/**
+ * Sets the function that releases the elements of a `Bean_Array`, or `NULL`
+ * to go back to releasing them through its pool, arena or allocator. Arrays
+ * that do not own their elements can use `b_array_free_nothing`, which makes
+ * removing any number of elements O(1).
+ */
+b_errno_t b_array_set_free_fn(BeanArray* array, b_freefn_t freefn);
+
+/**
+ * Sets the growth and shrink policies of a `Bean_Array`.
+ */
+b_errno_t b_array_set_policy(BeanArray* array, BeanGrowthPolicy policy);
+
+/**
+ * An element destructor that does nothing, for arrays of borrowed pointers.
+ */
+void b_array_free_nothing(void* elem);
+
+/**
+ * Allocates storage for one element the way a `Bean_Array` releases it: from
+ * its pool or arena if it has one, and from its element allocator otherwise.
+ */
+void* b_array_alloc_elem(BeanArray* array, size_t elemsize);
+
 /**
  * Reserves a given capacity on a `Bean_Array`.
  */
@@ -49,17 +143,19 @@ b_errno_t b_array_reserve(BeanArray* array, size_t size);
 b_errno_t b_array_deinit(BeanArray* array);
 
 /**
- * Expands a `Bean_Array`.
+ * Expands a `Bean_Array` according to its growth policy.
  */
 b_errno_t b_array_expand(BeanArray* array);
 
 /**
- * Shrinks a `Bean_Array`.
+ * Shrinks the buffer of a `Bean_Array` to fit its elements.
  */
 b_errno_t b_array_shrink(BeanArray* array);
 
 /**
- * Pops an element off a `Bean_Array`.
+ * Pops an element off a `Bean_Array`, releasing it.
+ *
+ * @return `STATUS_INVALID_OPERATION` if the array is empty.
  */
 b_errno_t b_array_pop(BeanArray* array);
 
@@ -68,6 +164,12 @@ b_errno_t b_array_pop(BeanArray* array);
  */
 b_errno_t b_array_push(BeanArray* array, void* newelem);
 
+/**
+ * Adds `count` elements onto a `Bean_Array`, growing it at most once.
+ */
+b_errno_t b_array_push_many(BeanArray* array, void* const* elems,
+                            size_t count);
+
 /**
  * Appends two `Bean_Array`s together, emptying the second array.
  */
@@ -84,10 +186,29 @@ bool b_array_equal(BeanArray* array, BeanArray* rhs, size_t size);
 b_errno_t b_array_insert(BeanArray* array, void* elem, size_t index);
 
 /**
- * Removes an element off of a `Bean_Array`.
+ * Inserts `count` elements into a `Bean_Array` before `index`, moving the
+ * tail only once.
+ */
+b_errno_t b_array_insert_range(BeanArray* array, void* const* elems,
+                               size_t count, size_t index);
+
+/**
+ * Removes an element off of a `Bean_Array`, releasing it.
  */
 b_errno_t b_array_remove(BeanArray* array, size_t index);
 
+/**
+ * Removes and releases the elements in [`start`, `finish`) of a `Bean_Array`,
+ * moving the tail only once. The capacity is kept.
+ */
+b_errno_t b_array_remove_range(BeanArray* array, size_t start, size_t finish);
+
+/**
+ * Releases every element past the first `len` of a `Bean_Array`. The
+ * capacity is kept.
+ */
+b_errno_t b_array_truncate(BeanArray* array, size_t len);
+
 /**
  * Creates a `Bean_ArrayView` from a `Bean_Array`.
  *
@@ -10,8 +10,22 @@
 
 #pragma once
 
+#include "alloc.h"
+#include "arena.h"
 #include "array.h"
 #include "common.h"
+#include "growth.h"
+#include "hash.h"
+#include "hashmap.h"
+#include "interner.h"
 #include "io.h"
 #include "logger.h"
+#include "parallel.h"
+#include "pool.h"
+#include "queue.h"
+#include "simd.h"
+#include "sort.h"
 #include "string.h"
+#include "threadpool.h"
+#include "trace.h"
+#include "vec.h"
@@ -17,4 +17,11 @@ typedef enum {
     STATUS_INVALID_OPERATION = -3,
     STATUS_DATA_NOT_INITIALIZED = -4,
     STATUS_OPERATION_UNNECESSARY = -5,
+    STATUS_END_OF_FILE = -6,
 } b_errno_t;
+
+/**
+ * Compares two elements, returning a negative number, zero or a positive
+ * number if `lhs` sorts before, together with or after `rhs`.
+ */
+typedef int (*b_cmpfn_t)(const void* lhs, const void* rhs);
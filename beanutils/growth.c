@@ -0,0 +1,68 @@
+/* beanutils: Some data structure implementations and utility functions, I
+ * guess.
+ *
+ * Copyright (c) Eason Qin, 2024.
+ *
+ * NOTE: This source code form is licensed under the MIT license and comes
+ * with ABSOLUTELY NO WARRANTY. For more information, please view the
+ * `LICENSE` file at the root of the project.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "growth.h"
+
+size_t b_growth_next(const BeanGrowthPolicy* policy, size_t cap, size_t needed,
+                     size_t elemsize) {
+    size_t newcap = cap > 0 ? cap : 1;
+    size_t bytes;
+
+    if (needed <= cap)
+        return cap;
+
+    switch (policy->growth) {
+        case GROWTH_EXACT:
+            return needed;
+        case GROWTH_GEOMETRIC_1_5X:
+            newcap += newcap / 2 > 0 ? newcap / 2 : 1;
+            break;
+        case GROWTH_PAGE_ROUNDED:
+            if (newcap * elemsize >= _BEAN_GROWTH_PAGE_THRESHOLD) {
+                newcap += newcap / 2;
+                break;
+            }
+            // fall through
+        case GROWTH_GEOMETRIC_2X:
+            newcap *= 2;
+            break;
+    }
+
+    if (newcap < needed || newcap > SIZE_MAX / elemsize)
+        newcap = needed;
+
+    if (policy->growth != GROWTH_PAGE_ROUNDED ||
+        newcap * elemsize < _BEAN_GROWTH_PAGE_THRESHOLD)
+        return newcap;
+
+    // Whole pages let the allocator move the buffer with `mremap` and leave
+    // no partially used page at the end.
+    bytes = newcap * elemsize;
+    bytes = (bytes + _BEAN_GROWTH_PAGE_SIZE - 1) &
+            ~(size_t)(_BEAN_GROWTH_PAGE_SIZE - 1);
+
+    return bytes / elemsize;
+}
+
+size_t b_growth_shrink(const BeanGrowthPolicy* policy, size_t len, size_t cap,
+                       size_t mincap) {
+    size_t newcap = cap / 2;
+
+    if (policy->shrink == SHRINK_EXPLICIT || len >= cap / 4)
+        return cap;
+
+    if (newcap < mincap)
+        newcap = mincap;
+
+    return newcap < cap ? newcap : cap;
+}
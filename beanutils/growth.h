@@ -0,0 +1,76 @@
+/* beanutils: Some data structure implementations and utility functions, I
+ * guess.
+ *
+ * Copyright (c) Eason Qin, 2024.
+ *
+ * NOTE: This source code form is licensed under the MIT license and comes
+ * with ABSOLUTELY NO WARRANTY. For more information, please view the
+ * `LICENSE` file at the root of the project.
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#define _BEAN_GROWTH_PAGE_SIZE      4096
+#define _BEAN_GROWTH_PAGE_THRESHOLD (64 * 1024)
+
+/**
+ * How a container picks its next capacity when it runs out of room.
+ */
+typedef enum {
+    /** Doubles the capacity. */
+    GROWTH_GEOMETRIC_2X = 0,
+    /** Grows the capacity by half, wasting less memory on large buffers. */
+    GROWTH_GEOMETRIC_1_5X,
+    /**
+     * Doubles small buffers. Buffers past `_BEAN_GROWTH_PAGE_THRESHOLD` bytes
+     * grow by half and are rounded up to whole pages.
+     */
+    GROWTH_PAGE_ROUNDED,
+    /** Grows to exactly the size needed. */
+    GROWTH_EXACT,
+} b_growth_t;
+
+/**
+ * When a container hands memory back as it empties.
+ */
+typedef enum {
+    /**
+     * Halves the capacity once the length drops below a quarter of it, so a
+     * push/pop loop around a boundary never reallocates every iteration.
+     */
+    SHRINK_HYSTERESIS = 0,
+    /** Only shrinks when asked to. */
+    SHRINK_EXPLICIT,
+} b_shrink_t;
+
+/**
+ * The growth and shrink policies of a container. A zeroed policy doubles and
+ * shrinks with hysteresis.
+ */
+typedef struct {
+    b_growth_t growth;
+    b_shrink_t shrink;
+} BeanGrowthPolicy;
+
+/**
+ * Computes the capacity a container should grow to in order to hold
+ * `needed` elements.
+ *
+ *  @param cap       The current capacity, in elements.
+ *  @param elemsize  The size of one element, used to round to pages.
+ *
+ * @return A capacity of at least `needed`.
+ */
+size_t b_growth_next(const BeanGrowthPolicy* policy, size_t cap, size_t needed,
+                     size_t elemsize);
+
+/**
+ * Computes the capacity a container holding `len` elements should shrink
+ * to on its own, never going below `mincap`.
+ *
+ * @return `cap` if it should not shrink.
+ */
+size_t b_growth_shrink(const BeanGrowthPolicy* policy, size_t len, size_t cap,
+                       size_t mincap);
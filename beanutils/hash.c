@@ -0,0 +1,338 @@
+/* beanutils: Some data structure implementations and utility functions, I
+ * guess.
+ *
+ * Copyright (c) Eason Qin, 2024.
+ *
+ * NOTE: This source code form is licensed under the MIT license and comes
+ * with ABSOLUTELY NO WARRANTY. For more information, please view the
+ * `LICENSE` file at the root of the project.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+#include "hash.h"
+#include "io.h"
+#include "simd.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define _BEAN_HASH_X86 1
+#include <immintrin.h>
+#endif
+
+#define _BEAN_HASH_PRIME32 0x9E3779B1u
+#define _BEAN_HASH_PRIME64 0x9E3779B185EBCA87u
+
+static const uint64_t b_hash_secret[4] = {
+    0xa0761d6478bd642fu,
+    0xe7037ed1a0b428dbu,
+    0x8ebc6af09c88c6e3u,
+    0x589965cc75374cc3u,
+};
+
+static const uint64_t b_hash_stripe_keys[8] = {
+    0xbe4ba423396cfeb8u, 0x1cad21f72c81017cu, 0xdb979083e96dd4deu,
+    0x1f67b3b7a4a44072u, 0x78e5c0cc4ee679cbu, 0x2172ffcc7dd05a82u,
+    0x8e2443f7744608b8u, 0x4c263a81e69035e0u,
+};
+
+static const uint64_t b_hash_scramble_keys[8] = {
+    0xcb00c391bb52283cu, 0xa32e531b8b65d088u, 0x4ef90da297486471u,
+    0xd8acdea946ef1938u, 0x3f349ce33f76faa8u, 0x1d4f0bc7c7bbdcf9u,
+    0x3159b4cd4be0518au, 0x647378d9c97e9fc8u,
+};
+
+static const uint64_t b_hash_initial_acc[8] = {
+    0x00000000C2B2AE3Du, 0x9E3779B185EBCA87u, 0xC2B2AE3D27D4EB4Fu,
+    0x165667B19E3779F9u, 0x85EBCA77C2B2AE63u, 0x0000000085EBCA77u,
+    0x27D4EB2F165667C5u, 0x000000009E3779B1u,
+};
+
+static inline uint64_t b_hash_read64(const unsigned char* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint64_t b_hash_read32(const unsigned char* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// Replaces `a` and `b` with the low and high halves of their 128-bit product.
+static inline void b_hash_mum(uint64_t* a, uint64_t* b) {
+#ifdef __SIZEOF_INT128__
+    __uint128_t r = (__uint128_t)*a * *b;
+    *a = (uint64_t)r;
+    *b = (uint64_t)(r >> 64);
+#else
+    uint64_t ha = *a >> 32, hb = *b >> 32;
+    uint64_t la = (uint32_t)*a, lb = (uint32_t)*b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32);
+    uint64_t carry = t < rl;
+    uint64_t lo = t + (rm1 << 32);
+
+    carry += lo < t;
+    *a = lo;
+    *b = rh + (rm0 >> 32) + (rm1 >> 32) + carry;
+#endif
+}
+
+static inline uint64_t b_hash_mix(uint64_t a, uint64_t b) {
+    b_hash_mum(&a, &b);
+    return a ^ b;
+}
+
+// wyhash-style path for inputs of at most 64 bytes, which is also used on
+// the tail of longer inputs.
+static uint64_t b_hash_short(const unsigned char* p, size_t len,
+                             uint64_t seed) {
+    uint64_t a, b;
+
+    seed ^= b_hash_mix(seed ^ b_hash_secret[0], b_hash_secret[1]);
+
+    if (len <= 16) {
+        if (len >= 4) {
+            size_t off = (len >> 3) << 2;
+            a = (b_hash_read32(p) << 32) | b_hash_read32(p + off);
+            b = (b_hash_read32(p + len - 4) << 32) |
+                b_hash_read32(p + len - 4 - off);
+        } else if (len > 0) {
+            a = ((uint64_t)p[0] << 16) | ((uint64_t)p[len >> 1] << 8) |
+                p[len - 1];
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+
+        while (i > 16) {
+            seed = b_hash_mix(b_hash_read64(p) ^ b_hash_secret[1],
+                              b_hash_read64(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+
+        // These may overlap bytes that were already mixed in.
+        a = b_hash_read64(p + i - 16);
+        b = b_hash_read64(p + i - 8);
+    }
+
+    a ^= b_hash_secret[1];
+    b ^= seed;
+    b_hash_mum(&a, &b);
+
+    return b_hash_mix(a ^ b_hash_secret[0] ^ len, b ^ b_hash_secret[1]);
+}
+
+static void b_hash_accumulate_scalar(uint64_t acc[8], const unsigned char* p,
+                                     size_t nstripes) {
+    for (size_t s = 0; s < nstripes; s++, p += _BEAN_HASH_STRIPE_SIZE) {
+        for (size_t i = 0; i < 8; i++) {
+            uint64_t v = b_hash_read64(p + 8 * i);
+            uint64_t k = v ^ b_hash_stripe_keys[i];
+
+            acc[i ^ 1] += v;
+            acc[i] += (k & 0xFFFFFFFFu) * (k >> 32);
+        }
+    }
+}
+
+#ifdef _BEAN_HASH_X86
+__attribute__((target("avx2"))) static void
+b_hash_accumulate_avx2(uint64_t acc[8], const unsigned char* p,
+                       size_t nstripes) {
+    __m256i a0 = _mm256_loadu_si256((const __m256i*)acc);
+    __m256i a1 = _mm256_loadu_si256((const __m256i*)(acc + 4));
+    __m256i k0 = _mm256_loadu_si256((const __m256i*)b_hash_stripe_keys);
+    __m256i k1 = _mm256_loadu_si256((const __m256i*)(b_hash_stripe_keys + 4));
+
+    for (size_t s = 0; s < nstripes; s++, p += _BEAN_HASH_STRIPE_SIZE) {
+        __m256i v0 = _mm256_loadu_si256((const __m256i*)p);
+        __m256i v1 = _mm256_loadu_si256((const __m256i*)(p + 32));
+        __m256i x0 = _mm256_xor_si256(v0, k0);
+        __m256i x1 = _mm256_xor_si256(v1, k1);
+
+        // Same lanes as the scalar loop: each 64-bit lane gets the product
+        // of its own halves plus the raw input of its neighbour.
+        a0 = _mm256_add_epi64(
+            a0, _mm256_mul_epu32(x0, _mm256_srli_epi64(x0, 32)));
+        a1 = _mm256_add_epi64(
+            a1, _mm256_mul_epu32(x1, _mm256_srli_epi64(x1, 32)));
+        a0 = _mm256_add_epi64(
+            a0, _mm256_shuffle_epi32(v0, _MM_SHUFFLE(1, 0, 3, 2)));
+        a1 = _mm256_add_epi64(
+            a1, _mm256_shuffle_epi32(v1, _MM_SHUFFLE(1, 0, 3, 2)));
+    }
+
+    _mm256_storeu_si256((__m256i*)acc, a0);
+    _mm256_storeu_si256((__m256i*)(acc + 4), a1);
+}
+#endif
+
+static void b_hash_scramble(uint64_t acc[8]) {
+    for (size_t i = 0; i < 8; i++) {
+        acc[i] ^= acc[i] >> 47;
+        acc[i] ^= b_hash_scramble_keys[i];
+        acc[i] *= _BEAN_HASH_PRIME32;
+    }
+}
+
+// Folds `nstripes` whole stripes into `acc`, scrambling it at the end of
+// every block so the high bits keep feeding back into the low ones.
+static void b_hash_consume(uint64_t acc[8], size_t* stripes,
+                           const unsigned char* p, size_t nstripes) {
+    while (nstripes > 0) {
+        size_t room = _BEAN_HASH_STRIPES_PER_BLOCK -
+                      *stripes % _BEAN_HASH_STRIPES_PER_BLOCK;
+        size_t batch = nstripes < room ? nstripes : room;
+
+#ifdef _BEAN_HASH_X86
+        if (b_simd_level() == SIMDLEVEL_AVX2)
+            b_hash_accumulate_avx2(acc, p, batch);
+        else
+#endif
+            b_hash_accumulate_scalar(acc, p, batch);
+
+        *stripes += batch;
+        p += batch * _BEAN_HASH_STRIPE_SIZE;
+        nstripes -= batch;
+
+        if (*stripes % _BEAN_HASH_STRIPES_PER_BLOCK == 0)
+            b_hash_scramble(acc);
+    }
+}
+
+static void b_hash_init_acc(uint64_t acc[8], uint64_t seed) {
+    for (size_t i = 0; i < 8; i++)
+        acc[i] = b_hash_initial_acc[i] + ((i & 1) ? 0 - seed : seed);
+}
+
+static uint64_t b_hash_finalize(const uint64_t acc[8], uint64_t len,
+                                const unsigned char* tail, size_t taillen) {
+    uint64_t hash = len * _BEAN_HASH_PRIME64;
+
+    for (size_t i = 0; i < 4; i++)
+        hash += b_hash_mix(acc[2 * i] ^ b_hash_secret[i],
+                           acc[2 * i + 1] ^ b_hash_secret[3 - i]);
+
+    return b_hash_short(tail, taillen, hash);
+}
+
+uint64_t b_hash_bytes(const void* data, size_t len, uint64_t seed) {
+    const unsigned char* p = data;
+    uint64_t acc[8];
+    size_t stripes = 0;
+    size_t nstripes;
+
+    if (len <= _BEAN_HASH_STRIPE_SIZE)
+        return b_hash_short(p, len, seed);
+
+    // The last 1 to 64 bytes always go through the tail, which is what lets
+    // `BeanHasher` hold them back until it knows the input is over.
+    nstripes = (len - 1) / _BEAN_HASH_STRIPE_SIZE;
+    b_hash_init_acc(acc, seed);
+    b_hash_consume(acc, &stripes, p, nstripes);
+
+    return b_hash_finalize(acc, len, p + nstripes * _BEAN_HASH_STRIPE_SIZE,
+                           len - nstripes * _BEAN_HASH_STRIPE_SIZE);
+}
+
+uint64_t b_hash_string(const BeanString* bs, uint64_t seed) {
+    return b_hash_bytes(b_string_data(bs), bs->len, seed);
+}
+
+uint64_t b_hash_strview(const BeanStringView* view, uint64_t seed) {
+    return b_hash_bytes(view->data, view->len, seed);
+}
+
+uint64_t b_hash_arrview(const BeanArrayView* view, size_t size,
+                        uint64_t seed) {
+    BeanHasher hasher;
+
+    b_hasher_init(&hasher, seed);
+    for (size_t i = 0; i < view->len; i++)
+        b_hasher_update(&hasher, view->elems[i], size);
+
+    return b_hasher_finish(&hasher);
+}
+
+uint64_t b_hash_vecview(const BeanVecView* view, uint64_t seed) {
+    return b_hash_bytes(view->data, view->len * view->elemsize, seed);
+}
+
+void b_hasher_init(BeanHasher* hasher, uint64_t seed) {
+    *hasher = (BeanHasher){
+        .seed = seed,
+        .len = 0,
+        .stripes = 0,
+        .buflen = 0,
+    };
+
+    b_hash_init_acc(hasher->acc, seed);
+}
+
+void b_hasher_update(BeanHasher* hasher, const void* data, size_t len) {
+    const unsigned char* p = data;
+    size_t nstripes;
+
+    hasher->len += len;
+
+    if (hasher->buflen + len <= _BEAN_HASH_STRIPE_SIZE) {
+        if (len > 0)
+            memcpy(&hasher->buf[hasher->buflen], p, len);
+        hasher->buflen += len;
+        return;
+    }
+
+    // There is more input after the buffered stripe, so it is not the tail.
+    if (hasher->buflen > 0) {
+        size_t fill = _BEAN_HASH_STRIPE_SIZE - hasher->buflen;
+
+        memcpy(&hasher->buf[hasher->buflen], p, fill);
+        b_hash_consume(hasher->acc, &hasher->stripes, hasher->buf, 1);
+        p += fill;
+        len -= fill;
+    }
+
+    nstripes = (len - 1) / _BEAN_HASH_STRIPE_SIZE;
+    b_hash_consume(hasher->acc, &hasher->stripes, p, nstripes);
+    p += nstripes * _BEAN_HASH_STRIPE_SIZE;
+    len -= nstripes * _BEAN_HASH_STRIPE_SIZE;
+
+    memcpy(hasher->buf, p, len);
+    hasher->buflen = len;
+}
+
+b_errno_t b_hasher_update_file(BeanHasher* hasher, FILE* file) {
+    char* buf = malloc(_BEAN_IO_BLOCK_SIZE);
+    size_t nread;
+
+    if (buf == NULL)
+        return STATUS_FAILED_ALLOC;
+
+    while ((nread = fread(buf, 1, _BEAN_IO_BLOCK_SIZE, file)) > 0)
+        b_hasher_update(hasher, buf, nread);
+
+    free(buf);
+
+    if (ferror(file))
+        return STATUS_GENERIC_FAILURE;
+
+    return STATUS_SUCCESS;
+}
+
+uint64_t b_hasher_finish(const BeanHasher* hasher) {
+    if (hasher->len <= _BEAN_HASH_STRIPE_SIZE)
+        return b_hash_short(hasher->buf, hasher->buflen, hasher->seed);
+
+    return b_hash_finalize(hasher->acc, hasher->len, hasher->buf,
+                           hasher->buflen);
+}
@@ -0,0 +1,88 @@
+/* beanutils: Some data structure implementations and utility functions, I
+ * guess.
+ *
+ * Copyright (c) Eason Qin, 2024.
+ *
+ * NOTE: This source code form is licensed under the MIT license and comes
+ * with ABSOLUTELY NO WARRANTY. For more information, please view the
+ * `LICENSE` file at the root of the project.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "array.h"
+#include "common.h"
+#include "string.h"
+#include "vec.h"
+
+#define _BEAN_HASH_STRIPE_SIZE 64
+#define _BEAN_HASH_STRIPES_PER_BLOCK 16
+
+/**
+ * Incrementally hashes data that arrives in pieces. Feeding the same bytes
+ * in any split gives the same result as `b_hash_bytes`.
+ */
+typedef struct {
+    uint64_t acc[8];
+    uint64_t seed;
+    uint64_t len;
+    size_t stripes;
+    size_t buflen;
+    unsigned char buf[_BEAN_HASH_STRIPE_SIZE];
+} BeanHasher;
+
+/**
+ * Hashes `len` bytes with a fast, seeded, non-cryptographic hash. Inputs up
+ * to 64 bytes take a short multiply-mix path; longer ones are accumulated
+ * 64 bytes at a time, with AVX2 when available. Both paths give the same
+ * result on every CPU.
+ */
+uint64_t b_hash_bytes(const void* data, size_t len, uint64_t seed);
+
+/**
+ * Hashes the contents of a `BeanString`.
+ */
+uint64_t b_hash_string(const BeanString* bs, uint64_t seed);
+
+/**
+ * Hashes the contents of a `BeanStringView`. This matches `b_hash_string` on
+ * the same characters.
+ */
+uint64_t b_hash_strview(const BeanStringView* view, uint64_t seed);
+
+/**
+ * Hashes the `size`-byte elements pointed to by a `BeanArrayView`, as if they
+ * were laid out back to back.
+ */
+uint64_t b_hash_arrview(const BeanArrayView* view, size_t size, uint64_t seed);
+
+/**
+ * Hashes the elements of a `BeanVecView`.
+ */
+uint64_t b_hash_vecview(const BeanVecView* view, uint64_t seed);
+
+/**
+ * Initializes a new `BeanHasher`.
+ */
+void b_hasher_init(BeanHasher* hasher, uint64_t seed);
+
+/**
+ * Feeds `len` more bytes to a `BeanHasher`.
+ */
+void b_hasher_update(BeanHasher* hasher, const void* data, size_t len);
+
+/**
+ * Feeds the rest of a file to a `BeanHasher`, reading it in blocks of
+ * `_BEAN_IO_BLOCK_SIZE` bytes.
+ */
+b_errno_t b_hasher_update_file(BeanHasher* hasher, FILE* file);
+
+/**
+ * Gets the hash of everything fed to a `BeanHasher` so far. The hasher is
+ * left untouched and can keep going.
+ */
+uint64_t b_hasher_finish(const BeanHasher* hasher);
@@ -0,0 +1,373 @@
+/* beanutils: Some data structure implementations and utility functions, I
+ * guess.
+ *
+ * Copyright (c) Eason Qin, 2024.
+ *
+ * NOTE: This source code form is licensed under the MIT license and comes
+ * with ABSOLUTELY NO WARRANTY. For more information, please view the
+ * `LICENSE` file at the root of the project.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "common.h"
+#include "hash.h"
+#include "hashmap.h"
+#include "string.h"
+#include "trace.h"
+
+#define _BEAN_HASHMAP_EMPTY ((uint8_t)0x80)
+#define _BEAN_HASHMAP_DELETED ((uint8_t)0xFE)
+#define _BEAN_HASHMAP_NPOS SIZE_MAX
+#define _BEAN_HASHMAP_ALIGNMENT _Alignof(max_align_t)
+#define _BEAN_HASHMAP_VAL_OFFSET                                               \
+    ((sizeof(BeanString) + _BEAN_HASHMAP_ALIGNMENT - 1) &                      \
+     ~(_BEAN_HASHMAP_ALIGNMENT - 1))
+
+// Bit `i` of the result is set if `group[i] == byte`.
+static uint32_t b_hashmap_match(const uint8_t* group, uint8_t byte) {
+#ifdef __SSE2__
+    __m128i ctrl = _mm_loadu_si128((const __m128i*)group);
+    __m128i match = _mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)byte));
+    return (uint32_t)_mm_movemask_epi8(match);
+#else
+    uint32_t mask = 0;
+
+    for (int i = 0; i < _BEAN_HASHMAP_GROUP_WIDTH; i++)
+        mask |= (uint32_t)(group[i] == byte) << i;
+
+    return mask;
+#endif
+}
+
+// Empty and deleted slots are the only ones with the top bit set.
+static uint32_t b_hashmap_match_free(const uint8_t* group) {
+#ifdef __SSE2__
+    __m128i ctrl = _mm_loadu_si128((const __m128i*)group);
+    return (uint32_t)_mm_movemask_epi8(ctrl);
+#else
+    uint32_t mask = 0;
+
+    for (int i = 0; i < _BEAN_HASHMAP_GROUP_WIDTH; i++)
+        mask |= (uint32_t)(group[i] >> 7) << i;
+
+    return mask;
+#endif
+}
+
+static inline BeanString* b_hashmap_key_at(const BeanHashMap* map, size_t i) {
+    return (BeanString*)(map->slots + i * map->slotsize);
+}
+
+static inline void* b_hashmap_val_at(const BeanHashMap* map, size_t i) {
+    return map->slots + i * map->slotsize + _BEAN_HASHMAP_VAL_OFFSET;
+}
+
+// The table is kept at most 7/8 full so every probe ends at an empty slot.
+static inline size_t b_hashmap_max_load(size_t cap) { return cap - cap / 8; }
+
+static size_t b_hashmap_find(const BeanHashMap* map, const BeanStringView* key,
+                             uint64_t hash) {
+    size_t ngroups = map->cap / _BEAN_HASHMAP_GROUP_WIDTH;
+    size_t group;
+
+    if (map->cap == 0)
+        return _BEAN_HASHMAP_NPOS;
+
+    // Triangular steps over a power-of-two number of groups visit every
+    // group exactly once.
+    group = (size_t)(hash >> 7) & (ngroups - 1);
+    for (size_t step = 1; step <= ngroups; step++) {
+        const uint8_t* ctrl = &map->ctrl[group * _BEAN_HASHMAP_GROUP_WIDTH];
+        uint32_t match = b_hashmap_match(ctrl, (uint8_t)(hash & 0x7F));
+
+        while (match != 0) {
+            size_t i = group * _BEAN_HASHMAP_GROUP_WIDTH +
+                       (size_t)__builtin_ctz(match);
+            BeanString* candidate = b_hashmap_key_at(map, i);
+
+            if (candidate->len == key->len &&
+                memcmp(b_string_data(candidate), key->data, key->len) == 0)
+                return i;
+            match &= match - 1;
+        }
+
+        if (b_hashmap_match(ctrl, _BEAN_HASHMAP_EMPTY) != 0)
+            return _BEAN_HASHMAP_NPOS;
+        group = (group + step) & (ngroups - 1);
+    }
+
+    return _BEAN_HASHMAP_NPOS;
+}
+
+static size_t b_hashmap_find_free(const BeanHashMap* map, uint64_t hash) {
+    size_t ngroups = map->cap / _BEAN_HASHMAP_GROUP_WIDTH;
+    size_t group = (size_t)(hash >> 7) & (ngroups - 1);
+
+    for (size_t step = 1; step <= ngroups; step++) {
+        const uint8_t* ctrl = &map->ctrl[group * _BEAN_HASHMAP_GROUP_WIDTH];
+        uint32_t match = b_hashmap_match_free(ctrl);
+
+        if (match != 0)
+            return group * _BEAN_HASHMAP_GROUP_WIDTH +
+                   (size_t)__builtin_ctz(match);
+        group = (group + step) & (ngroups - 1);
+    }
+
+    return _BEAN_HASHMAP_NPOS;
+}
+
+// Copies `key` into a `BeanString` that allocates from the map's allocator.
+static b_errno_t b_hashmap_init_key(const BeanHashMap* map, BeanString* str,
+                                    const BeanStringView* key) {
+    b_errno_t stat;
+    char* data;
+
+    // A fresh string is inline, so switching allocators moves nothing.
+    *str = (BeanString){0};
+    b_string_init(str);
+    b_string_set_allocator(str, map->allocator);
+    if (key->len > _BEAN_STRING_INLINE_CAPACITY &&
+        (stat = b_string_reserve(str, key->len)) != STATUS_SUCCESS)
+        return stat;
+
+    data = b_string_data(str);
+    memcpy(data, key->data, key->len);
+    data[key->len] = '\0';
+    str->len = key->len;
+
+    return STATUS_SUCCESS;
+}
+
+// Moves every entry into a fresh table of `cap` slots, dropping tombstones.
+static b_errno_t b_hashmap_rehash(BeanHashMap* map, size_t cap) {
+    B_TRACE_FUNC();
+    BeanHashMap res = *map;
+
+    res.ctrl =
+        b_alloc(map->allocator, cap + cap * map->slotsize, ALLOCTAG_HASHMAP);
+    if (res.ctrl == NULL)
+        return STATUS_FAILED_ALLOC;
+
+    res.slots = res.ctrl + cap;
+    res.cap = cap;
+    res.tombstones = 0;
+    res.growth_left = b_hashmap_max_load(cap) - map->len;
+    memset(res.ctrl, _BEAN_HASHMAP_EMPTY, cap);
+
+    for (size_t i = 0; i < map->cap; i++) {
+        BeanString* key;
+        uint64_t hash;
+        size_t dest;
+
+        if (map->ctrl[i] & 0x80)
+            continue;
+
+        key = b_hashmap_key_at(map, i);
+        hash = b_hash_string(key, 0);
+        dest = b_hashmap_find_free(&res, hash);
+        res.ctrl[dest] = (uint8_t)(hash & 0x7F);
+        memcpy(b_hashmap_key_at(&res, dest), key, map->slotsize);
+    }
+
+    b_free(map->allocator, map->ctrl, ALLOCTAG_HASHMAP);
+    *map = res;
+
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_hashmap_init(BeanHashMap* map, size_t valsize) {
+    *map = (BeanHashMap){
+        .ctrl = NULL,
+        .slots = NULL,
+        .len = 0,
+        .cap = 0,
+        .tombstones = 0,
+        .growth_left = 0,
+        .valsize = valsize,
+        .slotsize = (_BEAN_HASHMAP_VAL_OFFSET + valsize +
+                     _BEAN_HASHMAP_ALIGNMENT - 1) &
+                    ~(_BEAN_HASHMAP_ALIGNMENT - 1),
+        .allocator = b_allocator_get(),
+    };
+
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_hashmap_init_with_size(BeanHashMap* map, size_t valsize,
+                                   size_t count) {
+    b_errno_t stat;
+
+    b_hashmap_init(map, valsize);
+    if ((stat = b_hashmap_reserve(map, count)) == STATUS_FAILED_ALLOC)
+        return stat;
+
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_hashmap_deinit(BeanHashMap* map) {
+    if (map->slotsize == 0)
+        return STATUS_INVALID_OPERATION;
+
+    for (size_t i = 0; i < map->cap; i++) {
+        if (!(map->ctrl[i] & 0x80))
+            b_string_deinit(b_hashmap_key_at(map, i));
+    }
+
+    b_free(map->allocator, map->ctrl, ALLOCTAG_HASHMAP);
+    *map = (BeanHashMap){0};
+
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_hashmap_set_allocator(BeanHashMap* map,
+                                  const BeanAllocator* allocator) {
+    uint8_t* ctrl;
+
+    if (map->len != 0)
+        return STATUS_INVALID_OPERATION;
+
+    if (allocator == NULL)
+        allocator = b_allocator_get();
+    if (allocator == map->allocator)
+        return STATUS_SUCCESS;
+
+    // There are no keys to move, so the table only has to be cleared.
+    if (map->cap != 0) {
+        ctrl = b_alloc(allocator, map->cap + map->cap * map->slotsize,
+                       ALLOCTAG_HASHMAP);
+        if (ctrl == NULL)
+            return STATUS_FAILED_ALLOC;
+
+        memset(ctrl, _BEAN_HASHMAP_EMPTY, map->cap);
+        b_free(map->allocator, map->ctrl, ALLOCTAG_HASHMAP);
+        map->ctrl = ctrl;
+        map->slots = ctrl + map->cap;
+        map->tombstones = 0;
+        map->growth_left = b_hashmap_max_load(map->cap);
+    }
+
+    map->allocator = allocator;
+
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_hashmap_reserve(BeanHashMap* map, size_t count) {
+    size_t cap = _BEAN_HASHMAP_INITIAL_CAPACITY;
+
+    if (count < map->len)
+        count = map->len;
+
+    while (b_hashmap_max_load(cap) < count)
+        cap *= 2;
+
+    if (cap <= map->cap && map->tombstones == 0)
+        return STATUS_OPERATION_UNNECESSARY;
+
+    return b_hashmap_rehash(map, cap > map->cap ? cap : map->cap);
+}
+
+b_errno_t b_hashmap_insert(BeanHashMap* map, const BeanStringView* key,
+                           const void* val) {
+    uint64_t hash = b_hash_strview(key, 0);
+    size_t i = b_hashmap_find(map, key, hash);
+    b_errno_t stat;
+
+    if (i != _BEAN_HASHMAP_NPOS) {
+        memcpy(b_hashmap_val_at(map, i), val, map->valsize);
+        return STATUS_SUCCESS;
+    }
+
+    if (map->growth_left == 0) {
+        size_t cap = map->cap;
+
+        // Only grow if the live entries need it; if most of the load is
+        // tombstones, rehashing at the same size is enough.
+        if (cap == 0)
+            cap = _BEAN_HASHMAP_INITIAL_CAPACITY;
+        else if (map->len >= b_hashmap_max_load(cap) / 2)
+            cap *= 2;
+
+        if ((stat = b_hashmap_rehash(map, cap)) != STATUS_SUCCESS)
+            return stat;
+    }
+
+    i = b_hashmap_find_free(map, hash);
+    if ((stat = b_hashmap_init_key(map, b_hashmap_key_at(map, i), key)) !=
+        STATUS_SUCCESS)
+        return stat;
+
+    if (map->ctrl[i] == _BEAN_HASHMAP_DELETED)
+        map->tombstones--;
+    else
+        map->growth_left--;
+
+    map->ctrl[i] = (uint8_t)(hash & 0x7F);
+    memcpy(b_hashmap_val_at(map, i), val, map->valsize);
+    map->len++;
+
+    return STATUS_SUCCESS;
+}
+
+void* b_hashmap_get(const BeanHashMap* map, const BeanStringView* key) {
+    size_t i = b_hashmap_find(map, key, b_hash_strview(key, 0));
+
+    if (i == _BEAN_HASHMAP_NPOS)
+        return NULL;
+
+    return b_hashmap_val_at(map, i);
+}
+
+b_errno_t b_hashmap_erase(BeanHashMap* map, const BeanStringView* key) {
+    size_t i = b_hashmap_find(map, key, b_hash_strview(key, 0));
+    const uint8_t* group;
+
+    if (i == _BEAN_HASHMAP_NPOS)
+        return STATUS_INVALID_OPERATION;
+
+    b_string_deinit(b_hashmap_key_at(map, i));
+    map->len--;
+
+    // A group that still has an empty slot has never been full since the
+    // last rehash, so no probe sequence continues past it and the slot can
+    // be freed outright instead of leaving a tombstone.
+    group = &map->ctrl[i & ~(size_t)(_BEAN_HASHMAP_GROUP_WIDTH - 1)];
+    if (b_hashmap_match(group, _BEAN_HASHMAP_EMPTY) != 0) {
+        map->ctrl[i] = _BEAN_HASHMAP_EMPTY;
+        map->growth_left++;
+    } else {
+        map->ctrl[i] = _BEAN_HASHMAP_DELETED;
+        map->tombstones++;
+    }
+
+    return STATUS_SUCCESS;
+}
+
+void b_hashmap_iter_init(BeanHashMapIter* it, const BeanHashMap* map) {
+    *it = (BeanHashMapIter){.map = map, .index = 0};
+}
+
+bool b_hashmap_iter_next(BeanHashMapIter* it, const BeanString** key,
+                         void** val) {
+    const BeanHashMap* map = it->map;
+
+    while (it->index < map->cap && (map->ctrl[it->index] & 0x80))
+        it->index++;
+
+    if (it->index == map->cap)
+        return false;
+
+    *key = b_hashmap_key_at(map, it->index);
+    *val = b_hashmap_val_at(map, it->index);
+    it->index++;
+
+    return true;
+}
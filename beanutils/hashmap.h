@@ -0,0 +1,116 @@
+/* beanutils: Some data structure implementations and utility functions, I
+ * guess.
+ *
+ * Copyright (c) Eason Qin, 2024.
+ *
+ * NOTE: This source code form is licensed under the MIT license and comes
+ * with ABSOLUTELY NO WARRANTY. For more information, please view the
+ * `LICENSE` file at the root of the project.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "common.h"
+#include "string.h"
+
+#define _BEAN_HASHMAP_GROUP_WIDTH 16
+#define _BEAN_HASHMAP_INITIAL_CAPACITY 16
+
+/**
+ * A hash map from strings to fixed-size values, laid out Swiss-table style:
+ * one control byte per slot, probed 16 slots at a time. Keys are copied into
+ * `BeanString`s owned by the map, and values live inline next to them.
+ *
+ * The table and the keys come from `allocator`, the global allocator at
+ * initialization unless changed with `b_hashmap_set_allocator`.
+ */
+typedef struct {
+    uint8_t* ctrl;
+    unsigned char* slots;
+    size_t len;
+    size_t cap;
+    size_t tombstones;
+    size_t growth_left;
+    size_t valsize;
+    size_t slotsize;
+    const BeanAllocator* allocator;
+} BeanHashMap;
+
+/**
+ * Walks the entries of a `BeanHashMap` in unspecified order.
+ */
+typedef struct {
+    const BeanHashMap* map;
+    size_t index;
+} BeanHashMapIter;
+
+/**
+ * Initializes a new, empty `BeanHashMap` holding values of `valsize` bytes.
+ * Nothing is allocated until the first insertion.
+ */
+b_errno_t b_hashmap_init(BeanHashMap* map, size_t valsize);
+
+/**
+ * Initializes a new `BeanHashMap` with room for `count` entries.
+ */
+b_errno_t b_hashmap_init_with_size(BeanHashMap* map, size_t valsize,
+                                   size_t count);
+
+/**
+ * Frees every key and the table of a `BeanHashMap`.
+ */
+b_errno_t b_hashmap_deinit(BeanHashMap* map);
+
+/**
+ * Moves the table of an empty `BeanHashMap` to `allocator`, which its keys
+ * will also be allocated from. `NULL` selects the global allocator.
+ */
+b_errno_t b_hashmap_set_allocator(BeanHashMap* map,
+                                  const BeanAllocator* allocator);
+
+/**
+ * Makes room for at least `count` entries without rehashing. This also drops
+ * every tombstone left behind by erasures.
+ */
+b_errno_t b_hashmap_reserve(BeanHashMap* map, size_t count);
+
+/**
+ * Inserts `key`, or overwrites its value if it is already present.
+ *
+ *  @param val  `valsize` bytes to copy into the map.
+ */
+b_errno_t b_hashmap_insert(BeanHashMap* map, const BeanStringView* key,
+                           const void* val);
+
+/**
+ * Looks up `key`.
+ *
+ * @return A pointer to the value stored in the map, or `NULL`. It is
+ *         invalidated by the next insertion.
+ */
+void* b_hashmap_get(const BeanHashMap* map, const BeanStringView* key);
+
+/**
+ * Removes `key` from the map.
+ *
+ * @return `STATUS_INVALID_OPERATION` if the key is not present.
+ */
+b_errno_t b_hashmap_erase(BeanHashMap* map, const BeanStringView* key);
+
+/**
+ * Starts iterating over a `BeanHashMap`. The map must not be modified until
+ * the iteration is over.
+ */
+void b_hashmap_iter_init(BeanHashMapIter* it, const BeanHashMap* map);
+
+/**
+ * Gets the next entry of a `BeanHashMap`.
+ *
+ * @return `false` once every entry has been returned.
+ */
+bool b_hashmap_iter_next(BeanHashMapIter* it, const BeanString** key,
+                         void** val);
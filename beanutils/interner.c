@@ -0,0 +1,239 @@
+/* beanutils: Some data structure implementations and utility functions, I
+ * guess.
+ *
+ * Copyright (c) Eason Qin, 2024.
+ *
+ * NOTE: This source code form is licensed under the MIT license and comes
+ * with ABSOLUTELY NO WARRANTY. For more information, please view the
+ * `LICENSE` file at the root of the project.
+ */
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+#include "common.h"
+#include "hash.h"
+#include "interner.h"
+#include "string.h"
+
+typedef struct {
+    // Handles point here, so this has to stay the first member.
+    BeanStringView view;
+    uint64_t hash;
+} BeanInternEntry;
+
+struct BeanInternShard {
+    // Each shard gets its own cache line so neighbouring locks do not
+    // contend.
+    _Alignas(64) pthread_rwlock_t lock;
+    BeanArena arena;
+    BeanInternEntry** slots;
+    size_t len;
+    size_t cap;
+};
+
+static inline BeanInternShard* b_interner_shard(BeanInterner* interner,
+                                                uint64_t hash) {
+    // High bits pick the shard and the low bits the slot, so the two do
+    // not correlate.
+    return &interner->shards[(hash >> 48) % _BEAN_INTERNER_SHARDS];
+}
+
+// Linear probing over a table kept at most 3/4 full. Returns the slot holding
+// the string, or the empty slot it would go into.
+static size_t b_interner_probe(const BeanInternShard* shard,
+                               const BeanStringView* str, uint64_t hash) {
+    size_t mask = shard->cap - 1;
+    size_t i = (size_t)hash & mask;
+
+    for (;; i = (i + 1) & mask) {
+        const BeanInternEntry* entry = shard->slots[i];
+
+        if (entry == NULL)
+            return i;
+        if (entry->hash == hash && entry->view.len == str->len &&
+            memcmp(entry->view.data, str->data, str->len) == 0)
+            return i;
+    }
+}
+
+static b_errno_t b_interner_grow(BeanInterner* interner,
+                                 BeanInternShard* shard) {
+    size_t cap = shard->cap * 2;
+    BeanInternEntry** slots = b_calloc(interner->allocator, cap,
+                                       sizeof(BeanInternEntry*),
+                                       ALLOCTAG_INTERNER);
+
+    if (slots == NULL)
+        return STATUS_FAILED_ALLOC;
+
+    for (size_t i = 0; i < shard->cap; i++) {
+        BeanInternEntry* entry = shard->slots[i];
+        size_t j;
+
+        if (entry == NULL)
+            continue;
+
+        for (j = (size_t)entry->hash & (cap - 1); slots[j] != NULL;
+             j = (j + 1) & (cap - 1))
+            ;
+        slots[j] = entry;
+    }
+
+    b_free(interner->allocator, shard->slots, ALLOCTAG_INTERNER);
+    shard->slots = slots;
+    shard->cap = cap;
+
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_interner_init(BeanInterner* interner) {
+    const BeanAllocator* allocator = b_allocator_get();
+    BeanInternShard* shards = b_alloc_aligned(
+        allocator, sizeof(BeanInternShard) * _BEAN_INTERNER_SHARDS,
+        _Alignof(BeanInternShard), ALLOCTAG_INTERNER);
+
+    if (shards == NULL)
+        return STATUS_FAILED_ALLOC;
+
+    for (size_t i = 0; i < _BEAN_INTERNER_SHARDS; i++) {
+        BeanInternShard* shard = &shards[i];
+
+        shard->slots =
+            b_calloc(allocator, _BEAN_INTERNER_INITIAL_CAPACITY,
+                     sizeof(BeanInternEntry*), ALLOCTAG_INTERNER);
+        if (shard->slots == NULL) {
+            while (i-- > 0) {
+                b_free(allocator, shards[i].slots, ALLOCTAG_INTERNER);
+                b_arena_deinit(&shards[i].arena);
+                pthread_rwlock_destroy(&shards[i].lock);
+            }
+            b_free_aligned(allocator, shards, ALLOCTAG_INTERNER);
+            return STATUS_FAILED_ALLOC;
+        }
+
+        pthread_rwlock_init(&shard->lock, NULL);
+        b_arena_init(&shard->arena);
+        shard->len = 0;
+        shard->cap = _BEAN_INTERNER_INITIAL_CAPACITY;
+    }
+
+    interner->shards = shards;
+    interner->allocator = allocator;
+
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_interner_deinit(BeanInterner* interner) {
+    if (interner->shards == NULL)
+        return STATUS_INVALID_OPERATION;
+
+    for (size_t i = 0; i < _BEAN_INTERNER_SHARDS; i++) {
+        BeanInternShard* shard = &interner->shards[i];
+
+        b_free(interner->allocator, shard->slots, ALLOCTAG_INTERNER);
+        b_arena_deinit(&shard->arena);
+        pthread_rwlock_destroy(&shard->lock);
+    }
+
+    b_free_aligned(interner->allocator, interner->shards, ALLOCTAG_INTERNER);
+    interner->shards = NULL;
+
+    return STATUS_SUCCESS;
+}
+
+const BeanStringView* b_interner_lookup(BeanInterner* interner,
+                                        const BeanStringView* str) {
+    uint64_t hash = b_hash_strview(str, 0);
+    BeanInternShard* shard = b_interner_shard(interner, hash);
+    BeanInternEntry* entry;
+
+    pthread_rwlock_rdlock(&shard->lock);
+    entry = shard->slots[b_interner_probe(shard, str, hash)];
+    pthread_rwlock_unlock(&shard->lock);
+
+    return entry != NULL ? &entry->view : NULL;
+}
+
+// Adds a string that is known to be missing. The shard must be write-locked.
+static BeanInternEntry* b_interner_insert(BeanInterner* interner,
+                                          BeanInternShard* shard,
+                                          const BeanStringView* str,
+                                          uint64_t hash, size_t slot) {
+    BeanInternEntry* entry;
+    char* data;
+
+    if ((shard->len + 1) * 4 > shard->cap * 3) {
+        if (b_interner_grow(interner, shard) != STATUS_SUCCESS)
+            return NULL;
+        slot = b_interner_probe(shard, str, hash);
+    }
+
+    entry =
+        b_arena_alloc(&shard->arena, sizeof(BeanInternEntry) + str->len + 1);
+    if (entry == NULL)
+        return NULL;
+
+    data = (char*)(entry + 1);
+    memcpy(data, str->data, str->len);
+    data[str->len] = '\0';
+    *entry = (BeanInternEntry){
+        .view = {.data = data, .len = str->len},
+        .hash = hash,
+    };
+
+    shard->slots[slot] = entry;
+    shard->len++;
+
+    return entry;
+}
+
+const BeanStringView* b_interner_intern(BeanInterner* interner,
+                                        const BeanStringView* str) {
+    uint64_t hash = b_hash_strview(str, 0);
+    BeanInternShard* shard = b_interner_shard(interner, hash);
+    BeanInternEntry* entry;
+    size_t slot;
+
+    // Nearly every call finds a string that is already there, so try that
+    // under the shared lock first.
+    pthread_rwlock_rdlock(&shard->lock);
+    entry = shard->slots[b_interner_probe(shard, str, hash)];
+    pthread_rwlock_unlock(&shard->lock);
+
+    if (entry != NULL)
+        return &entry->view;
+
+    // Another thread may have added it in between, so look again.
+    pthread_rwlock_wrlock(&shard->lock);
+    slot = b_interner_probe(shard, str, hash);
+    if ((entry = shard->slots[slot]) == NULL)
+        entry = b_interner_insert(interner, shard, str, hash, slot);
+    pthread_rwlock_unlock(&shard->lock);
+
+    return entry != NULL ? &entry->view : NULL;
+}
+
+const BeanStringView* b_interner_intern_cstr(BeanInterner* interner,
+                                             const char* cstr) {
+    BeanStringView view = b_strview_from_cstr(cstr);
+    return b_interner_intern(interner, &view);
+}
+
+size_t b_interner_len(BeanInterner* interner) {
+    size_t len = 0;
+
+    for (size_t i = 0; i < _BEAN_INTERNER_SHARDS; i++) {
+        BeanInternShard* shard = &interner->shards[i];
+
+        pthread_rwlock_rdlock(&shard->lock);
+        len += shard->len;
+        pthread_rwlock_unlock(&shard->lock);
+    }
+
+    return len;
+}
@@ -0,0 +1,74 @@
+/* beanutils: Some data structure implementations and utility functions, I
+ * guess.
+ *
+ * Copyright (c) Eason Qin, 2024.
+ *
+ * NOTE: This source code form is licensed under the MIT license and comes
+ * with ABSOLUTELY NO WARRANTY. For more information, please view the
+ * `LICENSE` file at the root of the project.
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#include "alloc.h"
+#include "common.h"
+#include "string.h"
+
+#define _BEAN_INTERNER_SHARDS 16
+#define _BEAN_INTERNER_INITIAL_CAPACITY 64
+
+typedef struct BeanInternShard BeanInternShard;
+
+/**
+ * Stores each distinct string once and hands out a stable handle for it, so
+ * interned strings can be compared by address. The table is split into
+ * shards, each with its own reader-writer lock and `BeanArena`, and is safe to
+ * use from several threads at once.
+ */
+typedef struct {
+    BeanInternShard* shards;
+    const BeanAllocator* allocator;
+} BeanInterner;
+
+/**
+ * Initializes a new `BeanInterner`.
+ */
+b_errno_t b_interner_init(BeanInterner* interner);
+
+/**
+ * Frees every string held by a `BeanInterner`. Every handle it gave out is
+ * invalidated.
+ */
+b_errno_t b_interner_deinit(BeanInterner* interner);
+
+/**
+ * Interns the contents of a `BeanStringView`.
+ *
+ * @return The handle for the string, valid until the interner is
+ *         deinitialized, or `NULL` on failure. Its data is null-terminated.
+ *         Interning equal strings always gives the same handle.
+ */
+const BeanStringView* b_interner_intern(BeanInterner* interner,
+                                        const BeanStringView* str);
+
+/**
+ * Interns a C-style string.
+ */
+const BeanStringView* b_interner_intern_cstr(BeanInterner* interner,
+                                             const char* cstr);
+
+/**
+ * Gets the handle for a string that has already been interned, without
+ * adding it.
+ *
+ * @return The handle, or `NULL` if the string has not been interned.
+ */
+const BeanStringView* b_interner_lookup(BeanInterner* interner,
+                                        const BeanStringView* str);
+
+/**
+ * Gets the number of distinct strings held by a `BeanInterner`.
+ */
+size_t b_interner_len(BeanInterner* interner);
@@ -8,34 +8,78 @@
  * `LICENSE` file at the root of the project.
  */
 
+#include <errno.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/uio.h>
 
 #include "common.h"
 #include "io.h"
 #include "logger.h"
 #include "string.h"
+#include "trace.h"
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
 
 BeanString b_file_read(FILE* file) {
+    B_TRACE_FUNC();
     BeanString res = {0};
-    char currch;
+    struct stat st;
+    size_t cap = _BEAN_IO_BLOCK_SIZE;
+    char* data;
 
-    if (b_string_init(&res) != STATUS_SUCCESS) {
+    // Regular files can be read in one go. One spare byte lets the read
+    // come up short, so EOF is seen without another round trip.
+    if (fstat(fileno(file), &st) == 0 && S_ISREG(st.st_mode)) {
+        off_t pos = ftello(file);
+
+        if (pos >= 0 && st.st_size > pos)
+            cap = (size_t)(st.st_size - pos) + 1;
+    }
+
+    if (b_string_init_with_capacity(&res, cap) != STATUS_SUCCESS) {
         b_log(LOGLEVEL_FATAL, "could not initialize the BeanString");
         perror("error");
         exit(EXIT_FAILURE);
     }
 
-    while ((currch = fgetc(file)) != EOF) {
-        b_string_push(&res, currch);
+    for (;;) {
+        size_t room = res.cap - res.len;
+        size_t nread;
+
+        if (room == 0) {
+            if (b_string_reserve(&res, res.cap * 2) != STATUS_SUCCESS) {
+                b_log(LOGLEVEL_FATAL, "could not grow the BeanString");
+                perror("error");
+                exit(EXIT_FAILURE);
+            }
+            room = res.cap - res.len;
+        }
+
+        data = b_string_data(&res);
+        nread = fread(&data[res.len], 1, room, file);
+        res.len += nread;
+
+        if (nread < room)
+            break;
     }
 
+    data[res.len] = '\0';
+
     return res;
 }
 
 BeanString b_file_read_line(FILE* file) {
+    B_TRACE_FUNC();
     BeanString res = {0};
-    char currch;
+    int currch;
 
     if (b_string_init(&res) != STATUS_SUCCESS) {
         b_log(LOGLEVEL_FATAL, "could not initialize the BeanString");
@@ -43,15 +87,213 @@ BeanString b_file_read_line(FILE* file) {
         exit(EXIT_FAILURE);
     }
 
-    while ((currch = fgetc(file)) != '\n') {
-        b_string_push(&res, currch);
+    while ((currch = fgetc(file)) != EOF && currch != '\n') {
+        b_string_push(&res, (char)currch);
     }
 
     return res;
 }
 
 void b_file_write(FILE* file, BeanString* str) {
-    for (size_t i = 0; i < str->len; i++) {
-        fputc(str->data[i], file);
+    B_TRACE_FUNC();
+    fwrite(b_string_data(str), 1, str->len, file);
+}
+
+b_errno_t b_file_write_many(int fd, BeanString* strs[], size_t count) {
+    B_TRACE_FUNC();
+    struct iovec iov[IOV_MAX];
+    size_t next = 0;
+
+    while (next < count) {
+        struct iovec* curr = iov;
+        int iovcnt = 0;
+
+        for (; next < count && iovcnt < IOV_MAX; next++) {
+            if (strs[next]->len == 0)
+                continue;
+
+            iov[iovcnt++] = (struct iovec){
+                .iov_base = b_string_data(strs[next]),
+                .iov_len = strs[next]->len,
+            };
+        }
+
+        while (iovcnt > 0) {
+            ssize_t written = writev(fd, curr, iovcnt);
+
+            if (written < 0) {
+                if (errno == EINTR)
+                    continue;
+                return STATUS_GENERIC_FAILURE;
+            }
+
+            // Skip what was fully written and resume in the middle of the
+            // buffer the write stopped in.
+            while (iovcnt > 0 && (size_t)written >= curr->iov_len) {
+                written -= (ssize_t)curr->iov_len;
+                curr++;
+                iovcnt--;
+            }
+
+            if (iovcnt > 0) {
+                curr->iov_base = (char*)curr->iov_base + written;
+                curr->iov_len -= (size_t)written;
+            }
+        }
+    }
+
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_file_map(FILE* file, BeanMappedFile* map) {
+    B_TRACE_FUNC();
+    struct stat st;
+    void* addr;
+
+    *map = (BeanMappedFile){0};
+
+    if (fstat(fileno(file), &st) != 0 || !S_ISREG(st.st_mode))
+        return STATUS_INVALID_OPERATION;
+
+    // `mmap` refuses empty mappings, but an empty view is still valid.
+    if (st.st_size == 0) {
+        map->data = "";
+        return STATUS_SUCCESS;
+    }
+
+    addr = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fileno(file),
+                0);
+    if (addr == MAP_FAILED)
+        return STATUS_GENERIC_FAILURE;
+
+    // These are only hints, so failing to apply them is not an error.
+    madvise(addr, (size_t)st.st_size, MADV_SEQUENTIAL);
+    madvise(addr, (size_t)st.st_size, MADV_WILLNEED);
+
+    map->data = addr;
+    map->len = (size_t)st.st_size;
+
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_file_unmap(BeanMappedFile* map) {
+    if (map->data == NULL)
+        return STATUS_INVALID_OPERATION;
+
+    if (map->len != 0 && munmap((void*)map->data, map->len) != 0)
+        return STATUS_GENERIC_FAILURE;
+
+    *map = (BeanMappedFile){0};
+
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_linereader_init(BeanLineReader* reader, FILE* file) {
+    return b_linereader_init_with_size(reader, file,
+                                       _BEAN_LINE_READER_BUFFER_SIZE);
+}
+
+b_errno_t b_linereader_init_with_size(BeanLineReader* reader, FILE* file,
+                                      size_t size) {
+    if (size == 0)
+        return STATUS_INVALID_OPERATION;
+
+    *reader = (BeanLineReader){
+        .file = file,
+        .cap = size,
+        .allocator = b_allocator_get(),
+    };
+    reader->buf = b_alloc(reader->allocator, size, ALLOCTAG_LINEREADER);
+
+    if (reader->buf == NULL) {
+        reader->cap = 0;
+        return STATUS_FAILED_ALLOC;
+    }
+
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_linereader_deinit(BeanLineReader* reader) {
+    if (reader->cap == 0)
+        return STATUS_INVALID_OPERATION;
+
+    b_free(reader->allocator, reader->buf, ALLOCTAG_LINEREADER);
+    *reader = (BeanLineReader){0};
+
+    return STATUS_SUCCESS;
+}
+
+/**
+ * Moves the unread part of the buffer to the front and reads more after it.
+ */
+static b_errno_t b_linereader_refill(BeanLineReader* reader) {
+    B_TRACE_FUNC();
+    size_t nread;
+
+    if (reader->start > 0) {
+        memmove(reader->buf, &reader->buf[reader->start],
+                reader->end - reader->start);
+        reader->end -= reader->start;
+        reader->scan -= reader->start;
+        reader->start = 0;
+    } else if (reader->end == reader->cap) {
+        // The current line fills the whole buffer.
+        char* newbuf = b_realloc(reader->allocator, reader->buf,
+                                 reader->cap * 2, ALLOCTAG_LINEREADER);
+
+        if (newbuf == NULL)
+            return STATUS_FAILED_ALLOC;
+
+        reader->buf = newbuf;
+        reader->cap *= 2;
+    }
+
+    nread = fread(&reader->buf[reader->end], 1, reader->cap - reader->end,
+                  reader->file);
+    reader->end += nread;
+
+    // A failed read must not pass for the end of the file.
+    if (nread == 0 && ferror(reader->file))
+        return STATUS_GENERIC_FAILURE;
+    if (nread == 0 && feof(reader->file))
+        reader->eof = true;
+
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_linereader_next(BeanLineReader* reader, const char** line,
+                            size_t* len) {
+    b_errno_t stat;
+
+    for (;;) {
+        char* newline = memchr(&reader->buf[reader->scan], '\n',
+                               reader->end - reader->scan);
+
+        if (newline != NULL) {
+            size_t pos = (size_t)(newline - reader->buf);
+
+            *line = &reader->buf[reader->start];
+            *len = pos - reader->start;
+            reader->start = reader->scan = pos + 1;
+
+            return STATUS_SUCCESS;
+        }
+
+        // Nothing before `end` needs to be searched again after a refill.
+        reader->scan = reader->end;
+
+        if (reader->eof) {
+            if (reader->start == reader->end)
+                return STATUS_END_OF_FILE;
+
+            *line = &reader->buf[reader->start];
+            *len = reader->end - reader->start;
+            reader->start = reader->scan = reader->end;
+
+            return STATUS_SUCCESS;
+        }
+
+        if ((stat = b_linereader_refill(reader)) != STATUS_SUCCESS)
+            return stat;
     }
 }
@@ -13,16 +13,46 @@
 #include <stdbool.h>
 #include <stdio.h>
 
+#include "alloc.h"
 #include "common.h"
 #include "string.h"
 
+#define _BEAN_IO_BLOCK_SIZE          (64 * 1024)
+#define _BEAN_LINE_READER_BUFFER_SIZE (1024 * 1024)
+
+/**
+ * A read-only view of a whole file mapped into memory.
+ */
+typedef struct {
+    const char* data;
+    size_t len;
+} BeanMappedFile;
+
+/**
+ * Reads a file line by line through one large, refillable buffer.
+ *
+ * Lines are handed out as views into the buffer, so reading a line never
+ * allocates. The buffer only grows when a single line does not fit in it.
+ */
+typedef struct {
+    FILE* file;
+    char* buf;
+    size_t cap;
+    size_t start;
+    size_t scan;
+    size_t end;
+    bool eof;
+    const BeanAllocator* allocator;
+} BeanLineReader;
+
 /**
  * Reads a whole file into a `BeanString`.
  */
 BeanString b_file_read(FILE* file);
 
 /**
- * Reads a line of a whole file into a `BeanString`.
+ * Reads a line of a whole file into a `BeanString`, stopping at a newline or
+ * at the end of the file.
  */
 BeanString b_file_read_line(FILE* file);
 
@@ -30,3 +60,52 @@ BeanString b_file_read_line(FILE* file);
  * Writes the contents of a `BeanString` into a file.
  */
 void b_file_write(FILE* file, BeanString* str);
+
+/**
+ * Writes several `BeanString`s to a file descriptor with as few `writev`
+ * calls as possible, resuming after short writes.
+ *
+ * This bypasses stdio, so any `FILE*` on the same descriptor has to be
+ * flushed first.
+ */
+b_errno_t b_file_write_many(int fd, BeanString* strs[], size_t count);
+
+/**
+ * Maps the contents of a file into memory without copying them. The mapping
+ * stays valid after the file is closed, until `b_file_unmap` is called.
+ */
+b_errno_t b_file_map(FILE* file, BeanMappedFile* map);
+
+/**
+ * Unmaps a file mapped with `b_file_map`.
+ */
+b_errno_t b_file_unmap(BeanMappedFile* map);
+
+/**
+ * Initializes a new `BeanLineReader` over a file.
+ */
+b_errno_t b_linereader_init(BeanLineReader* reader, FILE* file);
+
+/**
+ * Initializes a new `BeanLineReader` with a buffer of `size` bytes.
+ */
+b_errno_t b_linereader_init_with_size(BeanLineReader* reader, FILE* file,
+                                      size_t size);
+
+/**
+ * Frees the buffer of a `BeanLineReader`. The file is left open.
+ */
+b_errno_t b_linereader_deinit(BeanLineReader* reader);
+
+/**
+ * Reads the next line, without its newline, from a `BeanLineReader`.
+ *
+ * The line is not null-terminated and stays valid until the next call. The
+ * last line of a file does not need a trailing newline.
+ *
+ * @return `STATUS_END_OF_FILE` once every line has been read, or
+ *         `STATUS_GENERIC_FAILURE` if reading the file failed (see
+ *         `ferror`).
+ */
+b_errno_t b_linereader_next(BeanLineReader* reader, const char** line,
+                            size_t* len);
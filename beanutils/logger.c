@@ -8,32 +8,943 @@
  * `LICENSE` file at the root of the project.
  */
 
+#include <pthread.h>
+#include <sched.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
+#include "common.h"
 #include "logger.h"
 
-void b_log(b_loglevel_t lvl, const char* restrict format, ...) {
-    va_list args;
-    char* logprefix_buf;
+#define _BEAN_LOG_BINARY_MAGIC "BLOG\x01"
+
+typedef struct {
+    _Alignas(64) atomic_size_t seq;
+    b_loglevel_t lvl;
+    uint32_t len;
+    const BeanLogSite* site;
+    const char* format;
+    uint64_t timestamp;
+    char msg[_BEAN_LOG_MESSAGE_SIZE];
+} BeanLogSlot;
+
+/**
+ * The types a conversion specification can pull out of a `va_list`.
+ */
+typedef enum {
+    LOGARG_INT,
+    LOGARG_LONG,
+    LOGARG_LLONG,
+    LOGARG_INTMAX,
+    LOGARG_SIZE,
+    LOGARG_PTRDIFF,
+    LOGARG_DOUBLE,
+    LOGARG_LDOUBLE,
+    LOGARG_STRING,
+    LOGARG_POINTER,
+} b_logarg_t;
+
+/**
+ * A bounded multi-producer ring buffer: every slot carries a sequence number
+ * that tells producers and the consumer whose turn it is, so producers only
+ * ever contend on one atomic counter.
+ */
+static struct {
+    _Alignas(64) atomic_size_t tail;
+    _Alignas(64) atomic_size_t written;
+    atomic_size_t dropped;
+    atomic_bool running;
+    atomic_bool stopping;
+    BeanLogSlot* slots;
+    size_t mask;
+    b_logoverflow_t overflow;
+    b_logformat_t format;
+    FILE* output;
+    pthread_t thread;
+} b_log_async;
 
+/**
+ * The site of messages logged through `b_log` in binary mode. They are
+ * formatted up front and recorded as the single string argument of `"%s"`,
+ * so the caller's format string is never kept past the call.
+ */
+static BeanLogSite b_log_text_site = {
+    .ready = 2,
+    .nargs = 1,
+    .args = {LOGARG_STRING},
+};
+
+static const char* b_log_prefix(b_loglevel_t lvl) {
     switch (lvl) {
-        case LOGLEVEL_LOG: {
-            logprefix_buf = "[INFO] ";
-        } break;
-        case LOGLEVEL_WARN: {
-            logprefix_buf = "[WARN] ";
-        } break;
-        case LOGLEVEL_ERROR: {
-            logprefix_buf = "[ERROR] ";
-        } break;
-        case LOGLEVEL_FATAL: {
-            logprefix_buf = "[FATAL] ";
-        } break;
+        case LOGLEVEL_LOG:
+            return "[INFO] ";
+        case LOGLEVEL_WARN:
+            return "[WARN] ";
+        case LOGLEVEL_ERROR:
+            return "[ERROR] ";
+        case LOGLEVEL_FATAL:
+            return "[FATAL] ";
         default:
-            logprefix_buf = "[INFO] ";
+            return "[INFO] ";
+    }
+}
+
+/**
+ * Parses the conversion specification starting at `spec` (just after its
+ * `%`), storing the types of the arguments it consumes, `*` widths and
+ * precisions included.
+ *
+ * @return A pointer just past the specification.
+ */
+static const char* b_log_parse_spec(const char* spec, b_logarg_t* args,
+                                    size_t* nargs) {
+    int longs = 0;
+    int shorts = 0;
+    bool longdouble = false;
+    char size = 0;
+
+    *nargs = 0;
+
+    while (*spec != '\0' && strchr("-+ #0'", *spec) != NULL)
+        spec++;
+    for (; *spec == '*' || (*spec >= '0' && *spec <= '9') || *spec == '.';
+         spec++)
+        if (*spec == '*')
+            args[(*nargs)++] = LOGARG_INT;
+
+    for (;; spec++) {
+        if (*spec == 'l')
+            longs++;
+        else if (*spec == 'h')
+            shorts++;
+        else if (*spec == 'L')
+            longdouble = true;
+        else if (*spec == 'j' || *spec == 'z' || *spec == 't')
+            size = *spec;
+        else
+            break;
+    }
+
+    switch (*spec) {
+        case 'd':
+        case 'i':
+        case 'o':
+        case 'u':
+        case 'x':
+        case 'X':
+        case 'c':
+            if (size == 'j')
+                args[(*nargs)++] = LOGARG_INTMAX;
+            else if (size == 'z')
+                args[(*nargs)++] = LOGARG_SIZE;
+            else if (size == 't')
+                args[(*nargs)++] = LOGARG_PTRDIFF;
+            else if (longs >= 2)
+                args[(*nargs)++] = LOGARG_LLONG;
+            else if (longs == 1 && *spec != 'c')
+                args[(*nargs)++] = LOGARG_LONG;
+            else
+                args[(*nargs)++] = LOGARG_INT;
+            break;
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+            args[(*nargs)++] = longdouble ? LOGARG_LDOUBLE : LOGARG_DOUBLE;
+            break;
+        case 's':
+            args[(*nargs)++] = LOGARG_STRING;
+            break;
+        case 'p':
+        case 'n':
+            args[(*nargs)++] = LOGARG_POINTER;
+            break;
+        case '\0':
+            return spec;
+        default:
+            break;
+    }
+
+    (void)shorts;
+
+    return spec + 1;
+}
+
+/**
+ * Lists the argument types of a whole format string, up to
+ * `_BEAN_LOG_MAX_ARGS` of them.
+ */
+static size_t b_log_parse_format(const char* format, unsigned char* args) {
+    size_t nargs = 0;
+
+    while ((format = strchr(format, '%')) != NULL) {
+        b_logarg_t specargs[3];
+        size_t count;
+
+        if (format[1] == '%') {
+            format += 2;
+            continue;
+        }
+
+        format = b_log_parse_spec(format + 1, specargs, &count);
+        for (size_t i = 0; i < count && nargs < _BEAN_LOG_MAX_ARGS; i++)
+            args[nargs++] = (unsigned char)specargs[i];
+    }
+
+    return nargs;
+}
+
+/**
+ * Copies the raw bytes of every argument into `buf`. Strings are stored with
+ * a 16-bit length and cut short if they do not fit; arguments that do not
+ * fit at all are left out.
+ */
+static size_t b_log_capture(char* buf, size_t cap, const unsigned char* args,
+                            size_t nargs, va_list vargs) {
+    size_t len = 0;
+
+#define B_LOG_CAPTURE(T)                                                       \
+    do {                                                                       \
+        T value = va_arg(vargs, T);                                            \
+        if (len + sizeof(T) > cap)                                             \
+            return len;                                                        \
+        memcpy(&buf[len], &value, sizeof(T));                                  \
+        len += sizeof(T);                                                      \
+    } while (0)
+
+    for (size_t i = 0; i < nargs; i++) {
+        switch ((b_logarg_t)args[i]) {
+            case LOGARG_INT:
+                B_LOG_CAPTURE(int);
+                break;
+            case LOGARG_LONG:
+                B_LOG_CAPTURE(long);
+                break;
+            case LOGARG_LLONG:
+                B_LOG_CAPTURE(long long);
+                break;
+            case LOGARG_INTMAX:
+                B_LOG_CAPTURE(intmax_t);
+                break;
+            case LOGARG_SIZE:
+                B_LOG_CAPTURE(size_t);
+                break;
+            case LOGARG_PTRDIFF:
+                B_LOG_CAPTURE(ptrdiff_t);
+                break;
+            case LOGARG_DOUBLE:
+                B_LOG_CAPTURE(double);
+                break;
+            case LOGARG_LDOUBLE:
+                B_LOG_CAPTURE(long double);
+                break;
+            case LOGARG_POINTER:
+                B_LOG_CAPTURE(void*);
+                break;
+            case LOGARG_STRING: {
+                const char* str = va_arg(vargs, const char*);
+                size_t strlen_ = str != NULL ? strlen(str) : 0;
+                uint16_t stored;
+
+                if (len + sizeof(uint16_t) > cap)
+                    return len;
+                if (strlen_ > cap - len - sizeof(uint16_t))
+                    strlen_ = cap - len - sizeof(uint16_t);
+
+                stored = (uint16_t)strlen_;
+                memcpy(&buf[len], &stored, sizeof(stored));
+                memcpy(&buf[len + sizeof(stored)], str, strlen_);
+                len += sizeof(stored) + strlen_;
+            } break;
+        }
+    }
+
+#undef B_LOG_CAPTURE
+
+    return len;
+}
+
+static void b_log_sync(b_loglevel_t lvl, const char* restrict format,
+                       va_list args) {
+    FILE* output = stderr;
+
+    // A binary stream cannot take text, so it falls back to the standard
+    // error.
+    if (b_log_async.output != NULL && b_log_async.format == LOGFORMAT_TEXT)
+        output = b_log_async.output;
+
+    flockfile(output);
+    fputs(b_log_prefix(lvl), output);
+    vfprintf(output, format, args);
+    fputc('\n', output);
+    funlockfile(output);
+}
+
+/**
+ * Claims the next slot of the ring buffer, or returns `NULL` if the message
+ * has to be dropped.
+ */
+static BeanLogSlot* b_log_claim(size_t* pos) {
+    *pos = atomic_load_explicit(&b_log_async.tail, memory_order_relaxed);
+
+    for (;;) {
+        BeanLogSlot* slot = &b_log_async.slots[*pos & b_log_async.mask];
+        size_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+
+        if (seq == *pos) {
+            if (atomic_compare_exchange_weak_explicit(
+                    &b_log_async.tail, pos, *pos + 1, memory_order_relaxed,
+                    memory_order_relaxed))
+                return slot;
+        } else if ((ptrdiff_t)(seq - *pos) < 0) {
+            // The consumer has not caught up with this slot yet.
+            if (b_log_async.overflow == LOGOVERFLOW_DROP) {
+                atomic_fetch_add_explicit(&b_log_async.dropped, 1,
+                                          memory_order_relaxed);
+                return NULL;
+            }
+
+            sched_yield();
+            *pos = atomic_load_explicit(&b_log_async.tail,
+                                        memory_order_relaxed);
+        } else {
+            *pos = atomic_load_explicit(&b_log_async.tail,
+                                        memory_order_relaxed);
+        }
+    }
+}
+
+static void b_log_publish(BeanLogSlot* slot, size_t pos) {
+    atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+}
+
+static void b_log_enqueue(b_loglevel_t lvl, const char* restrict format,
+                          va_list args) {
+    size_t pos;
+    BeanLogSlot* slot = b_log_claim(&pos);
+    int len;
+
+    if (slot == NULL)
+        return;
+
+    len = vsnprintf(slot->msg, sizeof(slot->msg), format, args);
+    if (len < 0)
+        len = 0;
+    else if ((size_t)len >= sizeof(slot->msg))
+        len = sizeof(slot->msg) - 1;
+
+    slot->lvl = lvl;
+    slot->len = (uint32_t)len;
+    b_log_publish(slot, pos);
+}
+
+static uint64_t b_log_timestamp(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void b_log_enqueue_binary(const BeanLogSite* site, b_loglevel_t lvl,
+                                 const char* format, const unsigned char* args,
+                                 size_t nargs, va_list vargs) {
+    size_t pos;
+    BeanLogSlot* slot = b_log_claim(&pos);
+
+    if (slot == NULL)
+        return;
+
+    slot->lvl = lvl;
+    slot->site = site;
+    slot->format = format;
+    slot->timestamp = b_log_timestamp();
+    slot->len = (uint32_t)b_log_capture(slot->msg, sizeof(slot->msg), args,
+                                        nargs, vargs);
+    b_log_publish(slot, pos);
+}
+
+/**
+ * Formats a message straight into a slot as the string argument of
+ * `b_log_text_site`, for formats that are not known to outlive the call.
+ */
+static void b_log_enqueue_formatted(b_loglevel_t lvl,
+                                    const char* restrict format,
+                                    va_list args) {
+    size_t pos;
+    BeanLogSlot* slot = b_log_claim(&pos);
+    uint16_t stored;
+    int len;
+
+    if (slot == NULL)
+        return;
+
+    len = vsnprintf(&slot->msg[sizeof(stored)],
+                    sizeof(slot->msg) - sizeof(stored), format, args);
+    if (len < 0)
+        len = 0;
+    else if ((size_t)len >= sizeof(slot->msg) - sizeof(stored))
+        len = sizeof(slot->msg) - sizeof(stored) - 1;
+
+    stored = (uint16_t)len;
+    memcpy(slot->msg, &stored, sizeof(stored));
+
+    slot->lvl = lvl;
+    slot->site = &b_log_text_site;
+    slot->format = "%s";
+    slot->timestamp = b_log_timestamp();
+    slot->len = (uint32_t)(sizeof(stored) + (size_t)len);
+    b_log_publish(slot, pos);
+}
+
+/**
+ * The drain thread's map from call sites to the ids of their format strings
+ * in a binary stream. Sites are static, so their addresses are never reused
+ * for another format. Only the drain thread touches it.
+ */
+typedef struct {
+    const BeanLogSite* site;
+    uint32_t id;
+} BeanLogFormatEntry;
+
+typedef struct {
+    BeanLogFormatEntry* entries;
+    size_t cap;
+    size_t len;
+} BeanLogFormatTable;
+
+static size_t b_log_format_slot(const BeanLogFormatEntry* entries, size_t cap,
+                                const BeanLogSite* site) {
+    size_t idx = ((uintptr_t)site >> 3) & (cap - 1);
+
+    while (entries[idx].site != NULL && entries[idx].site != site)
+        idx = (idx + 1) & (cap - 1);
+
+    return idx;
+}
+
+static uint32_t b_log_format_id(BeanLogFormatTable* table,
+                                const BeanLogSite* site, bool* isnew) {
+    size_t idx;
+
+    *isnew = false;
+
+    if (table->len * 2 >= table->cap) {
+        size_t newcap = table->cap != 0 ? table->cap * 2 : 256;
+        BeanLogFormatEntry* entries =
+            calloc(newcap, sizeof(BeanLogFormatEntry));
+
+        // Without memory for the table, every record redefines its format
+        // under a spare id.
+        if (entries == NULL) {
+            *isnew = true;
+            return UINT32_MAX;
+        }
+
+        for (size_t i = 0; i < table->cap; i++)
+            if (table->entries[i].site != NULL)
+                entries[b_log_format_slot(entries, newcap,
+                                          table->entries[i].site)] =
+                    table->entries[i];
+
+        free(table->entries);
+        table->entries = entries;
+        table->cap = newcap;
+    }
+
+    idx = b_log_format_slot(table->entries, table->cap, site);
+    if (table->entries[idx].site == NULL) {
+        table->entries[idx] = (BeanLogFormatEntry){
+            .site = site,
+            .id = (uint32_t)table->len++,
+        };
+        *isnew = true;
+    }
+
+    return table->entries[idx].id;
+}
+
+/**
+ * Writes out everything before `head` and tells `b_log_flush` so. Publishing
+ * after every batch, not only once the ring runs empty, keeps flushes from
+ * waiting forever while other threads keep logging.
+ */
+static void b_log_write_batch(const char* batch, size_t* batchlen,
+                              size_t head) {
+    if (batch != NULL && *batchlen > 0) {
+        fwrite(batch, 1, *batchlen, b_log_async.output);
+        *batchlen = 0;
+    }
+    fflush(b_log_async.output);
+    atomic_store_explicit(&b_log_async.written, head, memory_order_release);
+}
+
+static void* b_log_drain(void* arg) {
+    char* batch = malloc(_BEAN_LOG_BATCH_SIZE);
+    size_t batchlen = 0;
+    size_t head = 0;
+    size_t capacity = b_log_async.mask + 1;
+    BeanLogFormatTable formats = {0};
+
+    (void)arg;
+
+    if (b_log_async.format == LOGFORMAT_BINARY)
+        fwrite(_BEAN_LOG_BINARY_MAGIC, 1, sizeof(_BEAN_LOG_BINARY_MAGIC) - 1,
+               b_log_async.output);
+
+    for (;;) {
+        BeanLogSlot* slot = &b_log_async.slots[head & b_log_async.mask];
+        size_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+
+        if (seq == head + 1) {
+            char record[_BEAN_LOG_MESSAGE_SIZE + 64];
+            size_t need;
+
+            if (b_log_async.format == LOGFORMAT_BINARY) {
+                bool isnew;
+                uint32_t id = b_log_format_id(&formats, slot->site, &isnew);
+                uint8_t lvl = (uint8_t)slot->lvl;
+
+                // The first record of a format string defines its id.
+                if (isnew) {
+                    uint32_t fmtlen = (uint32_t)strlen(slot->format);
+
+                    if (batch != NULL && batchlen > 0)
+                        b_log_write_batch(batch, &batchlen, head);
+                    fputc('F', b_log_async.output);
+                    fwrite(&id, sizeof(id), 1, b_log_async.output);
+                    fwrite(&fmtlen, sizeof(fmtlen), 1, b_log_async.output);
+                    fwrite(slot->format, 1, fmtlen, b_log_async.output);
+                }
+
+                need = 0;
+                record[need++] = 'R';
+                memcpy(&record[need], &id, sizeof(id));
+                need += sizeof(id);
+                record[need++] = (char)lvl;
+                memcpy(&record[need], &slot->timestamp, sizeof(uint64_t));
+                need += sizeof(uint64_t);
+                memcpy(&record[need], &slot->len, sizeof(uint32_t));
+                need += sizeof(uint32_t);
+                memcpy(&record[need], slot->msg, slot->len);
+                need += slot->len;
+            } else {
+                const char* prefix = b_log_prefix(slot->lvl);
+                size_t prefixlen = strlen(prefix);
+
+                memcpy(record, prefix, prefixlen);
+                memcpy(&record[prefixlen], slot->msg, slot->len);
+                record[prefixlen + slot->len] = '\n';
+                need = prefixlen + slot->len + 1;
+            }
+
+            if (batch != NULL && batchlen + need > _BEAN_LOG_BATCH_SIZE)
+                b_log_write_batch(batch, &batchlen, head);
+
+            if (batch != NULL) {
+                memcpy(&batch[batchlen], record, need);
+                batchlen += need;
+            } else {
+                fwrite(record, 1, need, b_log_async.output);
+            }
+
+            atomic_store_explicit(&slot->seq, head + capacity,
+                                  memory_order_release);
+            head++;
+
+            // Without a batch, every record is its own write.
+            if (batch == NULL)
+                b_log_write_batch(batch, &batchlen, head);
+            continue;
+        }
+
+        // The ring is empty: write the batch out before going idle.
+        b_log_write_batch(batch, &batchlen, head);
+
+        if (atomic_load_explicit(&b_log_async.stopping,
+                                 memory_order_acquire) &&
+            head == atomic_load_explicit(&b_log_async.tail,
+                                         memory_order_acquire))
+            break;
+
+        nanosleep(&(struct timespec){.tv_nsec = 500 * 1000}, NULL);
+    }
+
+    free(formats.entries);
+    free(batch);
+
+    return NULL;
+}
+
+void b_log(b_loglevel_t lvl, const char* restrict format, ...) {
+    va_list args;
+
+    va_start(args, format);
+
+    if (lvl != LOGLEVEL_FATAL &&
+        atomic_load_explicit(&b_log_async.running, memory_order_acquire)) {
+        if (b_log_async.format == LOGFORMAT_BINARY)
+            b_log_enqueue_formatted(lvl, format, args);
+        else
+            b_log_enqueue(lvl, format, args);
+    } else {
+        // Anything still queued has to come out before a fatal message.
+        if (atomic_load_explicit(&b_log_async.running, memory_order_acquire))
+            b_log_flush();
+        b_log_sync(lvl, format, args);
+    }
+
+    va_end(args);
+}
+
+void b_log_deferred(BeanLogSite* site, b_loglevel_t lvl,
+                    const char* restrict format, ...) {
+    va_list args;
+
+    va_start(args, format);
+
+    if (lvl != LOGLEVEL_FATAL &&
+        atomic_load_explicit(&b_log_async.running, memory_order_acquire) &&
+        b_log_async.format == LOGFORMAT_BINARY) {
+        if (atomic_load_explicit(&site->ready, memory_order_acquire) == 2) {
+            b_log_enqueue_binary(site, lvl, format, site->args, site->nargs,
+                                 args);
+        } else {
+            unsigned char types[_BEAN_LOG_MAX_ARGS];
+            size_t nargs = b_log_parse_format(format, types);
+            int expected = 0;
+
+            // Only the thread that wins the race fills in the cache.
+            if (atomic_compare_exchange_strong(&site->ready, &expected, 1)) {
+                memcpy(site->args, types, nargs);
+                site->nargs = (unsigned char)nargs;
+                atomic_store_explicit(&site->ready, 2, memory_order_release);
+            }
+
+            b_log_enqueue_binary(site, lvl, format, types, nargs, args);
+        }
+    } else if (lvl != LOGLEVEL_FATAL &&
+               atomic_load_explicit(&b_log_async.running,
+                                    memory_order_acquire)) {
+        b_log_enqueue(lvl, format, args);
+    } else {
+        if (atomic_load_explicit(&b_log_async.running, memory_order_acquire))
+            b_log_flush();
+        b_log_sync(lvl, format, args);
+    }
+
+    va_end(args);
+}
+
+b_errno_t b_log_async_start(const BeanLogConfig* config) {
+    size_t capacity = _BEAN_LOG_RING_CAPACITY;
+    size_t requested = config != NULL ? config->capacity : 0;
+
+    if (atomic_load(&b_log_async.running))
+        return STATUS_INVALID_OPERATION;
+
+    if (requested != 0)
+        for (capacity = 2; capacity < requested; capacity *= 2)
+            ;
+
+    b_log_async.slots = aligned_alloc(_Alignof(BeanLogSlot),
+                                      sizeof(BeanLogSlot) * capacity);
+    if (b_log_async.slots == NULL)
+        return STATUS_FAILED_ALLOC;
+
+    for (size_t i = 0; i < capacity; i++)
+        atomic_init(&b_log_async.slots[i].seq, i);
+
+    b_log_async.mask = capacity - 1;
+    b_log_async.overflow =
+        config != NULL ? config->overflow : LOGOVERFLOW_DROP;
+    b_log_async.format = config != NULL ? config->format : LOGFORMAT_TEXT;
+    b_log_async.output =
+        config != NULL && config->output != NULL ? config->output : stderr;
+    atomic_store(&b_log_async.tail, 0);
+    atomic_store(&b_log_async.written, 0);
+    atomic_store(&b_log_async.dropped, 0);
+    atomic_store(&b_log_async.stopping, false);
+
+    if (pthread_create(&b_log_async.thread, NULL, b_log_drain, NULL) != 0) {
+        free(b_log_async.slots);
+        b_log_async.slots = NULL;
+        return STATUS_GENERIC_FAILURE;
+    }
+
+    atomic_store(&b_log_async.running, true);
+
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_log_flush(void) {
+    size_t target;
+
+    if (!atomic_load(&b_log_async.running))
+        return STATUS_OPERATION_UNNECESSARY;
+
+    target = atomic_load_explicit(&b_log_async.tail, memory_order_acquire);
+    while (atomic_load_explicit(&b_log_async.written, memory_order_acquire) <
+           target)
+        nanosleep(&(struct timespec){.tv_nsec = 100 * 1000}, NULL);
+
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_log_async_stop(void) {
+    if (!atomic_load(&b_log_async.running))
+        return STATUS_INVALID_OPERATION;
+
+    atomic_store(&b_log_async.running, false);
+    atomic_store(&b_log_async.stopping, true);
+    pthread_join(b_log_async.thread, NULL);
+
+    free(b_log_async.slots);
+    b_log_async.slots = NULL;
+    b_log_async.output = NULL;
+
+    return STATUS_SUCCESS;
+}
+
+size_t b_log_dropped(void) {
+    return atomic_load_explicit(&b_log_async.dropped, memory_order_relaxed);
+}
+
+static bool b_log_take(const char* payload, size_t len, size_t* pos, void* out,
+                       size_t size) {
+    if (*pos + size > len)
+        return false;
+
+    memcpy(out, &payload[*pos], size);
+    *pos += size;
+
+    return true;
+}
+
+/**
+ * Formats one binary record by handing each conversion specification of its
+ * format string to `fprintf` along with the matching captured argument.
+ */
+static void b_log_write_record(FILE* output, b_loglevel_t lvl,
+                               uint64_t timestamp, const char* format,
+                               const char* payload, size_t len) {
+    size_t pos = 0;
+
+    fprintf(output, "%llu.%09llu %s",
+            (unsigned long long)(timestamp / 1000000000u),
+            (unsigned long long)(timestamp % 1000000000u), b_log_prefix(lvl));
+
+    while (*format != '\0') {
+        const char* pct = strchr(format, '%');
+        const char* end;
+        b_logarg_t args[3];
+        size_t nargs;
+        char spec[32];
+        int stars[2] = {0};
+        size_t nstars = 0;
+        bool missing = false;
+
+        if (pct == NULL) {
+            fputs(format, output);
+            break;
+        }
+
+        fwrite(format, 1, (size_t)(pct - format), output);
+        if (pct[1] == '%') {
+            fputc('%', output);
+            format = pct + 2;
+            continue;
+        }
+
+        end = b_log_parse_spec(pct + 1, args, &nargs);
+        format = end;
+
+        if (nargs == 0 || (size_t)(end - pct) >= sizeof(spec) ||
+            end[-1] == 'n') {
+            if (end[-1] != 'n')
+                fwrite(pct, 1, (size_t)(end - pct), output);
+            continue;
+        }
+
+        memcpy(spec, pct, (size_t)(end - pct));
+        spec[end - pct] = '\0';
+
+        for (; nstars + 1 < nargs; nstars++)
+            missing |= !b_log_take(payload, len, &pos, &stars[nstars],
+                                   sizeof(int));
+
+#define B_LOG_PRINT(value)                                                     \
+    (nstars == 0   ? fprintf(output, spec, value)                              \
+     : nstars == 1 ? fprintf(output, spec, stars[0], value)                    \
+                   : fprintf(output, spec, stars[0], stars[1], value))
+
+#define B_LOG_PRINT_AS(T)                                                      \
+    do {                                                                       \
+        T value;                                                               \
+        if (missing || !b_log_take(payload, len, &pos, &value, sizeof(T)))     \
+            fputs("<?>", output);                                              \
+        else                                                                   \
+            B_LOG_PRINT(value);                                                \
+    } while (0)
+
+        switch (args[nargs - 1]) {
+            case LOGARG_INT:
+                B_LOG_PRINT_AS(int);
+                break;
+            case LOGARG_LONG:
+                B_LOG_PRINT_AS(long);
+                break;
+            case LOGARG_LLONG:
+                B_LOG_PRINT_AS(long long);
+                break;
+            case LOGARG_INTMAX:
+                B_LOG_PRINT_AS(intmax_t);
+                break;
+            case LOGARG_SIZE:
+                B_LOG_PRINT_AS(size_t);
+                break;
+            case LOGARG_PTRDIFF:
+                B_LOG_PRINT_AS(ptrdiff_t);
+                break;
+            case LOGARG_DOUBLE:
+                B_LOG_PRINT_AS(double);
+                break;
+            case LOGARG_LDOUBLE:
+                B_LOG_PRINT_AS(long double);
+                break;
+            case LOGARG_POINTER:
+                B_LOG_PRINT_AS(void*);
+                break;
+            case LOGARG_STRING: {
+                char str[_BEAN_LOG_MESSAGE_SIZE + 1];
+                uint16_t strlen_;
+
+                if (missing ||
+                    !b_log_take(payload, len, &pos, &strlen_,
+                                sizeof(strlen_)) ||
+                    !b_log_take(payload, len, &pos, str, strlen_)) {
+                    fputs("<?>", output);
+                    break;
+                }
+
+                str[strlen_] = '\0';
+                B_LOG_PRINT(str);
+            } break;
+        }
+
+#undef B_LOG_PRINT_AS
+#undef B_LOG_PRINT
+    }
+
+    fputc('\n', output);
+}
+
+b_errno_t b_log_decode(FILE* input, FILE* output) {
+    char magic[sizeof(_BEAN_LOG_BINARY_MAGIC) - 1];
+    char** formats = NULL;
+    size_t nformats = 0;
+    char* spare = NULL;
+    b_errno_t stat = STATUS_SUCCESS;
+    int tag;
+
+    if (fread(magic, 1, sizeof(magic), input) != sizeof(magic) ||
+        memcmp(magic, _BEAN_LOG_BINARY_MAGIC, sizeof(magic)) != 0)
+        return STATUS_INVALID_OPERATION;
+
+    while ((tag = fgetc(input)) != EOF) {
+        uint32_t id;
+        uint32_t len;
+
+        if (fread(&id, sizeof(id), 1, input) != 1) {
+            stat = STATUS_GENERIC_FAILURE;
+            break;
+        }
+
+        if (tag == 'F') {
+            char* format;
+
+            if (fread(&len, sizeof(len), 1, input) != 1 ||
+                (format = malloc((size_t)len + 1)) == NULL) {
+                stat = STATUS_GENERIC_FAILURE;
+                break;
+            }
+
+            if (fread(format, 1, len, input) != len) {
+                free(format);
+                stat = STATUS_GENERIC_FAILURE;
+                break;
+            }
+            format[len] = '\0';
+
+            if (id == UINT32_MAX) {
+                free(spare);
+                spare = format;
+                continue;
+            }
+
+            if (id >= nformats) {
+                size_t newlen = (size_t)id + 1;
+                char** grown = realloc(formats, sizeof(char*) * newlen);
+
+                if (grown == NULL) {
+                    free(format);
+                    stat = STATUS_FAILED_ALLOC;
+                    break;
+                }
+
+                memset(&grown[nformats], 0,
+                       sizeof(char*) * (newlen - nformats));
+                formats = grown;
+                nformats = newlen;
+            }
+
+            free(formats[id]);
+            formats[id] = format;
+        } else if (tag == 'R') {
+            char payload[_BEAN_LOG_MESSAGE_SIZE];
+            uint64_t timestamp;
+            int lvl = fgetc(input);
+            const char* format;
+
+            if (lvl == EOF ||
+                fread(&timestamp, sizeof(timestamp), 1, input) != 1 ||
+                fread(&len, sizeof(len), 1, input) != 1 ||
+                len > sizeof(payload) ||
+                fread(payload, 1, len, input) != len) {
+                stat = STATUS_GENERIC_FAILURE;
+                break;
+            }
+
+            format = id == UINT32_MAX ? spare
+                     : id < nformats  ? formats[id]
+                                      : NULL;
+            if (format == NULL) {
+                stat = STATUS_GENERIC_FAILURE;
+                break;
+            }
+
+            b_log_write_record(output, (b_loglevel_t)lvl, timestamp, format,
+                               payload, len);
+        } else {
+            stat = STATUS_GENERIC_FAILURE;
+            break;
+        }
     }
 
-    fprintf(stderr, "%s", logprefix_buf);
-    fprintf(stderr, format, args);
-    putchar('\n');
+    for (size_t i = 0; i < nformats; i++)
+        free(formats[i]);
+    free(formats);
+    free(spare);
+
+    return stat;
 }
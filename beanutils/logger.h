@@ -10,6 +10,17 @@
 
 #pragma once
 
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "common.h"
+
+#define _BEAN_LOG_RING_CAPACITY 4096
+#define _BEAN_LOG_MESSAGE_SIZE  224
+#define _BEAN_LOG_BATCH_SIZE    (64 * 1024)
+#define _BEAN_LOG_MAX_ARGS      16
+
 typedef enum {
     LOGLEVEL_LOG,
     LOGLEVEL_WARN,
@@ -17,7 +28,104 @@ typedef enum {
     LOGLEVEL_FATAL,
 } b_loglevel_t;
 
+/**
+ * What the asynchronous logger does when its ring buffer is full.
+ */
+typedef enum {
+    LOGOVERFLOW_DROP,
+    LOGOVERFLOW_BLOCK,
+} b_logoverflow_t;
+
+/**
+ * How the asynchronous logger writes messages out.
+ *
+ * `LOGFORMAT_BINARY` skips formatting for messages logged through
+ * `B_LOG_DEFERRED`: each is recorded as its format string's id, a timestamp
+ * and the raw argument bytes, and is turned back into text later by
+ * `b_log_decode`. Messages from `b_log` are formatted up front and recorded
+ * as text, since their format string may not outlive the call.
+ */
+typedef enum {
+    LOGFORMAT_TEXT,
+    LOGFORMAT_BINARY,
+} b_logformat_t;
+
+/**
+ * Settings for `b_log_async_start`. Zeroed fields take their defaults.
+ */
+typedef struct {
+    size_t capacity;
+    b_logoverflow_t overflow;
+    b_logformat_t format;
+    FILE* output;
+} BeanLogConfig;
+
+/**
+ * Per-call-site cache of the argument types of a format string, filled in on
+ * first use by `b_log_deferred`.
+ */
+typedef struct {
+    atomic_int ready;
+    unsigned char nargs;
+    unsigned char args[_BEAN_LOG_MAX_ARGS];
+} BeanLogSite;
+
+/**
+ * Logs a message through `b_log_deferred` with a call-site cache, so that in
+ * binary mode the format string is never parsed again. The first argument
+ * after `lvl` has to be a string literal: the drain thread reads it after the
+ * call returns.
+ */
+#define B_LOG_DEFERRED(lvl, ...)                                               \
+    do {                                                                       \
+        static BeanLogSite _b_log_site;                                        \
+        b_log_deferred(&_b_log_site, (lvl), __VA_ARGS__);                      \
+    } while (0)
+
 /**
  * Logs a value to the standard error.
+ *
+ * While the asynchronous logger is running, messages are formatted into its
+ * ring buffer (and truncated to `_BEAN_LOG_MESSAGE_SIZE` bytes) instead.
+ * `LOGLEVEL_FATAL` messages are always written synchronously.
  */
 void b_log(b_loglevel_t lvl, const char* restrict format, ...);
+
+/**
+ * Like `b_log`, but uses `site` to remember how to capture the arguments of
+ * `format` in binary mode. Use it through `B_LOG_DEFERRED`.
+ *
+ *  @param site    Has static storage and is only ever passed with `format`.
+ *  @param format  Has static storage.
+ */
+void b_log_deferred(BeanLogSite* site, b_loglevel_t lvl,
+                    const char* restrict format, ...);
+
+/**
+ * Starts a background thread that drains logged messages from a lock-free
+ * ring buffer and writes them out in large batches.
+ *
+ *  @param config  May be `NULL` to use the defaults.
+ */
+b_errno_t b_log_async_start(const BeanLogConfig* config);
+
+/**
+ * Blocks until every message logged before the call has been written out.
+ */
+b_errno_t b_log_flush(void);
+
+/**
+ * Flushes and stops the asynchronous logger. No thread may be logging while
+ * this runs.
+ */
+b_errno_t b_log_async_stop(void);
+
+/**
+ * Gets the number of messages dropped because the ring buffer was full.
+ */
+size_t b_log_dropped(void);
+
+/**
+ * Turns a stream written in `LOGFORMAT_BINARY` back into text log lines.
+ */
+b_errno_t b_log_decode(FILE* input, FILE* output);
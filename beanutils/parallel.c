@@ -0,0 +1,308 @@
+/* beanutils: Some data structure implementations and utility functions, I
+ * guess.
+ *
+ * Copyright (c) Eason Qin, 2024.
+ *
+ * NOTE: This source code form is licensed under the MIT license and comes
+ * with ABSOLUTELY NO WARRANTY. For more information, please view the
+ * `LICENSE` file at the root of the project.
+ */
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "array.h"
+#include "common.h"
+#include "parallel.h"
+#include "threadpool.h"
+
+typedef struct {
+    const BeanArrayView* view;
+    size_t grain;
+    void* arg;
+    b_elemfn_t elemfn;
+    b_mapfn_t mapfn;
+    b_predfn_t pred;
+    b_foldfn_t fold;
+    void** out;
+    size_t* offsets;
+    unsigned char* flags;
+    unsigned char* partials;
+    size_t accsize;
+    bool negate;
+    atomic_bool failed;
+    atomic_size_t found;
+} BeanParallelCtx;
+
+static inline size_t b_parallel_block_start(const BeanParallelCtx* ctx,
+                                            size_t block) {
+    return block * ctx->grain;
+}
+
+static inline size_t b_parallel_block_finish(const BeanParallelCtx* ctx,
+                                             size_t block) {
+    size_t finish = (block + 1) * ctx->grain;
+    return finish < ctx->view->len ? finish : ctx->view->len;
+}
+
+static inline size_t b_parallel_nblocks(const BeanParallelCtx* ctx) {
+    return (ctx->view->len + ctx->grain - 1) / ctx->grain;
+}
+
+// Runs `fn` over every block. A single block never touches the pool.
+static void b_parallel_blocks(BeanParallelCtx* ctx, b_rangefn_t fn) {
+    size_t nblocks = b_parallel_nblocks(ctx);
+
+    if (nblocks <= 1)
+        fn(0, nblocks, ctx);
+    else
+        b_threadpool_parallel_for(NULL, 0, nblocks, 1, fn, ctx);
+}
+
+static void b_parallel_init(BeanParallelCtx* ctx, const BeanArrayView* view,
+                            void* arg, size_t grain) {
+    *ctx = (BeanParallelCtx){
+        .view = view,
+        .grain = grain != 0 ? grain : _BEAN_PARALLEL_DEFAULT_GRAIN,
+        .arg = arg,
+    };
+
+    atomic_init(&ctx->failed, false);
+    atomic_init(&ctx->found, B_ARRVIEW_NPOS);
+}
+
+static void b_parallel_for_each_blocks(size_t first, size_t last, void* arg) {
+    BeanParallelCtx* ctx = arg;
+
+    for (size_t b = first; b < last; b++) {
+        size_t finish = b_parallel_block_finish(ctx, b);
+
+        for (size_t i = b_parallel_block_start(ctx, b); i < finish; i++)
+            ctx->elemfn(ctx->view->elems[i], ctx->arg);
+    }
+}
+
+b_errno_t b_arrview_for_each(const BeanArrayView* view, b_elemfn_t fn,
+                             void* arg, size_t grain) {
+    BeanParallelCtx ctx;
+
+    b_parallel_init(&ctx, view, arg, grain);
+    ctx.elemfn = fn;
+    b_parallel_blocks(&ctx, b_parallel_for_each_blocks);
+
+    return STATUS_SUCCESS;
+}
+
+static void b_parallel_map_blocks(size_t first, size_t last, void* arg) {
+    BeanParallelCtx* ctx = arg;
+
+    for (size_t b = first; b < last; b++) {
+        size_t finish = b_parallel_block_finish(ctx, b);
+
+        for (size_t i = b_parallel_block_start(ctx, b); i < finish; i++) {
+            ctx->out[i] = ctx->mapfn(ctx->view->elems[i], ctx->arg);
+            if (ctx->out[i] == NULL)
+                atomic_store_explicit(&ctx->failed, true,
+                                      memory_order_relaxed);
+        }
+    }
+}
+
+b_errno_t b_arrview_map(const BeanArrayView* view, BeanArray* out,
+                        b_mapfn_t fn, void* arg, size_t grain) {
+    BeanParallelCtx ctx;
+    b_errno_t stat;
+
+    if (out->cap < out->len + view->len &&
+        (stat = b_array_reserve(out, out->len + view->len)) != STATUS_SUCCESS)
+        return stat;
+
+    b_parallel_init(&ctx, view, arg, grain);
+    ctx.mapfn = fn;
+    ctx.out = &out->data[out->len];
+    b_parallel_blocks(&ctx, b_parallel_map_blocks);
+    out->len += view->len;
+
+    return atomic_load(&ctx.failed) ? STATUS_FAILED_ALLOC : STATUS_SUCCESS;
+}
+
+static void b_parallel_count_blocks(size_t first, size_t last, void* arg) {
+    BeanParallelCtx* ctx = arg;
+
+    for (size_t b = first; b < last; b++) {
+        size_t finish = b_parallel_block_finish(ctx, b);
+        size_t count = 0;
+
+        for (size_t i = b_parallel_block_start(ctx, b); i < finish; i++) {
+            ctx->flags[i] = ctx->pred(ctx->view->elems[i], ctx->arg);
+            count += ctx->flags[i];
+        }
+
+        ctx->offsets[b] = count;
+    }
+}
+
+static void b_parallel_compact_blocks(size_t first, size_t last, void* arg) {
+    BeanParallelCtx* ctx = arg;
+
+    for (size_t b = first; b < last; b++) {
+        size_t finish = b_parallel_block_finish(ctx, b);
+        void** out = &ctx->out[ctx->offsets[b]];
+
+        for (size_t i = b_parallel_block_start(ctx, b); i < finish; i++) {
+            if (ctx->flags[i])
+                *out++ = ctx->view->elems[i];
+        }
+    }
+}
+
+b_errno_t b_arrview_filter(const BeanArrayView* view, BeanArrayView* out,
+                           b_predfn_t pred, void* arg, size_t grain) {
+    BeanParallelCtx ctx;
+    size_t nblocks;
+    size_t total = 0;
+
+    b_parallel_init(&ctx, view, arg, grain);
+    ctx.pred = pred;
+    nblocks = b_parallel_nblocks(&ctx);
+
+    ctx.flags = malloc(view->len > 0 ? view->len : 1);
+    ctx.offsets = malloc((nblocks > 0 ? nblocks : 1) * sizeof(size_t));
+    if (ctx.flags == NULL || ctx.offsets == NULL) {
+        free(ctx.flags);
+        free(ctx.offsets);
+        return STATUS_FAILED_ALLOC;
+    }
+
+    b_parallel_blocks(&ctx, b_parallel_count_blocks);
+
+    // Turn the per-block counts into the offsets each block writes at.
+    for (size_t b = 0; b < nblocks; b++) {
+        size_t count = ctx.offsets[b];
+        ctx.offsets[b] = total;
+        total += count;
+    }
+
+    ctx.out = malloc((total > 0 ? total : 1) * sizeof(void*));
+    if (ctx.out == NULL) {
+        free(ctx.flags);
+        free(ctx.offsets);
+        return STATUS_FAILED_ALLOC;
+    }
+
+    b_parallel_blocks(&ctx, b_parallel_compact_blocks);
+
+    out->elems = ctx.out;
+    out->len = total;
+
+    free(ctx.flags);
+    free(ctx.offsets);
+
+    return STATUS_SUCCESS;
+}
+
+static void b_parallel_reduce_blocks(size_t first, size_t last, void* arg) {
+    BeanParallelCtx* ctx = arg;
+
+    for (size_t b = first; b < last; b++) {
+        size_t finish = b_parallel_block_finish(ctx, b);
+        void* acc = &ctx->partials[b * ctx->accsize];
+
+        for (size_t i = b_parallel_block_start(ctx, b); i < finish; i++)
+            ctx->fold(acc, ctx->view->elems[i], ctx->arg);
+    }
+}
+
+b_errno_t b_arrview_reduce(const BeanArrayView* view, void* acc,
+                           size_t accsize, b_foldfn_t fold,
+                           b_combinefn_t combine, void* arg, size_t grain) {
+    BeanParallelCtx ctx;
+    size_t nblocks;
+
+    b_parallel_init(&ctx, view, arg, grain);
+    nblocks = b_parallel_nblocks(&ctx);
+
+    // A single block can fold straight into `acc`.
+    if (nblocks <= 1) {
+        for (size_t i = 0; i < view->len; i++)
+            fold(acc, view->elems[i], arg);
+        return STATUS_SUCCESS;
+    }
+
+    ctx.fold = fold;
+    ctx.accsize = accsize;
+    ctx.partials = malloc(nblocks * accsize);
+    if (ctx.partials == NULL)
+        return STATUS_FAILED_ALLOC;
+
+    for (size_t b = 0; b < nblocks; b++)
+        memcpy(&ctx.partials[b * accsize], acc, accsize);
+
+    b_parallel_blocks(&ctx, b_parallel_reduce_blocks);
+
+    for (size_t b = 0; b < nblocks; b++)
+        combine(acc, &ctx.partials[b * accsize], arg);
+
+    free(ctx.partials);
+
+    return STATUS_SUCCESS;
+}
+
+static void b_parallel_find_blocks(size_t first, size_t last, void* arg) {
+    BeanParallelCtx* ctx = arg;
+
+    for (size_t b = first; b < last; b++) {
+        size_t start = b_parallel_block_start(ctx, b);
+        size_t finish = b_parallel_block_finish(ctx, b);
+        size_t best =
+            atomic_load_explicit(&ctx->found, memory_order_relaxed);
+
+        // Nothing in this block can beat a match found further left.
+        if (start >= best)
+            return;
+
+        for (size_t i = start; i < finish; i++) {
+            if (ctx->pred(ctx->view->elems[i], ctx->arg) == ctx->negate)
+                continue;
+
+            while (i < best && !atomic_compare_exchange_weak_explicit(
+                                   &ctx->found, &best, i,
+                                   memory_order_relaxed, memory_order_relaxed))
+                ;
+            return;
+        }
+    }
+}
+
+size_t b_arrview_find(const BeanArrayView* view, b_predfn_t pred, void* arg,
+                      size_t grain) {
+    BeanParallelCtx ctx;
+
+    b_parallel_init(&ctx, view, arg, grain);
+    ctx.pred = pred;
+    b_parallel_blocks(&ctx, b_parallel_find_blocks);
+
+    return atomic_load(&ctx.found);
+}
+
+bool b_arrview_any(const BeanArrayView* view, b_predfn_t pred, void* arg,
+                   size_t grain) {
+    return b_arrview_find(view, pred, arg, grain) != B_ARRVIEW_NPOS;
+}
+
+bool b_arrview_all(const BeanArrayView* view, b_predfn_t pred, void* arg,
+                   size_t grain) {
+    BeanParallelCtx ctx;
+
+    // Look for the first element that does not satisfy `pred`.
+    b_parallel_init(&ctx, view, arg, grain);
+    ctx.pred = pred;
+    ctx.negate = true;
+    b_parallel_blocks(&ctx, b_parallel_find_blocks);
+
+    return atomic_load(&ctx.found) == B_ARRVIEW_NPOS;
+}
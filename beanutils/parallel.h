@@ -0,0 +1,111 @@
+/* beanutils: Some data structure implementations and utility functions, I
+ * guess.
+ *
+ * Copyright (c) Eason Qin, 2024.
+ *
+ * NOTE: This source code form is licensed under the MIT license and comes
+ * with ABSOLUTELY NO WARRANTY. For more information, please view the
+ * `LICENSE` file at the root of the project.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "array.h"
+#include "common.h"
+
+#define _BEAN_PARALLEL_DEFAULT_GRAIN 4096
+#define B_ARRVIEW_NPOS SIZE_MAX
+
+/*
+ * Data-parallel algorithms over a `BeanArrayView`. Every function splits the
+ * view into blocks of `grain` elements (or `_BEAN_PARALLEL_DEFAULT_GRAIN` if
+ * `grain` is 0) and runs them on the default `BeanThreadPool`. Views of at
+ * most one block are processed inline on the calling thread.
+ */
+
+/**
+ * Visits one element.
+ */
+typedef void (*b_elemfn_t)(void* elem, void* arg);
+
+/**
+ * Produces a new element from an existing one, or `NULL` on failure.
+ */
+typedef void* (*b_mapfn_t)(const void* elem, void* arg);
+
+/**
+ * Tests one element.
+ */
+typedef bool (*b_predfn_t)(const void* elem, void* arg);
+
+/**
+ * Folds one element into an accumulator.
+ */
+typedef void (*b_foldfn_t)(void* acc, const void* elem, void* arg);
+
+/**
+ * Folds the accumulator `partial` into `acc`. This must be associative.
+ */
+typedef void (*b_combinefn_t)(void* acc, const void* partial, void* arg);
+
+/**
+ * Calls `fn` on every element of a `BeanArrayView`, in no particular order.
+ */
+b_errno_t b_arrview_for_each(const BeanArrayView* view, b_elemfn_t fn,
+                             void* arg, size_t grain);
+
+/**
+ * Pushes `fn(elem)` for every element of a `BeanArrayView` onto `out`, in
+ * order. `out` takes ownership of the new elements.
+ *
+ * @return `STATUS_FAILED_ALLOC` if `fn` returned `NULL` for any element. The
+ *         `NULL`s are still pushed, so `out` can be deinitialized as usual.
+ */
+b_errno_t b_arrview_map(const BeanArrayView* view, BeanArray* out,
+                        b_mapfn_t fn, void* arg, size_t grain);
+
+/**
+ * Collects the elements of a `BeanArrayView` that satisfy `pred`, keeping
+ * their order. Matches are counted per block, and a prefix sum of the counts
+ * gives each block the offset it writes to.
+ *
+ *  @param out  Set to a view of the matches. Its `elems` buffer is allocated
+ *              with `malloc` and must be freed by the caller.
+ */
+b_errno_t b_arrview_filter(const BeanArrayView* view, BeanArrayView* out,
+                           b_predfn_t pred, void* arg, size_t grain);
+
+/**
+ * Folds every element of a `BeanArrayView` into `acc`. Each block starts
+ * from a copy of the initial `acc`, so it must hold the identity of
+ * `combine`, and the block results are combined in order.
+ *
+ *  @param accsize  The size of the accumulator in bytes.
+ */
+b_errno_t b_arrview_reduce(const BeanArrayView* view, void* acc,
+                           size_t accsize, b_foldfn_t fold,
+                           b_combinefn_t combine, void* arg, size_t grain);
+
+/**
+ * Finds the first element of a `BeanArrayView` that satisfies `pred`. Blocks
+ * past the best match found so far are skipped.
+ *
+ * @return Its index, or `B_ARRVIEW_NPOS`.
+ */
+size_t b_arrview_find(const BeanArrayView* view, b_predfn_t pred, void* arg,
+                      size_t grain);
+
+/**
+ * Checks if any element of a `BeanArrayView` satisfies `pred`.
+ */
+bool b_arrview_any(const BeanArrayView* view, b_predfn_t pred, void* arg,
+                   size_t grain);
+
+/**
+ * Checks if every element of a `BeanArrayView` satisfies `pred`.
+ */
+bool b_arrview_all(const BeanArrayView* view, b_predfn_t pred, void* arg,
+                   size_t grain);
@@ -0,0 +1,113 @@
+/* beanutils: Some data structure implementations and utility functions, I
+ * guess.
+ *
+ * Copyright (c) Eason Qin, 2024.
+ *
+ * NOTE: This source code form is licensed under the MIT license and comes
+ * with ABSOLUTELY NO WARRANTY. For more information, please view the
+ * `LICENSE` file at the root of the project.
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+
+#include "common.h"
+#include "pool.h"
+
+#define _BEAN_POOL_ALIGNMENT _Alignof(max_align_t)
+
+struct BeanPoolSlab {
+    BeanPoolSlab* next;
+    size_t used;
+    _Alignas(max_align_t) unsigned char data[];
+};
+
+b_errno_t b_pool_init(BeanPool* pool, size_t elemsize) {
+    if (elemsize == 0)
+        return STATUS_INVALID_OPERATION;
+
+    // Every free block has to be able to hold the free list link.
+    if (elemsize < sizeof(void*))
+        elemsize = sizeof(void*);
+    elemsize = (elemsize + _BEAN_POOL_ALIGNMENT - 1) &
+               ~(_BEAN_POOL_ALIGNMENT - 1);
+
+    *pool = (BeanPool){
+        .slabs = NULL,
+        .freelist = NULL,
+        .elemsize = elemsize,
+        .perslab = _BEAN_POOL_SLAB_SIZE / elemsize,
+        .allocator = b_allocator_get(),
+    };
+
+    if (pool->perslab == 0)
+        pool->perslab = 1;
+
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_pool_deinit(BeanPool* pool) {
+    BeanPoolSlab* slab = pool->slabs;
+
+    if (pool->elemsize == 0)
+        return STATUS_INVALID_OPERATION;
+
+    while (slab != NULL) {
+        BeanPoolSlab* next = slab->next;
+        b_free(pool->allocator, slab, ALLOCTAG_POOL);
+        slab = next;
+    }
+
+    *pool = (BeanPool){0};
+
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_pool_set_allocator(BeanPool* pool, const BeanAllocator* allocator) {
+    if (pool->slabs != NULL)
+        return STATUS_INVALID_OPERATION;
+
+    pool->allocator = allocator != NULL ? allocator : b_allocator_get();
+
+    return STATUS_SUCCESS;
+}
+
+void* b_pool_alloc(BeanPool* pool) {
+    BeanPoolSlab* slab = pool->slabs;
+    void* res;
+
+    if (pool->freelist != NULL) {
+        res = pool->freelist;
+        pool->freelist = *(void**)res;
+        return res;
+    }
+
+    if (pool->elemsize == 0)
+        return NULL;
+
+    // Blocks are carved out of the newest slab lazily, so a fresh slab never
+    // has to be threaded onto the free list up front.
+    if (slab == NULL || slab->used == pool->perslab) {
+        slab = b_alloc(pool->allocator,
+                       sizeof(BeanPoolSlab) + pool->perslab * pool->elemsize,
+                       ALLOCTAG_POOL);
+        if (slab == NULL)
+            return NULL;
+
+        slab->next = pool->slabs;
+        slab->used = 0;
+        pool->slabs = slab;
+    }
+
+    res = &slab->data[slab->used++ * pool->elemsize];
+
+    return res;
+}
+
+void b_pool_free(BeanPool* pool, void* elem) {
+    if (elem == NULL)
+        return;
+
+    *(void**)elem = pool->freelist;
+    pool->freelist = elem;
+}
@@ -0,0 +1,61 @@
+/* beanutils: Some data structure implementations and utility functions, I
+ * guess.
+ *
+ * Copyright (c) Eason Qin, 2024.
+ *
+ * NOTE: This source code form is licensed under the MIT license and comes
+ * with ABSOLUTELY NO WARRANTY. For more information, please view the
+ * `LICENSE` file at the root of the project.
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#include "alloc.h"
+#include "common.h"
+
+#define _BEAN_POOL_SLAB_SIZE (64 * 1024)
+
+typedef struct BeanPoolSlab BeanPoolSlab;
+
+/**
+ * A pool of fixed-size blocks carved out of large slabs. Freed blocks go onto
+ * a free list and are handed out again before any new slab is allocated.
+ *
+ * Slabs come from `allocator`, the global allocator at initialization unless
+ * changed with `b_pool_set_allocator`.
+ */
+typedef struct {
+    BeanPoolSlab* slabs;
+    void* freelist;
+    size_t elemsize;
+    size_t perslab;
+    const BeanAllocator* allocator;
+} BeanPool;
+
+/**
+ * Initializes a new `BeanPool` handing out blocks of `elemsize` bytes.
+ */
+b_errno_t b_pool_init(BeanPool* pool, size_t elemsize);
+
+/**
+ * Frees every slab owned by a `BeanPool`, including blocks still in use.
+ */
+b_errno_t b_pool_deinit(BeanPool* pool);
+
+/**
+ * Makes a `BeanPool` that owns no slabs allocate them from `allocator`, or
+ * from the global allocator if it is `NULL`.
+ */
+b_errno_t b_pool_set_allocator(BeanPool* pool, const BeanAllocator* allocator);
+
+/**
+ * Takes one block from a `BeanPool`. Returns `NULL` on failure.
+ */
+void* b_pool_alloc(BeanPool* pool);
+
+/**
+ * Returns a block to the `BeanPool` it was allocated from.
+ */
+void b_pool_free(BeanPool* pool, void* elem);
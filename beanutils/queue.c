@@ -0,0 +1,399 @@
+/* beanutils: Some data structure implementations and utility functions, I
+ * guess.
+ *
+ * Copyright (c) Eason Qin, 2024.
+ *
+ * NOTE: This source code form is licensed under the MIT license and comes
+ * with ABSOLUTELY NO WARRANTY. For more information, please view the
+ * `LICENSE` file at the root of the project.
+ */
+
+#include <limits.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <pthread.h>
+#endif
+
+#include "common.h"
+#include "queue.h"
+
+struct BeanQueueCell {
+    _Alignas(_BEAN_QUEUE_CACHE_LINE) atomic_size_t seq;
+    void* data;
+};
+
+#ifdef __linux__
+static void b_futex_wait(atomic_uint* addr, unsigned int expected) {
+    syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0);
+}
+
+static void b_futex_wake(atomic_uint* addr, int count) {
+    syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+}
+#else
+// Without futexes every waiter shares one condition variable, and every
+// wakeup is a broadcast.
+static pthread_mutex_t b_futex_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t b_futex_cond = PTHREAD_COND_INITIALIZER;
+
+static void b_futex_wait(atomic_uint* addr, unsigned int expected) {
+    pthread_mutex_lock(&b_futex_lock);
+    if (atomic_load(addr) == expected)
+        pthread_cond_wait(&b_futex_cond, &b_futex_lock);
+    pthread_mutex_unlock(&b_futex_lock);
+}
+
+static void b_futex_wake(atomic_uint* addr, int count) {
+    (void)addr;
+    (void)count;
+
+    pthread_mutex_lock(&b_futex_lock);
+    pthread_cond_broadcast(&b_futex_cond);
+    pthread_mutex_unlock(&b_futex_lock);
+}
+#endif
+
+static size_t b_queue_round_cap(size_t cap) {
+    size_t res = 2;
+
+    while (res < cap)
+        res *= 2;
+
+    return res;
+}
+
+b_errno_t b_queue_init(BeanQueue* queue, size_t cap) {
+    cap = b_queue_round_cap(cap);
+
+    queue->allocator = b_allocator_get();
+    queue->cells = b_alloc_aligned(queue->allocator,
+                                   cap * sizeof(BeanQueueCell),
+                                   _Alignof(BeanQueueCell), ALLOCTAG_QUEUE);
+    if (queue->cells == NULL)
+        return STATUS_FAILED_ALLOC;
+
+    for (size_t i = 0; i < cap; i++)
+        atomic_init(&queue->cells[i].seq, i);
+
+    queue->mask = cap - 1;
+    atomic_init(&queue->head, 0);
+    atomic_init(&queue->tail, 0);
+
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_queue_deinit(BeanQueue* queue) {
+    if (queue->cells == NULL)
+        return STATUS_INVALID_OPERATION;
+
+    b_free_aligned(queue->allocator, queue->cells, ALLOCTAG_QUEUE);
+    queue->cells = NULL;
+
+    return STATUS_SUCCESS;
+}
+
+// A cell is free for the producer of position `pos` once its sequence
+// number reaches `pos`, and holds that producer's element once it reaches
+// `pos + 1`. Consumers hand it to the next lap by setting `pos + cap`.
+size_t b_queue_push_many(BeanQueue* queue, void* const* elems, size_t count) {
+    size_t pos = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    size_t n;
+
+    // An empty scan would look like losing a race and retry forever.
+    if (count == 0)
+        return 0;
+
+    for (;;) {
+        for (n = 0; n < count; n++) {
+            BeanQueueCell* cell = &queue->cells[(pos + n) & queue->mask];
+            size_t seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)(pos + n);
+
+            if (diff == 0)
+                continue;
+
+            // The queue is full, unless another producer got here first.
+            if (n == 0 && diff < 0)
+                return 0;
+            break;
+        }
+
+        if (n == 0) {
+            pos = atomic_load_explicit(&queue->head, memory_order_relaxed);
+            continue;
+        }
+
+        if (atomic_compare_exchange_weak_explicit(&queue->head, &pos, pos + n,
+                                                  memory_order_relaxed,
+                                                  memory_order_relaxed))
+            break;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        BeanQueueCell* cell = &queue->cells[(pos + i) & queue->mask];
+
+        cell->data = elems[i];
+        atomic_store_explicit(&cell->seq, pos + i + 1, memory_order_release);
+    }
+
+    return n;
+}
+
+size_t b_queue_pop_many(BeanQueue* queue, void** elems, size_t count) {
+    size_t pos = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    size_t n;
+
+    if (count == 0)
+        return 0;
+
+    for (;;) {
+        for (n = 0; n < count; n++) {
+            BeanQueueCell* cell = &queue->cells[(pos + n) & queue->mask];
+            size_t seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)(pos + n + 1);
+
+            if (diff == 0)
+                continue;
+
+            // The queue is empty, unless another consumer got here first.
+            if (n == 0 && diff < 0)
+                return 0;
+            break;
+        }
+
+        if (n == 0) {
+            pos = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+            continue;
+        }
+
+        if (atomic_compare_exchange_weak_explicit(&queue->tail, &pos, pos + n,
+                                                  memory_order_relaxed,
+                                                  memory_order_relaxed))
+            break;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        BeanQueueCell* cell = &queue->cells[(pos + i) & queue->mask];
+
+        elems[i] = cell->data;
+        atomic_store_explicit(&cell->seq, pos + i + queue->mask + 1,
+                              memory_order_release);
+    }
+
+    return n;
+}
+
+bool b_queue_push(BeanQueue* queue, void* elem) {
+    return b_queue_push_many(queue, &elem, 1) == 1;
+}
+
+bool b_queue_pop(BeanQueue* queue, void** elem) {
+    return b_queue_pop_many(queue, elem, 1) == 1;
+}
+
+b_errno_t b_ring_init(BeanRing* ring, size_t cap) {
+    cap = b_queue_round_cap(cap);
+
+    ring->allocator = b_allocator_get();
+    ring->slots = b_alloc(ring->allocator, cap * sizeof(void*), ALLOCTAG_QUEUE);
+    if (ring->slots == NULL)
+        return STATUS_FAILED_ALLOC;
+
+    ring->mask = cap - 1;
+    ring->cached_tail = 0;
+    ring->cached_head = 0;
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_ring_deinit(BeanRing* ring) {
+    if (ring->slots == NULL)
+        return STATUS_INVALID_OPERATION;
+
+    b_free(ring->allocator, ring->slots, ALLOCTAG_QUEUE);
+    ring->slots = NULL;
+
+    return STATUS_SUCCESS;
+}
+
+size_t b_ring_push_many(BeanRing* ring, void* const* elems, size_t count) {
+    size_t cap = ring->mask + 1;
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    size_t space = cap - (head - ring->cached_tail);
+    size_t first;
+
+    if (space < count) {
+        ring->cached_tail =
+            atomic_load_explicit(&ring->tail, memory_order_acquire);
+        space = cap - (head - ring->cached_tail);
+    }
+
+    if (count > space)
+        count = space;
+    if (count == 0)
+        return 0;
+
+    first = cap - (head & ring->mask);
+    if (first > count)
+        first = count;
+
+    memcpy(&ring->slots[head & ring->mask], elems, first * sizeof(void*));
+    memcpy(ring->slots, elems + first, (count - first) * sizeof(void*));
+    atomic_store_explicit(&ring->head, head + count, memory_order_release);
+
+    return count;
+}
+
+size_t b_ring_pop_many(BeanRing* ring, void** elems, size_t count) {
+    size_t cap = ring->mask + 1;
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    size_t avail = ring->cached_head - tail;
+    size_t first;
+
+    if (avail < count) {
+        ring->cached_head =
+            atomic_load_explicit(&ring->head, memory_order_acquire);
+        avail = ring->cached_head - tail;
+    }
+
+    if (count > avail)
+        count = avail;
+    if (count == 0)
+        return 0;
+
+    first = cap - (tail & ring->mask);
+    if (first > count)
+        first = count;
+
+    memcpy(elems, &ring->slots[tail & ring->mask], first * sizeof(void*));
+    memcpy(elems + first, ring->slots, (count - first) * sizeof(void*));
+    atomic_store_explicit(&ring->tail, tail + count, memory_order_release);
+
+    return count;
+}
+
+bool b_ring_push(BeanRing* ring, void* elem) {
+    return b_ring_push_many(ring, &elem, 1) == 1;
+}
+
+bool b_ring_pop(BeanRing* ring, void** elem) {
+    return b_ring_pop_many(ring, elem, 1) == 1;
+}
+
+b_errno_t b_bqueue_init(BeanBlockingQueue* bqueue, size_t cap) {
+    atomic_init(&bqueue->not_empty, 0);
+    atomic_init(&bqueue->not_full, 0);
+    atomic_init(&bqueue->waiting_consumers, 0);
+    atomic_init(&bqueue->waiting_producers, 0);
+    atomic_init(&bqueue->closed, false);
+
+    return b_queue_init(&bqueue->queue, cap);
+}
+
+b_errno_t b_bqueue_deinit(BeanBlockingQueue* bqueue) {
+    return b_queue_deinit(&bqueue->queue);
+}
+
+// Wakes one thread sleeping on `epoch`, if there is any. The fence pairs
+// with the one in the waiters: either the waiter sees the change that was
+// just made to the queue, or this sees the waiter.
+static void b_bqueue_notify(atomic_uint* epoch, atomic_uint* waiting) {
+    atomic_thread_fence(memory_order_seq_cst);
+
+    if (atomic_load_explicit(waiting, memory_order_relaxed) > 0) {
+        atomic_fetch_add(epoch, 1);
+        b_futex_wake(epoch, 1);
+    }
+}
+
+bool b_bqueue_push(BeanBlockingQueue* bqueue, void* elem) {
+    for (;;) {
+        unsigned int epoch;
+        bool pushed = false;
+
+        for (int i = 0; i < _BEAN_QUEUE_SPIN_ROUNDS && !pushed; i++) {
+            if (atomic_load(&bqueue->closed))
+                return false;
+            pushed = b_queue_push(&bqueue->queue, elem);
+        }
+
+        if (!pushed) {
+            epoch = atomic_load(&bqueue->not_full);
+            atomic_fetch_add(&bqueue->waiting_producers, 1);
+            atomic_thread_fence(memory_order_seq_cst);
+
+            pushed = b_queue_push(&bqueue->queue, elem);
+            if (!pushed && !atomic_load(&bqueue->closed))
+                b_futex_wait(&bqueue->not_full, epoch);
+            atomic_fetch_sub(&bqueue->waiting_producers, 1);
+        }
+
+        if (pushed) {
+            b_bqueue_notify(&bqueue->not_empty, &bqueue->waiting_consumers);
+            return true;
+        }
+    }
+}
+
+size_t b_bqueue_pop_many(BeanBlockingQueue* bqueue, void** elems,
+                         size_t count) {
+    // Nothing to wait for.
+    if (count == 0)
+        return 0;
+
+    for (;;) {
+        unsigned int epoch;
+        size_t n = 0;
+
+        for (int i = 0; i < _BEAN_QUEUE_SPIN_ROUNDS && n == 0; i++)
+            n = b_queue_pop_many(&bqueue->queue, elems, count);
+
+        if (n == 0) {
+            // `closed` is read before the final pop, so nothing pushed
+            // before the close can be missed.
+            bool closed = atomic_load(&bqueue->closed);
+
+            epoch = atomic_load(&bqueue->not_empty);
+            atomic_fetch_add(&bqueue->waiting_consumers, 1);
+            atomic_thread_fence(memory_order_seq_cst);
+
+            n = b_queue_pop_many(&bqueue->queue, elems, count);
+            if (n == 0 && !closed && !atomic_load(&bqueue->closed))
+                b_futex_wait(&bqueue->not_empty, epoch);
+            atomic_fetch_sub(&bqueue->waiting_consumers, 1);
+
+            if (n == 0 && closed)
+                return 0;
+        }
+
+        if (n > 0) {
+            b_bqueue_notify(&bqueue->not_full, &bqueue->waiting_producers);
+            return n;
+        }
+    }
+}
+
+bool b_bqueue_pop(BeanBlockingQueue* bqueue, void** elem) {
+    return b_bqueue_pop_many(bqueue, elem, 1) == 1;
+}
+
+void b_bqueue_close(BeanBlockingQueue* bqueue) {
+    atomic_store(&bqueue->closed, true);
+
+    atomic_fetch_add(&bqueue->not_empty, 1);
+    atomic_fetch_add(&bqueue->not_full, 1);
+    b_futex_wake(&bqueue->not_empty, INT_MAX);
+    b_futex_wake(&bqueue->not_full, INT_MAX);
+}
@@ -0,0 +1,183 @@
+/* beanutils: Some data structure implementations and utility functions, I
+ * guess.
+ *
+ * Copyright (c) Eason Qin, 2024.
+ *
+ * NOTE: This source code form is licensed under the MIT license and comes
+ * with ABSOLUTELY NO WARRANTY. For more information, please view the
+ * `LICENSE` file at the root of the project.
+ */
+
+#pragma once
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "alloc.h"
+#include "common.h"
+
+#define _BEAN_QUEUE_CACHE_LINE 64
+#define _BEAN_QUEUE_SPIN_ROUNDS 128
+
+typedef struct BeanQueueCell BeanQueueCell;
+
+/**
+ * A bounded lock-free queue of pointers for any number of producers and
+ * consumers (Vyukov's design). Every slot carries a sequence number that
+ * tells producers and consumers whose turn it is, and sits on its own cache
+ * line.
+ */
+typedef struct {
+    BeanQueueCell* cells;
+    size_t mask;
+    const BeanAllocator* allocator;
+    _Alignas(_BEAN_QUEUE_CACHE_LINE) atomic_size_t head;
+    _Alignas(_BEAN_QUEUE_CACHE_LINE) atomic_size_t tail;
+} BeanQueue;
+
+/**
+ * A bounded lock-free ring of pointers for exactly one producer and one
+ * consumer. Each side caches the other's index and only rereads it when the
+ * ring looks full or empty.
+ */
+typedef struct {
+    void** slots;
+    size_t mask;
+    const BeanAllocator* allocator;
+    _Alignas(_BEAN_QUEUE_CACHE_LINE) atomic_size_t head;
+    size_t cached_tail;
+    _Alignas(_BEAN_QUEUE_CACHE_LINE) atomic_size_t tail;
+    size_t cached_head;
+} BeanRing;
+
+/**
+ * A `BeanQueue` whose producers and consumers sleep when it is full or
+ * empty, on a futex on Linux and a condition variable elsewhere.
+ */
+typedef struct {
+    BeanQueue queue;
+    atomic_uint not_empty;
+    atomic_uint not_full;
+    atomic_uint waiting_consumers;
+    atomic_uint waiting_producers;
+    atomic_bool closed;
+} BeanBlockingQueue;
+
+/**
+ * Initializes a new `BeanQueue` holding up to `cap` elements, rounded up to
+ * a power of two.
+ */
+b_errno_t b_queue_init(BeanQueue* queue, size_t cap);
+
+/**
+ * Frees a `BeanQueue`. Elements still in it are not freed.
+ */
+b_errno_t b_queue_deinit(BeanQueue* queue);
+
+/**
+ * Adds an element to a `BeanQueue`.
+ *
+ * @return `false` if the queue is full.
+ */
+bool b_queue_push(BeanQueue* queue, void* elem);
+
+/**
+ * Takes the oldest element off a `BeanQueue`.
+ *
+ * @return `false` if the queue is empty.
+ */
+bool b_queue_pop(BeanQueue* queue, void** elem);
+
+/**
+ * Adds up to `count` elements to a `BeanQueue` with a single claim.
+ *
+ * @return The number of elements added, from the start of `elems`.
+ */
+size_t b_queue_push_many(BeanQueue* queue, void* const* elems, size_t count);
+
+/**
+ * Takes up to `count` elements off a `BeanQueue` with a single claim.
+ *
+ * @return The number of elements taken.
+ */
+size_t b_queue_pop_many(BeanQueue* queue, void** elems, size_t count);
+
+/**
+ * Initializes a new `BeanRing` holding up to `cap` elements, rounded up to a
+ * power of two.
+ */
+b_errno_t b_ring_init(BeanRing* ring, size_t cap);
+
+/**
+ * Frees a `BeanRing`. Elements still in it are not freed.
+ */
+b_errno_t b_ring_deinit(BeanRing* ring);
+
+/**
+ * Adds an element to a `BeanRing`. Only the producer thread may call this.
+ *
+ * @return `false` if the ring is full.
+ */
+bool b_ring_push(BeanRing* ring, void* elem);
+
+/**
+ * Takes the oldest element off a `BeanRing`. Only the consumer thread may
+ * call this.
+ *
+ * @return `false` if the ring is empty.
+ */
+bool b_ring_pop(BeanRing* ring, void** elem);
+
+/**
+ * Adds up to `count` elements to a `BeanRing`.
+ *
+ * @return The number of elements added.
+ */
+size_t b_ring_push_many(BeanRing* ring, void* const* elems, size_t count);
+
+/**
+ * Takes up to `count` elements off a `BeanRing`.
+ *
+ * @return The number of elements taken.
+ */
+size_t b_ring_pop_many(BeanRing* ring, void** elems, size_t count);
+
+/**
+ * Initializes a new `BeanBlockingQueue` holding up to `cap` elements.
+ */
+b_errno_t b_bqueue_init(BeanBlockingQueue* bqueue, size_t cap);
+
+/**
+ * Frees a `BeanBlockingQueue`. No thread may be waiting on it.
+ */
+b_errno_t b_bqueue_deinit(BeanBlockingQueue* bqueue);
+
+/**
+ * Adds an element, sleeping while the queue is full.
+ *
+ * @return `false` if the queue has been closed.
+ */
+bool b_bqueue_push(BeanBlockingQueue* bqueue, void* elem);
+
+/**
+ * Takes the oldest element, sleeping while the queue is empty.
+ *
+ * @return `false` once the queue has been closed and drained.
+ */
+bool b_bqueue_pop(BeanBlockingQueue* bqueue, void** elem);
+
+/**
+ * Takes between 1 and `count` elements, sleeping while the queue is empty.
+ *
+ * @return The number of elements taken, or 0 once the queue has been closed
+ *         and drained.
+ */
+size_t b_bqueue_pop_many(BeanBlockingQueue* bqueue, void** elems,
+                         size_t count);
+
+/**
+ * Closes a `BeanBlockingQueue`, waking every waiting thread. Elements still
+ * in the queue can be popped; nothing more can be pushed.
+ */
+void b_bqueue_close(BeanBlockingQueue* bqueue);
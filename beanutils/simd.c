@@ -0,0 +1,313 @@
+/* beanutils: Some data structure implementations and utility functions, I
+ * guess.
+ *
+ * Copyright (c) Eason Qin, 2024.
+ *
+ * NOTE: This source code form is licensed under the MIT license and comes
+ * with ABSOLUTELY NO WARRANTY. For more information, please view the
+ * `LICENSE` file at the root of the project.
+ */
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "simd.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define _BEAN_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+static atomic_int b_simd_current = -1;
+
+static b_simdlevel_t b_simd_detect(void) {
+#ifdef _BEAN_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return SIMDLEVEL_AVX2;
+
+    // SSE2 is part of the x86-64 baseline.
+    return SIMDLEVEL_SSE2;
+#else
+    return SIMDLEVEL_SCALAR;
+#endif
+}
+
+b_simdlevel_t b_simd_level(void) {
+    int level = atomic_load_explicit(&b_simd_current, memory_order_relaxed);
+
+    if (level < 0) {
+        level = (int)b_simd_detect();
+        atomic_store_explicit(&b_simd_current, level, memory_order_relaxed);
+    }
+
+    return (b_simdlevel_t)level;
+}
+
+void b_simd_set_level(b_simdlevel_t level) {
+    b_simdlevel_t supported = b_simd_detect();
+
+    if (level > supported)
+        level = supported;
+
+    atomic_store_explicit(&b_simd_current, (int)level, memory_order_relaxed);
+}
+
+static size_t b_simd_count_byte_scalar(const char* data, size_t len,
+                                       char byte) {
+    size_t count = 0;
+
+    for (size_t i = 0; i < len; i++)
+        count += data[i] == byte;
+
+    return count;
+}
+
+static const char* b_simd_find_scalar(const char* haystack, size_t haylen,
+                                      const char* needle, size_t needlelen) {
+    const char* curr = haystack;
+    const char* last;
+
+    if (needlelen > haylen)
+        return NULL;
+
+    last = haystack + haylen - needlelen;
+    while (curr <= last &&
+           (curr = memchr(curr, needle[0], (size_t)(last - curr) + 1)) !=
+               NULL) {
+        if (memcmp(curr + 1, needle + 1, needlelen - 1) == 0)
+            return curr;
+        curr++;
+    }
+
+    return NULL;
+}
+
+#ifdef _BEAN_SIMD_X86
+
+static const char* b_simd_find_byte_sse2(const char* data, size_t len,
+                                         char byte) {
+    __m128i target = _mm_set1_epi8(byte);
+    size_t i = 0;
+
+    for (; i + 16 <= len; i += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)&data[i]);
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, target));
+
+        if (mask != 0)
+            return &data[i + (size_t)__builtin_ctz((unsigned)mask)];
+    }
+
+    return memchr(&data[i], byte, len - i);
+}
+
+__attribute__((target("avx2"))) static const char*
+b_simd_find_byte_avx2(const char* data, size_t len, char byte) {
+    __m256i target = _mm256_set1_epi8(byte);
+    size_t i = 0;
+
+    for (; i + 32 <= len; i += 32) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i*)&data[i]);
+        unsigned mask = (unsigned)_mm256_movemask_epi8(
+            _mm256_cmpeq_epi8(chunk, target));
+
+        if (mask != 0)
+            return &data[i + (size_t)__builtin_ctz(mask)];
+    }
+
+    return b_simd_find_byte_sse2(&data[i], len - i, byte);
+}
+
+static size_t b_simd_count_byte_sse2(const char* data, size_t len,
+                                     char byte) {
+    __m128i target = _mm_set1_epi8(byte);
+    size_t count = 0;
+    size_t i = 0;
+
+    for (; i + 16 <= len; i += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)&data[i]);
+        unsigned mask =
+            (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, target));
+
+        count += (size_t)__builtin_popcount(mask);
+    }
+
+    return count + b_simd_count_byte_scalar(&data[i], len - i, byte);
+}
+
+__attribute__((target("avx2,popcnt"))) static size_t
+b_simd_count_byte_avx2(const char* data, size_t len, char byte) {
+    __m256i target = _mm256_set1_epi8(byte);
+    size_t count = 0;
+    size_t i = 0;
+
+    for (; i + 32 <= len; i += 32) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i*)&data[i]);
+        unsigned mask = (unsigned)_mm256_movemask_epi8(
+            _mm256_cmpeq_epi8(chunk, target));
+
+        count += (size_t)__builtin_popcount(mask);
+    }
+
+    return count + b_simd_count_byte_sse2(&data[i], len - i, byte);
+}
+
+static bool b_simd_equal_sse2(const char* lhs, const char* rhs, size_t len) {
+    size_t i = 0;
+
+    for (; i + 16 <= len; i += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i*)&lhs[i]);
+        __m128i b = _mm_loadu_si128((const __m128i*)&rhs[i]);
+
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) != 0xffff)
+            return false;
+    }
+
+    return memcmp(&lhs[i], &rhs[i], len - i) == 0;
+}
+
+__attribute__((target("avx2"))) static bool
+b_simd_equal_avx2(const char* lhs, const char* rhs, size_t len) {
+    size_t i = 0;
+
+    for (; i + 32 <= len; i += 32) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)&lhs[i]);
+        __m256i b = _mm256_loadu_si256((const __m256i*)&rhs[i]);
+
+        if ((unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)) !=
+            0xffffffffu)
+            return false;
+    }
+
+    return b_simd_equal_sse2(&lhs[i], &rhs[i], len - i);
+}
+
+// Substring search compares whole blocks of candidate positions against the
+// first and last byte of the needle at once, and only runs `memcmp` where
+// both match.
+
+static const char* b_simd_find_sse2(const char* haystack, size_t haylen,
+                                    const char* needle, size_t needlelen) {
+    __m128i first = _mm_set1_epi8(needle[0]);
+    __m128i last = _mm_set1_epi8(needle[needlelen - 1]);
+    size_t i = 0;
+
+    for (; i + needlelen - 1 + 16 <= haylen; i += 16) {
+        __m128i blockfirst = _mm_loadu_si128((const __m128i*)&haystack[i]);
+        __m128i blocklast =
+            _mm_loadu_si128((const __m128i*)&haystack[i + needlelen - 1]);
+        unsigned mask = (unsigned)_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(blockfirst, first),
+                          _mm_cmpeq_epi8(blocklast, last)));
+
+        while (mask != 0) {
+            size_t pos = i + (size_t)__builtin_ctz(mask);
+
+            if (memcmp(&haystack[pos + 1], needle + 1, needlelen - 2) == 0)
+                return &haystack[pos];
+            mask &= mask - 1;
+        }
+    }
+
+    return b_simd_find_scalar(&haystack[i], haylen - i, needle, needlelen);
+}
+
+__attribute__((target("avx2"))) static const char*
+b_simd_find_avx2(const char* haystack, size_t haylen, const char* needle,
+                 size_t needlelen) {
+    __m256i first = _mm256_set1_epi8(needle[0]);
+    __m256i last = _mm256_set1_epi8(needle[needlelen - 1]);
+    size_t i = 0;
+
+    for (; i + needlelen - 1 + 32 <= haylen; i += 32) {
+        __m256i blockfirst =
+            _mm256_loadu_si256((const __m256i*)&haystack[i]);
+        __m256i blocklast =
+            _mm256_loadu_si256((const __m256i*)&haystack[i + needlelen - 1]);
+        unsigned mask = (unsigned)_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(blockfirst, first),
+                             _mm256_cmpeq_epi8(blocklast, last)));
+
+        while (mask != 0) {
+            size_t pos = i + (size_t)__builtin_ctz(mask);
+
+            if (memcmp(&haystack[pos + 1], needle + 1, needlelen - 2) == 0)
+                return &haystack[pos];
+            mask &= mask - 1;
+        }
+    }
+
+    return b_simd_find_sse2(&haystack[i], haylen - i, needle, needlelen);
+}
+
+#endif
+
+const char* b_simd_find_byte(const char* data, size_t len, char byte) {
+#ifdef _BEAN_SIMD_X86
+    switch (b_simd_level()) {
+        case SIMDLEVEL_AVX2:
+            return b_simd_find_byte_avx2(data, len, byte);
+        case SIMDLEVEL_SSE2:
+            return b_simd_find_byte_sse2(data, len, byte);
+        default:
+            break;
+    }
+#endif
+
+    return memchr(data, byte, len);
+}
+
+size_t b_simd_count_byte(const char* data, size_t len, char byte) {
+#ifdef _BEAN_SIMD_X86
+    switch (b_simd_level()) {
+        case SIMDLEVEL_AVX2:
+            return b_simd_count_byte_avx2(data, len, byte);
+        case SIMDLEVEL_SSE2:
+            return b_simd_count_byte_sse2(data, len, byte);
+        default:
+            break;
+    }
+#endif
+
+    return b_simd_count_byte_scalar(data, len, byte);
+}
+
+bool b_simd_equal(const void* lhs, const void* rhs, size_t len) {
+#ifdef _BEAN_SIMD_X86
+    switch (b_simd_level()) {
+        case SIMDLEVEL_AVX2:
+            return b_simd_equal_avx2(lhs, rhs, len);
+        case SIMDLEVEL_SSE2:
+            return b_simd_equal_sse2(lhs, rhs, len);
+        default:
+            break;
+    }
+#endif
+
+    return memcmp(lhs, rhs, len) == 0;
+}
+
+const char* b_simd_find(const char* haystack, size_t haylen,
+                        const char* needle, size_t needlelen) {
+    if (needlelen == 0)
+        return haystack;
+    else if (needlelen > haylen)
+        return NULL;
+    else if (needlelen == 1)
+        return b_simd_find_byte(haystack, haylen, needle[0]);
+
+#ifdef _BEAN_SIMD_X86
+    switch (b_simd_level()) {
+        case SIMDLEVEL_AVX2:
+            return b_simd_find_avx2(haystack, haylen, needle, needlelen);
+        case SIMDLEVEL_SSE2:
+            return b_simd_find_sse2(haystack, haylen, needle, needlelen);
+        default:
+            break;
+    }
+#endif
+
+    return b_simd_find_scalar(haystack, haylen, needle, needlelen);
+}
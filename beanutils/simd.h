@@ -0,0 +1,57 @@
+/* beanutils: Some data structure implementations and utility functions, I
+ * guess.
+ *
+ * Copyright (c) Eason Qin, 2024.
+ *
+ * NOTE: This source code form is licensed under the MIT license and comes
+ * with ABSOLUTELY NO WARRANTY. For more information, please view the
+ * `LICENSE` file at the root of the project.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * The instruction sets the byte-scanning kernels can use.
+ */
+typedef enum {
+    SIMDLEVEL_SCALAR,
+    SIMDLEVEL_SSE2,
+    SIMDLEVEL_AVX2,
+} b_simdlevel_t;
+
+/**
+ * Gets the instruction set the kernels dispatch to. It is detected with
+ * CPUID on first use.
+ */
+b_simdlevel_t b_simd_level(void);
+
+/**
+ * Restricts the kernels to at most `level`, e.g. to compare implementations.
+ * Levels the CPU does not support are ignored.
+ */
+void b_simd_set_level(b_simdlevel_t level);
+
+/**
+ * Finds the first occurrence of `byte` in `data`, or returns `NULL`.
+ */
+const char* b_simd_find_byte(const char* data, size_t len, char byte);
+
+/**
+ * Counts the occurrences of `byte` in `data`.
+ */
+size_t b_simd_count_byte(const char* data, size_t len, char byte);
+
+/**
+ * Checks if two buffers of `len` bytes are equal.
+ */
+bool b_simd_equal(const void* lhs, const void* rhs, size_t len);
+
+/**
+ * Finds the first occurrence of `needle` in `haystack`, or returns `NULL`.
+ * An empty needle is found at the start of the haystack.
+ */
+const char* b_simd_find(const char* haystack, size_t haylen,
+                        const char* needle, size_t needlelen);
@@ -0,0 +1,418 @@
+/* beanutils: Some data structure implementations and utility functions, I
+ * guess.
+ *
+ * Copyright (c) Eason Qin, 2024.
+ *
+ * NOTE: This source code form is licensed under the MIT license and comes
+ * with ABSOLUTELY NO WARRANTY. For more information, please view the
+ * `LICENSE` file at the root of the project.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "array.h"
+#include "common.h"
+#include "sort.h"
+#include "threadpool.h"
+
+typedef struct {
+    void** src;
+    void** dst;
+    b_cmpfn_t cmp;
+    size_t start;
+    size_t mid;
+    size_t finish;
+    size_t outstart;
+    size_t outfinish;
+} BeanSortTask;
+
+typedef struct {
+    uint64_t key;
+    void* elem;
+} BeanSortKeyed;
+
+static inline void b_sort_swap(void** data, size_t i, size_t j) {
+    void* tmp = data[i];
+    data[i] = data[j];
+    data[j] = tmp;
+}
+
+static void b_sort_insertion(void** data, size_t len, b_cmpfn_t cmp) {
+    for (size_t i = 1; i < len; i++) {
+        void* elem = data[i];
+        size_t j = i;
+
+        for (; j > 0 && cmp(data[j - 1], elem) > 0; j--)
+            data[j] = data[j - 1];
+        data[j] = elem;
+    }
+}
+
+static void b_sort_sift_down(void** data, size_t root, size_t len,
+                             b_cmpfn_t cmp) {
+    size_t child;
+
+    while ((child = 2 * root + 1) < len) {
+        if (child + 1 < len && cmp(data[child], data[child + 1]) < 0)
+            child++;
+        if (cmp(data[root], data[child]) >= 0)
+            return;
+
+        b_sort_swap(data, root, child);
+        root = child;
+    }
+}
+
+static void b_sort_heapsort(void** data, size_t len, b_cmpfn_t cmp) {
+    for (size_t i = len / 2; i-- > 0;)
+        b_sort_sift_down(data, i, len, cmp);
+
+    for (size_t i = len; i-- > 1;) {
+        b_sort_swap(data, 0, i);
+        b_sort_sift_down(data, 0, i, cmp);
+    }
+}
+
+static void b_sort_intro(void** data, size_t len, size_t depth,
+                         b_cmpfn_t cmp) {
+    while (len > _BEAN_SORT_INSERTION_THRESHOLD) {
+        size_t mid = len / 2;
+        size_t i = 0;
+        size_t j = len - 1;
+        void* pivot;
+
+        // Quicksort has gone quadratic; finish this range in O(n log n).
+        if (depth == 0) {
+            b_sort_heapsort(data, len, cmp);
+            return;
+        }
+        depth--;
+
+        // Median of three, which also leaves sentinels at both ends so the
+        // partition scans cannot run off the range.
+        if (cmp(data[mid], data[0]) < 0)
+            b_sort_swap(data, mid, 0);
+        if (cmp(data[len - 1], data[mid]) < 0) {
+            b_sort_swap(data, len - 1, mid);
+            if (cmp(data[mid], data[0]) < 0)
+                b_sort_swap(data, mid, 0);
+        }
+        pivot = data[mid];
+
+        for (;;) {
+            while (cmp(data[i], pivot) < 0)
+                i++;
+            while (cmp(pivot, data[j]) < 0)
+                j--;
+            if (i >= j)
+                break;
+
+            b_sort_swap(data, i++, j--);
+        }
+
+        // Recurse into the smaller side so the stack stays O(log n).
+        if (j + 1 < len - j - 1) {
+            b_sort_intro(data, j + 1, depth, cmp);
+            data += j + 1;
+            len -= j + 1;
+        } else {
+            b_sort_intro(data + j + 1, len - j - 1, depth, cmp);
+            len = j + 1;
+        }
+    }
+
+    b_sort_insertion(data, len, cmp);
+}
+
+b_errno_t b_array_sort(BeanArray* array, b_cmpfn_t cmp) {
+    size_t depth = 0;
+
+    if (array->data == NULL && array->len != 0)
+        return STATUS_DATA_NOT_INITIALIZED;
+
+    for (size_t n = array->len; n > 1; n >>= 1)
+        depth += 2;
+
+    b_sort_intro(array->data, array->len, depth, cmp);
+
+    return STATUS_SUCCESS;
+}
+
+// Finds how many of the first `k` merged elements come from the left run, so
+// that a merge can be split into independent pieces. Ties go to the left run
+// to keep the merge stable.
+static size_t b_sort_corank(void** left, size_t leftlen, void** right,
+                            size_t rightlen, size_t k, b_cmpfn_t cmp) {
+    size_t lo = k > rightlen ? k - rightlen : 0;
+    size_t hi = k < leftlen ? k : leftlen;
+
+    while (lo < hi) {
+        size_t i = lo + (hi - lo) / 2;
+        size_t j = k - i;
+
+        if (j > 0 && cmp(left[i], right[j - 1]) <= 0)
+            lo = i + 1;
+        else
+            hi = i;
+    }
+
+    return lo;
+}
+
+static void b_sort_merge_task(void* arg) {
+    BeanSortTask* task = arg;
+    void** left = &task->src[task->start];
+    void** right = &task->src[task->mid];
+    size_t leftlen = task->mid - task->start;
+    size_t rightlen = task->finish - task->mid;
+    size_t k0 = task->outstart - task->start;
+    size_t k1 = task->outfinish - task->start;
+    size_t i = b_sort_corank(left, leftlen, right, rightlen, k0, task->cmp);
+    size_t j = k0 - i;
+    void** out = &task->dst[task->outstart];
+
+    for (size_t k = k0; k < k1; k++) {
+        if (j == rightlen ||
+            (i < leftlen && task->cmp(left[i], right[j]) <= 0))
+            *out++ = left[i++];
+        else
+            *out++ = right[j++];
+    }
+}
+
+// A leaf task sorts its chunk in place. Introsort is not stable, so the
+// chunks are sorted with a stable insertion + merge pass instead.
+static void b_sort_chunk_task(void* arg) {
+    BeanSortTask* task = arg;
+    void** data = &task->src[task->start];
+    void** scratch = &task->dst[task->start];
+    size_t len = task->finish - task->start;
+    size_t width = _BEAN_SORT_INSERTION_THRESHOLD;
+
+    for (size_t i = 0; i < len; i += width)
+        b_sort_insertion(&data[i], len - i < width ? len - i : width,
+                         task->cmp);
+
+    for (; width < len; width *= 2) {
+        for (size_t i = 0; i < len; i += 2 * width) {
+            BeanSortTask merge = {
+                .src = data,
+                .dst = scratch,
+                .cmp = task->cmp,
+                .start = i,
+                .mid = i + width < len ? i + width : len,
+                .finish = i + 2 * width < len ? i + 2 * width : len,
+            };
+
+            merge.outstart = merge.start;
+            merge.outfinish = merge.finish;
+            b_sort_merge_task(&merge);
+        }
+
+        void** tmp = data;
+        data = scratch;
+        scratch = tmp;
+    }
+
+    if (data != &task->src[task->start])
+        memcpy(scratch, data, len * sizeof(void*));
+}
+
+// Runs every task on the pool and waits for them. Tasks that cannot be
+// spawned run on the calling thread instead.
+static void b_sort_run(BeanThreadPool* pool, BeanSortTask* tasks,
+                       size_t count, b_taskfn_t fn) {
+    BeanTaskGroup group;
+
+    b_taskgroup_init(&group, pool);
+    for (size_t i = 1; i < count; i++) {
+        if (b_taskgroup_spawn(&group, fn, &tasks[i]) != STATUS_SUCCESS)
+            fn(&tasks[i]);
+    }
+
+    fn(&tasks[0]);
+    b_taskgroup_wait(&group);
+}
+
+b_errno_t b_array_sort_parallel(BeanArray* array, b_cmpfn_t cmp,
+                                BeanThreadPool* pool) {
+    size_t len = array->len;
+    size_t nthreads;
+    size_t nruns;
+    size_t* bounds;
+    BeanSortTask* tasks;
+    void** src = array->data;
+    void** dst;
+
+    if (pool == NULL && (pool = b_threadpool_default()) == NULL)
+        return b_array_sort(array, cmp);
+
+    // The calling thread takes part too.
+    nthreads = pool->nworkers + 1;
+    if (nthreads > len / _BEAN_SORT_MIN_PARALLEL_CHUNK)
+        nthreads = len / _BEAN_SORT_MIN_PARALLEL_CHUNK;
+
+    if (nthreads <= 1)
+        return b_array_sort(array, cmp);
+
+    dst = malloc(len * sizeof(void*));
+    bounds = malloc((nthreads + 1) * sizeof(size_t));
+    tasks = malloc(2 * nthreads * sizeof(BeanSortTask));
+    if (dst == NULL || bounds == NULL || tasks == NULL) {
+        free(dst);
+        free(bounds);
+        free(tasks);
+        return STATUS_FAILED_ALLOC;
+    }
+
+    nruns = nthreads;
+    for (size_t i = 0; i <= nruns; i++)
+        bounds[i] = i * len / nruns;
+
+    for (size_t i = 0; i < nruns; i++)
+        tasks[i] = (BeanSortTask){
+            .src = src,
+            .dst = dst,
+            .cmp = cmp,
+            .start = bounds[i],
+            .finish = bounds[i + 1],
+        };
+    b_sort_run(pool, tasks, nruns, b_sort_chunk_task);
+
+    // Merge neighbouring runs until one is left. Each merge is cut into
+    // pieces of equal output size so every round keeps all threads busy,
+    // including the last one.
+    while (nruns > 1) {
+        size_t npairs = (nruns + 1) / 2;
+        size_t pieces = nthreads / npairs > 0 ? nthreads / npairs : 1;
+        size_t ntasks = 0;
+
+        for (size_t p = 0; p < npairs; p++) {
+            size_t start = bounds[2 * p];
+            size_t finish = bounds[2 * p + 2 <= nruns ? 2 * p + 2 : nruns];
+            size_t mid = 2 * p + 1 <= nruns ? bounds[2 * p + 1] : finish;
+
+            for (size_t s = 0; s < pieces; s++)
+                tasks[ntasks++] = (BeanSortTask){
+                    .src = src,
+                    .dst = dst,
+                    .cmp = cmp,
+                    .start = start,
+                    .mid = mid,
+                    .finish = finish,
+                    .outstart = start + s * (finish - start) / pieces,
+                    .outfinish = start + (s + 1) * (finish - start) / pieces,
+                };
+        }
+        b_sort_run(pool, tasks, ntasks, b_sort_merge_task);
+
+        for (size_t p = 0; p < npairs; p++)
+            bounds[p + 1] = bounds[2 * p + 2 <= nruns ? 2 * p + 2 : nruns];
+        nruns = npairs;
+
+        void** tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    if (src != array->data) {
+        memcpy(array->data, src, len * sizeof(void*));
+        free(src);
+    } else {
+        free(dst);
+    }
+
+    free(bounds);
+    free(tasks);
+
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_array_radix_sort(BeanArray* array, b_keyfn_t key) {
+    size_t len = array->len;
+    size_t(*counts)[256];
+    BeanSortKeyed* items;
+    BeanSortKeyed* scratch;
+
+    if (len < 2)
+        return STATUS_SUCCESS;
+
+    counts = calloc(8, sizeof(*counts));
+    items = malloc(len * sizeof(BeanSortKeyed));
+    scratch = malloc(len * sizeof(BeanSortKeyed));
+    if (counts == NULL || items == NULL || scratch == NULL) {
+        free(counts);
+        free(items);
+        free(scratch);
+        return STATUS_FAILED_ALLOC;
+    }
+
+    // Extract every key once and build all eight histograms in one pass.
+    for (size_t i = 0; i < len; i++) {
+        uint64_t k = key(array->data[i]);
+
+        items[i] = (BeanSortKeyed){.key = k, .elem = array->data[i]};
+        for (size_t pass = 0; pass < 8; pass++)
+            counts[pass][(k >> (8 * pass)) & 0xFF]++;
+    }
+
+    for (size_t pass = 0; pass < 8; pass++) {
+        size_t* count = counts[pass];
+        size_t offset = 0;
+
+        if (count[(items[0].key >> (8 * pass)) & 0xFF] == len)
+            continue;
+
+        for (size_t b = 0; b < 256; b++) {
+            size_t c = count[b];
+            count[b] = offset;
+            offset += c;
+        }
+
+        for (size_t i = 0; i < len; i++)
+            scratch[count[(items[i].key >> (8 * pass)) & 0xFF]++] = items[i];
+
+        BeanSortKeyed* tmp = items;
+        items = scratch;
+        scratch = tmp;
+    }
+
+    for (size_t i = 0; i < len; i++)
+        array->data[i] = items[i].elem;
+
+    free(counts);
+    free(items);
+    free(scratch);
+
+    return STATUS_SUCCESS;
+}
+
+size_t b_array_lower_bound(const BeanArray* array, const void* key,
+                           b_cmpfn_t cmp) {
+    size_t lo = 0;
+    size_t hi = array->len;
+
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+
+        if (cmp(array->data[mid], key) < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+void* b_array_bsearch(const BeanArray* array, const void* key,
+                      b_cmpfn_t cmp) {
+    size_t i = b_array_lower_bound(array, key, cmp);
+
+    if (i == array->len || cmp(array->data[i], key) != 0)
+        return NULL;
+
+    return array->data[i];
+}
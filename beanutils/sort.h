@@ -0,0 +1,67 @@
+/* beanutils: Some data structure implementations and utility functions, I
+ * guess.
+ *
+ * Copyright (c) Eason Qin, 2024.
+ *
+ * NOTE: This source code form is licensed under the MIT license and comes
+ * with ABSOLUTELY NO WARRANTY. For more information, please view the
+ * `LICENSE` file at the root of the project.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "array.h"
+#include "common.h"
+#include "threadpool.h"
+
+#define _BEAN_SORT_INSERTION_THRESHOLD 16
+#define _BEAN_SORT_MIN_PARALLEL_CHUNK (64 * 1024)
+
+/**
+ * Extracts an unsigned integer sort key from an element. Signed keys can be
+ * flipped into order with `key ^ (1ull << 63)`.
+ */
+typedef uint64_t (*b_keyfn_t)(const void* elem);
+
+/**
+ * Sorts the elements of a `Bean_Array` in place with introsort. The
+ * comparator receives the elements themselves, not pointers into the array.
+ * The sort is not stable.
+ */
+b_errno_t b_array_sort(BeanArray* array, b_cmpfn_t cmp);
+
+/**
+ * Sorts the elements of a `Bean_Array` with a stable parallel merge sort:
+ * chunks are sorted as separate tasks, then merged pairwise with every merge
+ * split evenly across the workers. Small arrays are sorted serially.
+ *
+ *  @param pool  The `BeanThreadPool` to run on, or `NULL` for the default one.
+ */
+b_errno_t b_array_sort_parallel(BeanArray* array, b_cmpfn_t cmp,
+                                BeanThreadPool* pool);
+
+/**
+ * Sorts the elements of a `Bean_Array` by an integer key with a stable LSD
+ * radix sort, one byte per pass. Passes where every key has the same byte
+ * are skipped.
+ */
+b_errno_t b_array_radix_sort(BeanArray* array, b_keyfn_t key);
+
+/**
+ * Finds the first element of a sorted `Bean_Array` that does not sort before
+ * `key`.
+ *
+ * @return Its index, or `array->len` if there is none.
+ */
+size_t b_array_lower_bound(const BeanArray* array, const void* key,
+                           b_cmpfn_t cmp);
+
+/**
+ * Finds an element of a sorted `Bean_Array` that sorts together with `key`.
+ *
+ * @return The element, or `NULL` if there is none.
+ */
+void* b_array_bsearch(const BeanArray* array, const void* key, b_cmpfn_t cmp);
@@ -8,6 +8,8 @@
  * `LICENSE` file at the root of the project.
  */
 
+#include <ctype.h>
+#include <stdatomic.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -15,40 +17,130 @@
 
 #include "common.h"
 #include "logger.h"
+#include "simd.h"
 #include "string.h"
+#include "trace.h"
+
+/*
+ * Heap buffers of strings that are not arena-backed are prefixed with a
+ * reference count, so clones can share them until one of them is modified.
+ * `ptr` points just past the header.
+ */
+typedef struct {
+    atomic_size_t refs;
+} BeanStringHeader;
+
+static inline BeanStringHeader* b_string_header(const char* ptr) {
+    return (BeanStringHeader*)ptr - 1;
+}
+
+static char* b_string_heap_alloc(const BeanAllocator* allocator,
+                                 size_t size) {
+    BeanStringHeader* header = b_alloc(
+        allocator, sizeof(BeanStringHeader) + size + 1, ALLOCTAG_STRING);
+
+    if (header == NULL)
+        return NULL;
+
+    atomic_init(&header->refs, 1);
+    return (char*)(header + 1);
+}
+
+static char* b_string_heap_realloc(const BeanAllocator* allocator, char* ptr,
+                                   size_t size) {
+    BeanStringHeader* header =
+        b_realloc(allocator, b_string_header(ptr),
+                  sizeof(BeanStringHeader) + size + 1, ALLOCTAG_STRING);
+
+    return header != NULL ? (char*)(header + 1) : NULL;
+}
+
+// The acquire half makes every write by the other owners visible before the
+// buffer is freed.
+static void b_string_heap_release(const BeanAllocator* allocator, char* ptr) {
+    BeanStringHeader* header = b_string_header(ptr);
+
+    if (atomic_fetch_sub_explicit(&header->refs, 1, memory_order_acq_rel) == 1)
+        b_free(allocator, header, ALLOCTAG_STRING);
+}
+
+// Allocates a buffer for `size` characters wherever `bs` keeps its buffers.
+static char* b_string_alloc_buffer(BeanString* bs, size_t size) {
+    if (bs->arena != NULL)
+        return b_arena_alloc(bs->arena, size + 1);
+
+    return b_string_heap_alloc(bs->allocator, size);
+}
 
 b_errno_t b_string_init(BeanString* bs) {
     return b_string_init_with_capacity(bs, _BEAN_STRING_INITIAL_CAPACITY);
 }
 
 b_errno_t b_string_init_with_capacity(BeanString* bs, size_t size) {
+    return b_string_init_with_capacity_in(bs, size, NULL);
+}
+
+b_errno_t b_string_init_with_cstr(BeanString* bs, const char* str) {
+    return b_string_init_with_cstr_in(bs, str, NULL);
+}
+
+b_errno_t b_string_init_in(BeanString* bs, BeanArena* arena) {
+    return b_string_init_with_capacity_in(bs, _BEAN_STRING_INITIAL_CAPACITY,
+                                          arena);
+}
+
+b_errno_t b_string_init_with_capacity_in(BeanString* bs, size_t size,
+                                         BeanArena* arena) {
+    char* data;
+
     *bs = (BeanString){
-        .data = calloc(size + 1, sizeof(char)),
-        .cap = size,
         .len = 0,
+        .cap = _BEAN_STRING_INLINE_CAPACITY,
+        .arena = arena,
+        .allocator = b_allocator_get(),
     };
 
-    if (bs->data == NULL) {
+    if (size <= _BEAN_STRING_INLINE_CAPACITY)
+        return STATUS_SUCCESS;
+
+    if ((data = b_string_alloc_buffer(bs, size)) == NULL) {
         bs->cap = 0;
         return STATUS_FAILED_ALLOC;
-    } else {
-        return STATUS_SUCCESS;
     }
+
+    data[0] = '\0';
+    bs->ptr = data;
+    bs->cap = size;
+
+    return STATUS_SUCCESS;
 }
 
-b_errno_t b_string_init_with_cstr(BeanString* bs, const char* str) {
+b_errno_t b_string_init_with_cstr_in(BeanString* bs, const char* str,
+                                     BeanArena* arena) {
     b_errno_t stat;
-    size_t sz = _BEAN_STRING_INITIAL_CAPACITY;
+    size_t len = strlen(str);
+
+    if ((stat = b_string_init_with_capacity_in(bs, len, arena)) !=
+        STATUS_SUCCESS)
+        return stat;
 
-    while ((sz *= _BEAN_STRING_CAPACITY_MULTIPLIER) < strlen(str))
-        ;
+    memcpy(b_string_data(bs), str, len + 1);
+    bs->len = len;
 
-    if ((stat = b_string_init_with_capacity(bs, sz)) != STATUS_SUCCESS)
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_string_init_with_view(BeanString* bs, const BeanStringView* view) {
+    b_errno_t stat;
+    char* data;
+
+    if ((stat = b_string_init_with_capacity(bs, view->len)) != STATUS_SUCCESS)
         return stat;
 
-    for (size_t i = 0; str[i] != '\0'; i++)
-        bs->data[bs->len++] = str[i];
-    bs->data[bs->len] = '\0';
+    data = b_string_data(bs);
+    memcpy(data, view->data, view->len);
+    data[view->len] = '\0';
+    bs->len = view->len;
 
     return STATUS_SUCCESS;
 }
@@ -57,52 +149,161 @@ b_errno_t b_string_deinit(BeanString* bs) {
     if (bs->cap == 0)
         return STATUS_INVALID_OPERATION;
 
-    free(bs->data);
+    if (!b_string_is_inline(bs) && bs->arena == NULL)
+        b_string_heap_release(bs->allocator, bs->ptr);
     *bs = (BeanString){0};
 
     return STATUS_SUCCESS;
 }
 
+bool b_string_is_shared(const BeanString* bs) {
+    if (b_string_is_inline(bs) || bs->arena != NULL)
+        return false;
+
+    return atomic_load_explicit(&b_string_header(bs->ptr)->refs,
+                                memory_order_acquire) > 1;
+}
+
+b_errno_t b_string_make_unique(BeanString* bs) {
+    char* newdata;
+
+    if (!b_string_is_shared(bs))
+        return STATUS_SUCCESS;
+
+    B_TRACE_FUNC();
+
+    if ((newdata = b_string_heap_alloc(bs->allocator, bs->cap)) == NULL)
+        return STATUS_FAILED_ALLOC;
+
+    memcpy(newdata, bs->ptr, bs->len + 1);
+    b_string_heap_release(bs->allocator, bs->ptr);
+    bs->ptr = newdata;
+
+    return STATUS_SUCCESS;
+}
+
 b_errno_t b_string_reserve(BeanString* bs, size_t size) {
+    B_TRACE_FUNC();
+    char* newdata;
+
     if (size == 0 && bs->cap != 0)
         return STATUS_INVALID_OPERATION;
-    else if (bs->cap > bs->len)
+    else if (size < bs->len)
+        return STATUS_INVALID_OPERATION;
+
+    // Small enough to live inline again.
+    if (size <= _BEAN_STRING_INLINE_CAPACITY) {
+        char* old = bs->ptr;
+
+        if (b_string_is_inline(bs))
+            return STATUS_OPERATION_UNNECESSARY;
+
+        memcpy(bs->buf, old, bs->len + 1);
+        if (bs->arena == NULL)
+            b_string_heap_release(bs->allocator, old);
+        bs->cap = _BEAN_STRING_INLINE_CAPACITY;
+
+        return STATUS_SUCCESS;
+    }
+
+    if (size == bs->cap)
         return STATUS_OPERATION_UNNECESSARY;
 
-    bs->data = (char*)realloc(bs->data, sizeof(char) * (size + 1));
+    // A shared buffer is left to its other owners and copied instead.
+    if (b_string_is_inline(bs) || b_string_is_shared(bs)) {
+        if ((newdata = b_string_alloc_buffer(bs, size)) == NULL)
+            return STATUS_FAILED_ALLOC;
 
-    if (bs->data == NULL) {
-        bs->cap = 0;
-        return STATUS_FAILED_ALLOC;
+        memcpy(newdata, b_string_data(bs), bs->len + 1);
+        if (!b_string_is_inline(bs))
+            b_string_heap_release(bs->allocator, bs->ptr);
     } else {
-        bs->cap = size;
+        if (bs->arena != NULL)
+            newdata =
+                b_arena_realloc(bs->arena, bs->ptr, bs->cap + 1, size + 1);
+        else
+            newdata = b_string_heap_realloc(bs->allocator, bs->ptr, size);
+
+        if (newdata == NULL)
+            return STATUS_FAILED_ALLOC;
+    }
+
+    bs->ptr = newdata;
+    bs->cap = size;
+
+    return STATUS_SUCCESS;
+}
+
+/**
+ * Prepares a `BeanString` to be written to: its buffer is made unique and
+ * grown so that it can hold `len` characters.
+ */
+static b_errno_t b_string_grow_to(BeanString* bs, size_t len) {
+    if (len <= bs->cap)
+        return b_string_make_unique(bs);
+
+    return b_string_reserve(
+        bs, b_growth_next(&bs->policy, bs->cap, len, sizeof(char)));
+}
+
+b_errno_t b_string_set_policy(BeanString* bs, BeanGrowthPolicy policy) {
+    bs->policy = policy;
+
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_string_set_allocator(BeanString* bs,
+                                 const BeanAllocator* allocator) {
+    char* newdata;
+
+    if (bs->arena != NULL)
+        return STATUS_INVALID_OPERATION;
+
+    if (allocator == NULL)
+        allocator = b_allocator_get();
+    if (allocator == bs->allocator || b_string_is_inline(bs)) {
+        bs->allocator = allocator;
         return STATUS_SUCCESS;
     }
+
+    if ((newdata = b_string_heap_alloc(allocator, bs->cap)) == NULL)
+        return STATUS_FAILED_ALLOC;
+
+    memcpy(newdata, bs->ptr, bs->len + 1);
+    b_string_heap_release(bs->allocator, bs->ptr);
+    bs->ptr = newdata;
+    bs->allocator = allocator;
+
+    return STATUS_SUCCESS;
 }
 
 b_errno_t b_string_expand(BeanString* bs) {
-    size_t newcap = bs->cap * _BEAN_STRING_CAPACITY_MULTIPLIER;
+    size_t newcap = b_growth_next(&bs->policy, bs->cap, bs->cap + 1,
+                                  sizeof(char));
     return b_string_reserve(bs, newcap);
 }
 
 b_errno_t b_string_shrink(BeanString* bs) {
-    size_t newcap = bs->cap / _BEAN_STRING_CAPACITY_MULTIPLIER;
+    size_t newcap = bs->len > 0 ? bs->len : 1;
 
-    if (newcap == 0)
-        return STATUS_INVALID_OPERATION;
+    if (b_string_is_inline(bs) || newcap == bs->cap)
+        return STATUS_OPERATION_UNNECESSARY;
 
     return b_string_reserve(bs, newcap);
 }
 
 bool b_string_simplecmp(const BeanString* lhs, const BeanString* rhs) {
-    if (lhs->len != rhs->len || lhs->cap == 0 || rhs->cap || 0)
+    if (lhs->cap == 0 || rhs->cap == 0)
         return false;
 
-    for (size_t i = 0; i < lhs->len; i++)
-        if (lhs->data[i] != rhs->data[i])
-            return false;
+    return b_string_equal(lhs, rhs);
+}
 
-    return true;
+bool b_string_equal(const BeanString* lhs, const BeanString* rhs) {
+    if (lhs->len != rhs->len)
+        return false;
+
+    return b_simd_equal(b_string_data(lhs), b_string_data(rhs), lhs->len);
 }
 
 int32_t b_string_strcmp(const BeanString* lhs, const BeanString* rhs) {
@@ -111,25 +312,25 @@ int32_t b_string_strcmp(const BeanString* lhs, const BeanString* rhs) {
     if (rhs->len > lhs->len)
         len = rhs->len;
 
-    return strncmp(lhs->data, rhs->data, len);
+    return strncmp(b_string_data(lhs), b_string_data(rhs), len);
 }
 
 b_errno_t b_string_concatnum(BeanString* bs, const BeanString* other,
                              size_t count) {
     b_errno_t stat;
-    size_t sz = bs->cap;
-
-    while ((sz *= _BEAN_STRING_CAPACITY_MULTIPLIER) < bs->len + count)
-        ;
+    char* data;
 
-    if (other->len > count)
+    if (count > other->len)
         count = other->len;
 
-    if ((stat = b_string_reserve(bs, sz)) != STATUS_SUCCESS)
+    if ((stat = b_string_grow_to(bs, bs->len + count)) != STATUS_SUCCESS)
         return stat;
 
-    memcpy(&bs->data[bs->len], other->data, other->len);
-    bs->data[bs->len] = '\0';
+    // Looked up after growing, in case `other` is `bs` itself.
+    data = b_string_data(bs);
+    memmove(&data[bs->len], b_string_data(other), count);
+    bs->len += count;
+    data[bs->len] = '\0';
 
     return STATUS_SUCCESS;
 }
@@ -140,17 +341,14 @@ b_errno_t b_string_concat(BeanString* bs, const BeanString* other) {
 
 b_errno_t b_string_push(BeanString* bs, char ch) {
     b_errno_t stat;
-    size_t sz = bs->cap;
+    char* data;
 
-    while ((sz *= _BEAN_STRING_CAPACITY_MULTIPLIER) < bs->len + 1)
-        ;
-
-    if (bs->cap != sz)
-        if ((stat = b_string_reserve(bs, sz)) != STATUS_SUCCESS)
-            return stat;
+    if ((stat = b_string_grow_to(bs, bs->len + 1)) != STATUS_SUCCESS)
+        return stat;
 
-    bs->data[bs->len++] = ch;
-    bs->data[bs->len] = '\0';
+    data = b_string_data(bs);
+    data[bs->len++] = ch;
+    data[bs->len] = '\0';
 
     return STATUS_SUCCESS;
 }
@@ -158,69 +356,519 @@ b_errno_t b_string_push(BeanString* bs, char ch) {
 b_errno_t b_string_push_cstr(BeanString* bs, const char* cstr) {
     b_errno_t stat;
     size_t cstr_len = strlen(cstr);
-    size_t sz = bs->cap;
-
-    while ((sz *= _BEAN_STRING_CAPACITY_MULTIPLIER) < bs->len + cstr_len)
-        ;
+    char* data;
 
-    if (bs->cap != sz)
-        if ((stat = b_string_reserve(bs, sz)) != STATUS_SUCCESS)
-            return stat;
+    if ((stat = b_string_grow_to(bs, bs->len + cstr_len)) != STATUS_SUCCESS)
+        return stat;
 
-    memcpy(&bs->data[bs->len], cstr, sizeof(char) * cstr_len);
+    data = b_string_data(bs);
+    memcpy(&data[bs->len], cstr, sizeof(char) * cstr_len);
     bs->len += cstr_len;
+    data[bs->len] = '\0';
 
     return STATUS_SUCCESS;
 }
 
 b_errno_t b_string_insert(BeanString* bs, char ch, size_t index) {
     b_errno_t stat;
+    char* data;
 
-    if (bs->cap < bs->len + 1)
-        if ((stat = b_string_expand(bs)) != STATUS_SUCCESS)
-            return stat;
+    if (index > bs->len)
+        return STATUS_INVALID_OPERATION;
 
-    memmove(&bs->data[index], &bs->data[index + 1],
-            sizeof(char) * bs->len - index + 1);
-    bs->data[index] = ch;
+    if ((stat = b_string_grow_to(bs, bs->len + 1)) != STATUS_SUCCESS)
+        return stat;
+
+    data = b_string_data(bs);
+    memmove(&data[index + 1], &data[index],
+            sizeof(char) * (bs->len - index + 1));
+    data[index] = ch;
+    bs->len++;
 
     return STATUS_SUCCESS;
 }
 
 b_errno_t b_string_remove(BeanString* bs, size_t index) {
     b_errno_t stat;
+    size_t newcap;
+    char* data;
 
-    if (bs->cap / _BEAN_STRING_CAPACITY_MULTIPLIER > bs->len - 1)
-        if ((stat = b_string_shrink(bs)) != STATUS_SUCCESS)
-            return stat;
+    if (index >= bs->len)
+        return STATUS_INVALID_OPERATION;
 
-    memmove(&bs->data[index + 1], &bs->data[index],
-            sizeof(char) * bs->len - index + 1);
+    if ((stat = b_string_make_unique(bs)) != STATUS_SUCCESS)
+        return stat;
+
+    data = b_string_data(bs);
+
+    memmove(&data[index], &data[index + 1], sizeof(char) * (bs->len - index));
+    bs->len--;
+
+    // Failing to hand memory back leaves the string intact, so it is not an
+    // error.
+    newcap = b_growth_shrink(&bs->policy, bs->len, bs->cap,
+                             _BEAN_STRING_INLINE_CAPACITY);
+    if (newcap < bs->cap)
+        b_string_reserve(bs, newcap);
 
     return STATUS_SUCCESS;
 }
 
-BeanString b_string_clone(BeanString* bs) {
+size_t b_string_find(const BeanString* bs, const BeanString* needle,
+                     size_t start) {
+    const char* data = b_string_data(bs);
+    const char* match;
+
+    if (start > bs->len)
+        return B_STRING_NPOS;
+
+    match = b_simd_find(&data[start], bs->len - start, b_string_data(needle),
+                        needle->len);
+
+    return match != NULL ? (size_t)(match - data) : B_STRING_NPOS;
+}
+
+size_t b_string_find_byte(const BeanString* bs, char ch, size_t start) {
+    const char* data = b_string_data(bs);
+    const char* match;
+
+    if (start >= bs->len)
+        return B_STRING_NPOS;
+
+    match = b_simd_find_byte(&data[start], bs->len - start, ch);
+
+    return match != NULL ? (size_t)(match - data) : B_STRING_NPOS;
+}
+
+size_t b_string_count(const BeanString* bs, const BeanString* needle) {
+    size_t count = 0;
+    size_t pos = 0;
+
+    if (needle->len == 0)
+        return 0;
+    else if (needle->len == 1)
+        return b_simd_count_byte(b_string_data(bs), bs->len,
+                                 b_string_data(needle)[0]);
+
+    while ((pos = b_string_find(bs, needle, pos)) != B_STRING_NPOS) {
+        count++;
+        pos += needle->len;
+    }
+
+    return count;
+}
+
+b_errno_t b_string_replace_all(BeanString* bs, const BeanString* needle,
+                               const BeanString* replacement) {
+    b_errno_t stat;
     BeanString res = {0};
-    b_errno_t errno = b_string_init(&res);
+    const char* data = b_string_data(bs);
+    const char* repl = b_string_data(replacement);
+    char* out;
+    size_t count;
+    size_t newlen;
+    size_t pos = 0;
+    size_t match;
+
+    if (needle->len == 0)
+        return STATUS_INVALID_OPERATION;
+
+    if ((count = b_string_count(bs, needle)) == 0)
+        return STATUS_SUCCESS;
+
+    // Everything is copied into a buffer sized up front, so the result is
+    // built in one pass whichever way the length changes.
+    newlen = bs->len - count * needle->len + count * replacement->len;
+    b_string_init_in(&res, bs->arena);
+    res.allocator = bs->allocator;
+    if (newlen > _BEAN_STRING_INLINE_CAPACITY &&
+        (stat = b_string_reserve(&res, newlen)) != STATUS_SUCCESS)
+        return stat;
+
+    out = b_string_data(&res);
+    while ((match = b_string_find(bs, needle, pos)) != B_STRING_NPOS) {
+        memcpy(&out[res.len], &data[pos], match - pos);
+        res.len += match - pos;
+        memcpy(&out[res.len], repl, replacement->len);
+        res.len += replacement->len;
+        pos = match + needle->len;
+    }
+
+    memcpy(&out[res.len], &data[pos], bs->len - pos);
+    res.len += bs->len - pos;
+    out[res.len] = '\0';
+    res.policy = bs->policy;
+
+    b_string_deinit(bs);
+    *bs = res;
 
-    if (errno != STATUS_SUCCESS) {
+    return STATUS_SUCCESS;
+}
+
+BeanString b_string_clone(const BeanString* bs) {
+    BeanString res = *bs;
+    b_errno_t stat;
+
+    // Inline strings are copied along with the struct and heap buffers are
+    // shared, so only arena-backed strings need a deep copy.
+    if (b_string_is_inline(bs))
+        return res;
+
+    if (bs->arena == NULL) {
+        atomic_fetch_add_explicit(&b_string_header(bs->ptr)->refs, 1,
+                                  memory_order_relaxed);
+        return res;
+    }
+
+    res = (BeanString){0};
+    stat = b_string_init_with_capacity_in(&res, bs->len, bs->arena);
+    if (stat != STATUS_SUCCESS) {
         b_log(LOGLEVEL_FATAL, "failed to initialize a new BeanString:");
         perror("   internal error");
         exit(EXIT_FAILURE);
     }
 
-    b_string_reserve(bs, bs->cap);
-
-    strcpy(res.data, bs->data);
+    memcpy(b_string_data(&res), b_string_data(bs), bs->len + 1);
     res.len = bs->len;
-    res.cap = bs->cap;
+    res.policy = bs->policy;
 
     return res;
 }
 
-char* b_string_clone_into_cstr(BeanString* bs) {
-    char* res = calloc(strlen(bs->data) + 1, 1);
-    strcpy(res, bs->data);
+char* b_string_clone_into_cstr(const BeanString* bs) {
+    char* res = malloc(bs->len + 1);
+
+    if (res != NULL)
+        memcpy(res, b_string_data(bs), bs->len + 1);
+
     return res;
 }
+
+BeanStringView b_string_get_view(const BeanString* bs, size_t start,
+                                 size_t finish) {
+    BeanStringView view = {.data = b_string_data(bs), .len = bs->len};
+    return b_strview_slice(&view, start, finish);
+}
+
+BeanStringView b_strview_from(const char* data, size_t len) {
+    return (BeanStringView){.data = data, .len = len};
+}
+
+BeanStringView b_strview_from_cstr(const char* cstr) {
+    return (BeanStringView){.data = cstr, .len = strlen(cstr)};
+}
+
+BeanStringView b_strview_slice(const BeanStringView* view, size_t start,
+                               size_t finish) {
+    if (finish > view->len)
+        finish = view->len;
+    if (start > finish)
+        start = finish;
+
+    return (BeanStringView){.data = view->data + start, .len = finish - start};
+}
+
+BeanStringView b_strview_trim_start(const BeanStringView* view) {
+    size_t start = 0;
+
+    while (start < view->len && isspace((unsigned char)view->data[start]))
+        start++;
+
+    return b_strview_slice(view, start, view->len);
+}
+
+BeanStringView b_strview_trim_end(const BeanStringView* view) {
+    size_t finish = view->len;
+
+    while (finish > 0 && isspace((unsigned char)view->data[finish - 1]))
+        finish--;
+
+    return b_strview_slice(view, 0, finish);
+}
+
+BeanStringView b_strview_trim(const BeanStringView* view) {
+    BeanStringView res = b_strview_trim_start(view);
+    return b_strview_trim_end(&res);
+}
+
+bool b_strview_starts_with(const BeanStringView* view,
+                           const BeanStringView* prefix) {
+    return prefix->len <= view->len &&
+           memcmp(view->data, prefix->data, prefix->len) == 0;
+}
+
+bool b_strview_ends_with(const BeanStringView* view,
+                         const BeanStringView* suffix) {
+    return suffix->len <= view->len &&
+           memcmp(&view->data[view->len - suffix->len], suffix->data,
+                  suffix->len) == 0;
+}
+
+bool b_strview_equal(const BeanStringView* view, const BeanStringView* rhs) {
+    return view->len == rhs->len &&
+           b_simd_equal(view->data, rhs->data, view->len);
+}
+
+int32_t b_strview_cmp(const BeanStringView* view, const BeanStringView* rhs) {
+    size_t len = view->len < rhs->len ? view->len : rhs->len;
+    int res = len > 0 ? memcmp(view->data, rhs->data, len) : 0;
+
+    if (res != 0)
+        return res;
+
+    return (view->len > rhs->len) - (view->len < rhs->len);
+}
+
+size_t b_strview_find(const BeanStringView* view,
+                      const BeanStringView* needle) {
+    const char* match =
+        b_simd_find(view->data, view->len, needle->data, needle->len);
+
+    return match != NULL ? (size_t)(match - view->data) : B_STRING_NPOS;
+}
+
+void b_strview_split_init(BeanStringSplit* split, const BeanStringView* view,
+                          const BeanStringView* delim) {
+    *split = (BeanStringSplit){
+        .rest = *view,
+        .delim = *delim,
+        .tokenize = false,
+        .done = delim->len == 0,
+    };
+}
+
+void b_strview_tokenize_init(BeanStringSplit* split,
+                             const BeanStringView* view,
+                             const BeanStringView* delims) {
+    *split = (BeanStringSplit){
+        .rest = *view,
+        .delim = *delims,
+        .tokenize = true,
+        .done = false,
+    };
+
+    for (size_t i = 0; i < delims->len; i++) {
+        unsigned char ch = (unsigned char)delims->data[i];
+        split->delimset[ch / 8] |= (unsigned char)(1u << (ch % 8));
+    }
+}
+
+static bool b_strview_is_delim(const BeanStringSplit* split, char ch) {
+    unsigned char uch = (unsigned char)ch;
+    return (split->delimset[uch / 8] >> (uch % 8)) & 1;
+}
+
+bool b_strview_split_next(BeanStringSplit* split, BeanStringView* field) {
+    BeanStringView* rest = &split->rest;
+
+    if (split->done)
+        return false;
+
+    if (split->tokenize) {
+        size_t start = 0;
+        size_t finish;
+
+        while (start < rest->len &&
+               b_strview_is_delim(split, rest->data[start]))
+            start++;
+        if (start == rest->len) {
+            split->done = true;
+            return false;
+        }
+
+        finish = start;
+        while (finish < rest->len &&
+               !b_strview_is_delim(split, rest->data[finish]))
+            finish++;
+
+        *field = b_strview_slice(rest, start, finish);
+        *rest = b_strview_slice(rest, finish, rest->len);
+
+        return true;
+    }
+
+    size_t pos;
+    if (split->delim.len == 1) {
+        const char* match =
+            b_simd_find_byte(rest->data, rest->len, split->delim.data[0]);
+        pos = match != NULL ? (size_t)(match - rest->data) : B_STRING_NPOS;
+    } else {
+        pos = b_strview_find(rest, &split->delim);
+    }
+
+    // The last field is whatever follows the final delimiter.
+    if (pos == B_STRING_NPOS) {
+        *field = *rest;
+        split->done = true;
+        return true;
+    }
+
+    *field = b_strview_slice(rest, 0, pos);
+    *rest = b_strview_slice(rest, pos + split->delim.len, rest->len);
+
+    return true;
+}
+
+struct BeanStringChunk {
+    BeanStringChunk* next;
+    size_t len;
+    size_t cap;
+    char data[];
+};
+
+b_errno_t b_strbuilder_init(BeanStringBuilder* sb) {
+    *sb = (BeanStringBuilder){.allocator = b_allocator_get()};
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_strbuilder_deinit(BeanStringBuilder* sb) {
+    BeanStringChunk* chunk = sb->head;
+
+    while (chunk != NULL) {
+        BeanStringChunk* next = chunk->next;
+        b_free(sb->allocator, chunk, ALLOCTAG_BUILDER);
+        chunk = next;
+    }
+
+    *sb = (BeanStringBuilder){.allocator = sb->allocator};
+
+    return STATUS_SUCCESS;
+}
+
+/**
+ * Empties a `BeanStringBuilder`, keeping its first chunk for reuse.
+ */
+static void b_strbuilder_clear(BeanStringBuilder* sb) {
+    BeanStringChunk* first = sb->head;
+
+    if (first == NULL)
+        return;
+
+    sb->head = first->next;
+    b_strbuilder_deinit(sb);
+
+    first->next = NULL;
+    first->len = 0;
+    sb->head = sb->tail = first;
+}
+
+static b_errno_t b_strbuilder_add_chunk(BeanStringBuilder* sb,
+                                        size_t atleast) {
+    BeanStringChunk* chunk;
+    size_t cap = _BEAN_STRING_BUILDER_CHUNK_SIZE;
+
+    // Chunks double in size so that long outputs need few of them.
+    if (sb->tail != NULL) {
+        cap = sb->tail->cap;
+        if (cap < _BEAN_STRING_BUILDER_MAX_CHUNK_SIZE)
+            cap *= 2;
+    }
+
+    if (cap < atleast)
+        cap = atleast;
+
+    chunk = b_alloc(sb->allocator, sizeof(BeanStringChunk) + cap,
+                    ALLOCTAG_BUILDER);
+    if (chunk == NULL)
+        return STATUS_FAILED_ALLOC;
+
+    chunk->next = NULL;
+    chunk->len = 0;
+    chunk->cap = cap;
+
+    if (sb->tail != NULL)
+        sb->tail->next = chunk;
+    else
+        sb->head = chunk;
+    sb->tail = chunk;
+
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_strbuilder_append_bytes(BeanStringBuilder* sb, const void* bytes,
+                                    size_t count) {
+    const char* src = bytes;
+    BeanStringChunk* tail = sb->tail;
+    size_t room = tail != NULL ? tail->cap - tail->len : 0;
+
+    // Fill whatever is left of the current chunk, then spill the rest into
+    // a single new chunk.
+    if (room > count)
+        room = count;
+    if (room > 0) {
+        memcpy(&tail->data[tail->len], src, room);
+        tail->len += room;
+        src += room;
+        count -= room;
+        sb->len += room;
+    }
+
+    if (count > 0) {
+        b_errno_t stat;
+
+        if ((stat = b_strbuilder_add_chunk(sb, count)) != STATUS_SUCCESS)
+            return stat;
+
+        memcpy(sb->tail->data, src, count);
+        sb->tail->len = count;
+        sb->len += count;
+    }
+
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_strbuilder_append_char(BeanStringBuilder* sb, char ch) {
+    BeanStringChunk* tail = sb->tail;
+
+    if (tail != NULL && tail->len < tail->cap) {
+        tail->data[tail->len++] = ch;
+        sb->len++;
+        return STATUS_SUCCESS;
+    }
+
+    return b_strbuilder_append_bytes(sb, &ch, 1);
+}
+
+b_errno_t b_strbuilder_append_cstr(BeanStringBuilder* sb, const char* cstr) {
+    return b_strbuilder_append_bytes(sb, cstr, strlen(cstr));
+}
+
+b_errno_t b_strbuilder_append_string(BeanStringBuilder* sb,
+                                     const BeanString* bs) {
+    return b_strbuilder_append_bytes(sb, b_string_data(bs), bs->len);
+}
+
+b_errno_t b_strbuilder_finalize(BeanStringBuilder* sb, BeanString* out) {
+    b_errno_t stat;
+    char* data;
+    size_t pos = 0;
+
+    if ((stat = b_string_init_with_capacity(out, sb->len)) != STATUS_SUCCESS)
+        return stat;
+
+    data = b_string_data(out);
+    for (BeanStringChunk* chunk = sb->head; chunk != NULL;
+         chunk = chunk->next) {
+        memcpy(&data[pos], chunk->data, chunk->len);
+        pos += chunk->len;
+    }
+
+    data[pos] = '\0';
+    out->len = pos;
+
+    b_strbuilder_clear(sb);
+
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_strbuilder_flush(BeanStringBuilder* sb, FILE* file) {
+    for (BeanStringChunk* chunk = sb->head; chunk != NULL;
+         chunk = chunk->next) {
+        if (fwrite(chunk->data, 1, chunk->len, file) != chunk->len)
+            return STATUS_GENERIC_FAILURE;
+    }
+
+    b_strbuilder_clear(sb);
+
+    return STATUS_SUCCESS;
+}
@@ -13,29 +13,102 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <stdio.h>
 
+#include "alloc.h"
+#include "arena.h"
 #include "common.h"
+#include "growth.h"
 
-#define _BEAN_STRING_INITIAL_CAPACITY    12
-#define _BEAN_STRING_CAPACITY_MULTIPLIER 5
+#define _BEAN_STRING_INITIAL_CAPACITY 12
+#define _BEAN_STRING_INLINE_CAPACITY  23
+
+#define B_STRING_NPOS SIZE_MAX
+
+#define _BEAN_STRING_BUILDER_CHUNK_SIZE     4096
+#define _BEAN_STRING_BUILDER_MAX_CHUNK_SIZE (1024 * 1024)
 
 /**
- * A null-terminated Dynamic String on the Heap.
+ * A null-terminated Dynamic String.
+ *
+ * Strings of up to `_BEAN_STRING_INLINE_CAPACITY` characters are stored
+ * inline in `buf` and never touch the heap; longer strings move to a buffer
+ * pointed to by `ptr`. Use `b_string_data` to get at the characters.
+ *
+ * If `arena` is set, the buffer lives in that `BeanArena` and is released
+ * when the arena is reset instead of by `b_string_deinit`.
+ *
+ * Other heap buffers come from `allocator`, the global allocator at
+ * initialization unless changed with `b_string_set_allocator`. They are
+ * reference counted and may be shared by clones (see `b_string_clone`).
+ * Every mutating function copies a shared buffer first; call
+ * `b_string_make_unique` before writing through `b_string_data`.
+ *
+ * `policy` decides how the heap buffer grows and shrinks (see
+ * `b_string_set_policy`).
  */
 typedef struct {
-    char* data;
+    union {
+        char* ptr;
+        char buf[_BEAN_STRING_INLINE_CAPACITY + 1];
+    };
     size_t len;
     size_t cap;
+    BeanArena* arena;
+    BeanGrowthPolicy policy;
+    const BeanAllocator* allocator;
 } BeanString;
 
 /**
- * A String Builder that has a mutable heap-allocated buffer
+ * Gets the null-terminated character buffer of a `BeanString`, wherever it is
+ * stored.
+ */
+static inline char* b_string_data(const BeanString* bs) {
+    return bs->cap > _BEAN_STRING_INLINE_CAPACITY ? bs->ptr : (char*)bs->buf;
+}
+
+/**
+ * Checks if a `BeanString` is stored inline rather than on the heap.
+ */
+static inline bool b_string_is_inline(const BeanString* bs) {
+    return bs->cap <= _BEAN_STRING_INLINE_CAPACITY;
+}
+
+/**
+ * A non-owning view of a run of characters, e.g. part of a `BeanString` or a
+ * mapped file. It is not null-terminated.
+ */
+typedef struct {
+    const char* data;
+    size_t len;
+} BeanStringView;
+
+/**
+ * Iterates over the fields of a `BeanStringView` without copying them. See
+ * `b_strview_split_init` and `b_strview_tokenize_init`.
+ */
+typedef struct {
+    BeanStringView rest;
+    BeanStringView delim;
+    unsigned char delimset[32];
+    bool tokenize;
+    bool done;
+} BeanStringSplit;
+
+typedef struct BeanStringChunk BeanStringChunk;
+
+/**
+ * A String Builder that accumulates text in a chain of heap-allocated chunks
  * that can be converted into a `BeanString`.
+ *
+ * Appending never moves text that was already written; the chunks are only
+ * copied once, by `b_strbuilder_finalize`.
  */
 typedef struct {
-    char* data;
+    BeanStringChunk* head;
+    BeanStringChunk* tail;
     size_t len;
-    size_t cap;
+    const BeanAllocator* allocator;
 } BeanStringBuilder;
 
 /**
@@ -54,22 +127,68 @@ b_errno_t b_string_init_with_capacity(BeanString* bs, size_t size);
 b_errno_t b_string_init_with_cstr(BeanString* bs, const char* str);
 
 /**
- * Deinitializes a new `BeanString`.
+ * Initializes a new `BeanString` whose buffer is allocated from `arena`.
+ */
+b_errno_t b_string_init_in(BeanString* bs, BeanArena* arena);
+
+/**
+ * Initializes a new `BeanString` with a specified capacity in `arena`.
+ */
+b_errno_t b_string_init_with_capacity_in(BeanString* bs, size_t size,
+                                         BeanArena* arena);
+
+/**
+ * Initializes a new `BeanString` in `arena` with a C-string already in it.
+ */
+b_errno_t b_string_init_with_cstr_in(BeanString* bs, const char* str,
+                                     BeanArena* arena);
+
+/**
+ * Initializes a new `BeanString` with a copy of the contents of a view.
+ */
+b_errno_t b_string_init_with_view(BeanString* bs, const BeanStringView* view);
+
+/**
+ * Deinitializes a new `BeanString`. Arena-backed strings are only reset; their
+ * memory is reclaimed by the arena.
  */
 b_errno_t b_string_deinit(BeanString* bs);
 
+/**
+ * Sets the growth and shrink policies of a `BeanString`.
+ */
+b_errno_t b_string_set_policy(BeanString* bs, BeanGrowthPolicy policy);
+
+/**
+ * Makes a `BeanString` allocate its heap buffers from `allocator`, moving
+ * its current buffer over if it has one. `NULL` selects the global
+ * allocator. Arena-backed strings cannot change allocators.
+ */
+b_errno_t b_string_set_allocator(BeanString* bs,
+                                 const BeanAllocator* allocator);
+
+/**
+ * Checks if the buffer of a `BeanString` is shared with a clone.
+ */
+bool b_string_is_shared(const BeanString* bs);
+
+/**
+ * Gives a `BeanString` its own copy of its buffer if it is shared.
+ */
+b_errno_t b_string_make_unique(BeanString* bs);
+
 /**
  * Ensures that the buffer size of a `BeanString` is no less than a given size.
  */
 b_errno_t b_string_reserve(BeanString* bs, size_t size);
 
 /**
- * Expands the buffer size of a `BeanString`.
+ * Expands the buffer size of a `BeanString` according to its growth policy.
  */
 b_errno_t b_string_expand(BeanString* bs);
 
 /**
- * Shrinks the buffer size of a `BeanString`.
+ * Shrinks the buffer size of a `BeanString` to fit its contents.
  */
 b_errno_t b_string_shrink(BeanString* bs);
 
@@ -78,6 +197,11 @@ b_errno_t b_string_shrink(BeanString* bs);
  */
 bool b_string_simplecmp(const BeanString* lhs, const BeanString* rhs);
 
+/**
+ * Checks if two `BeanString`s have the same contents.
+ */
+bool b_string_equal(const BeanString* lhs, const BeanString* rhs);
+
 /**
  * Wrapper around `strcmp` but for `BeanString`s.
  */
@@ -115,11 +239,176 @@ b_errno_t b_string_insert(BeanString* bs, char ch, size_t index);
 b_errno_t b_string_remove(BeanString* bs, size_t index);
 
 /**
- * Clones a `BeanString`.
+ * Finds the first occurrence of `needle` at or after `start`.
+ *
+ * @return The index of the match, or `B_STRING_NPOS`.
+ */
+size_t b_string_find(const BeanString* bs, const BeanString* needle,
+                     size_t start);
+
+/**
+ * Finds the first occurrence of a character at or after `start`.
+ *
+ * @return The index of the match, or `B_STRING_NPOS`.
  */
-BeanString b_string_clone(BeanString* bs);
+size_t b_string_find_byte(const BeanString* bs, char ch, size_t start);
+
+/**
+ * Counts the non-overlapping occurrences of `needle` in a `BeanString`.
+ */
+size_t b_string_count(const BeanString* bs, const BeanString* needle);
+
+/**
+ * Replaces every non-overlapping occurrence of `needle` with `replacement`.
+ */
+b_errno_t b_string_replace_all(BeanString* bs, const BeanString* needle,
+                               const BeanString* replacement);
+
+/**
+ * Clones a `BeanString` in O(1). Heap buffers are shared between the clones,
+ * and whichever is modified first copies the buffer. Arena-backed strings are
+ * copied into the same arena straight away.
+ */
+BeanString b_string_clone(const BeanString* bs);
 
 /**
  * Clones the contents of a `BeanString` to a heap-allocated `char*`.
  */
-char* b_string_clone_into_cstr(BeanString* bs);
+char* b_string_clone_into_cstr(const BeanString* bs);
+
+/**
+ * Creates a `BeanStringView` over the range [`start`, `finish`) of a
+ * `BeanString`.
+ *
+ *  @param finish  If this is out of bounds, it will default to `bs->len`.
+ */
+BeanStringView b_string_get_view(const BeanString* bs, size_t start,
+                                 size_t finish);
+
+/**
+ * Creates a `BeanStringView` over `len` bytes at `data`.
+ */
+BeanStringView b_strview_from(const char* data, size_t len);
+
+/**
+ * Creates a `BeanStringView` over a C-style string.
+ */
+BeanStringView b_strview_from_cstr(const char* cstr);
+
+/**
+ * Narrows a `BeanStringView` to the range [`start`, `finish`).
+ *
+ *  @param finish  If this is out of bounds, it will default to `view->len`.
+ */
+BeanStringView b_strview_slice(const BeanStringView* view, size_t start,
+                               size_t finish);
+
+/**
+ * Strips leading and trailing whitespace off a `BeanStringView`.
+ */
+BeanStringView b_strview_trim(const BeanStringView* view);
+
+/**
+ * Strips leading whitespace off a `BeanStringView`.
+ */
+BeanStringView b_strview_trim_start(const BeanStringView* view);
+
+/**
+ * Strips trailing whitespace off a `BeanStringView`.
+ */
+BeanStringView b_strview_trim_end(const BeanStringView* view);
+
+/**
+ * Checks if a `BeanStringView` starts with `prefix`.
+ */
+bool b_strview_starts_with(const BeanStringView* view,
+                           const BeanStringView* prefix);
+
+/**
+ * Checks if a `BeanStringView` ends with `suffix`.
+ */
+bool b_strview_ends_with(const BeanStringView* view,
+                         const BeanStringView* suffix);
+
+/**
+ * Check if two `BeanStringView`s are equal.
+ */
+bool b_strview_equal(const BeanStringView* view, const BeanStringView* rhs);
+
+/**
+ * Compares two `BeanStringView`s lexicographically, like `strcmp`.
+ */
+int32_t b_strview_cmp(const BeanStringView* view, const BeanStringView* rhs);
+
+/**
+ * Finds the first occurrence of `needle` in a `BeanStringView`.
+ *
+ * @return The index of the match, or `B_STRING_NPOS`.
+ */
+size_t b_strview_find(const BeanStringView* view, const BeanStringView* needle);
+
+/**
+ * Starts splitting a `BeanStringView` on every occurrence of `delim`. Empty
+ * fields are kept, so "a,,b" yields "a", "" and "b".
+ */
+void b_strview_split_init(BeanStringSplit* split, const BeanStringView* view,
+                          const BeanStringView* delim);
+
+/**
+ * Starts splitting a `BeanStringView` into tokens separated by runs of any of
+ * the characters in `delims`. Empty tokens are skipped.
+ */
+void b_strview_tokenize_init(BeanStringSplit* split,
+                             const BeanStringView* view,
+                             const BeanStringView* delims);
+
+/**
+ * Gets the next field of a split.
+ *
+ * @return `false` once every field has been returned.
+ */
+bool b_strview_split_next(BeanStringSplit* split, BeanStringView* field);
+
+/**
+ * Initializes a new `BeanStringBuilder`.
+ */
+b_errno_t b_strbuilder_init(BeanStringBuilder* sb);
+
+/**
+ * Frees all chunks of a `BeanStringBuilder`.
+ */
+b_errno_t b_strbuilder_deinit(BeanStringBuilder* sb);
+
+/**
+ * Appends raw bytes onto a `BeanStringBuilder`.
+ */
+b_errno_t b_strbuilder_append_bytes(BeanStringBuilder* sb, const void* bytes,
+                                    size_t count);
+
+/**
+ * Appends one character onto a `BeanStringBuilder`.
+ */
+b_errno_t b_strbuilder_append_char(BeanStringBuilder* sb, char ch);
+
+/**
+ * Appends a C-style string onto a `BeanStringBuilder`.
+ */
+b_errno_t b_strbuilder_append_cstr(BeanStringBuilder* sb, const char* cstr);
+
+/**
+ * Appends the contents of a `BeanString` onto a `BeanStringBuilder`.
+ */
+b_errno_t b_strbuilder_append_string(BeanStringBuilder* sb,
+                                     const BeanString* bs);
+
+/**
+ * Copies everything in a `BeanStringBuilder` into a new, exactly-sized
+ * `BeanString` and empties the builder.
+ */
+b_errno_t b_strbuilder_finalize(BeanStringBuilder* sb, BeanString* out);
+
+/**
+ * Writes everything in a `BeanStringBuilder` to a file chunk by chunk and
+ * empties the builder.
+ */
+b_errno_t b_strbuilder_flush(BeanStringBuilder* sb, FILE* file);
@@ -0,0 +1,482 @@
+/* beanutils: Some data structure implementations and utility functions, I
+ * guess.
+ *
+ * Copyright (c) Eason Qin, 2024.
+ *
+ * NOTE: This source code form is licensed under the MIT license and comes
+ * with ABSOLUTELY NO WARRANTY. For more information, please view the
+ * `LICENSE` file at the root of the project.
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "array.h"
+#include "common.h"
+#include "threadpool.h"
+
+typedef struct BeanDequeBuffer BeanDequeBuffer;
+
+struct BeanDequeBuffer {
+    // Stealers may still be reading a buffer after it has been outgrown, so
+    // old buffers are kept around until the pool shuts down.
+    BeanDequeBuffer* prev;
+    size_t cap;
+    _Atomic(BeanTask*) slots[];
+};
+
+struct BeanTask {
+    b_taskfn_t fn;
+    void* arg;
+    BeanTaskGroup* group;
+    BeanTask* next;
+};
+
+struct BeanWorker {
+    // The owner works at the bottom and thieves at the top; keep them on
+    // separate cache lines.
+    _Alignas(64) _Atomic int64_t top;
+    _Alignas(64) _Atomic int64_t bottom;
+    _Atomic(BeanDequeBuffer*) buffer;
+    BeanThreadPool* pool;
+    pthread_t thread;
+    uint64_t rng;
+};
+
+typedef struct {
+    BeanTaskGroup* group;
+    b_rangefn_t fn;
+    void* arg;
+    size_t start;
+    size_t finish;
+    size_t grain;
+} BeanRangeTask;
+
+typedef struct {
+    const BeanArrayView* view;
+    b_viewfn_t fn;
+    void* arg;
+} BeanViewTask;
+
+static _Thread_local BeanWorker* b_threadpool_self = NULL;
+
+static pthread_once_t b_threadpool_default_once = PTHREAD_ONCE_INIT;
+static BeanThreadPool b_threadpool_default_pool;
+static bool b_threadpool_default_ready = false;
+
+static BeanDequeBuffer* b_deque_buffer_new(size_t cap) {
+    BeanDequeBuffer* buf =
+        malloc(sizeof(BeanDequeBuffer) + cap * sizeof(_Atomic(BeanTask*)));
+
+    if (buf == NULL)
+        return NULL;
+
+    buf->prev = NULL;
+    buf->cap = cap;
+
+    return buf;
+}
+
+static b_errno_t b_deque_push(BeanWorker* worker, BeanTask* task) {
+    int64_t b = atomic_load_explicit(&worker->bottom, memory_order_relaxed);
+    int64_t t = atomic_load_explicit(&worker->top, memory_order_acquire);
+    BeanDequeBuffer* buf =
+        atomic_load_explicit(&worker->buffer, memory_order_relaxed);
+
+    if (b - t >= (int64_t)buf->cap) {
+        BeanDequeBuffer* grown = b_deque_buffer_new(buf->cap * 2);
+
+        if (grown == NULL)
+            return STATUS_FAILED_ALLOC;
+
+        for (int64_t i = t; i < b; i++) {
+            BeanTask* moved = atomic_load_explicit(
+                &buf->slots[(size_t)i & (buf->cap - 1)], memory_order_relaxed);
+            atomic_store_explicit(&grown->slots[(size_t)i & (grown->cap - 1)],
+                                  moved, memory_order_relaxed);
+        }
+
+        grown->prev = buf;
+        buf = grown;
+        atomic_store_explicit(&worker->buffer, buf, memory_order_release);
+    }
+
+    atomic_store_explicit(&buf->slots[(size_t)b & (buf->cap - 1)], task,
+                          memory_order_relaxed);
+    atomic_store_explicit(&worker->bottom, b + 1, memory_order_release);
+
+    return STATUS_SUCCESS;
+}
+
+// Only the owner may take, and it takes the task it pushed most recently.
+static BeanTask* b_deque_take(BeanWorker* worker) {
+    int64_t b = atomic_load_explicit(&worker->bottom, memory_order_relaxed) - 1;
+    BeanDequeBuffer* buf =
+        atomic_load_explicit(&worker->buffer, memory_order_relaxed);
+    BeanTask* task;
+    int64_t t;
+
+    atomic_store_explicit(&worker->bottom, b, memory_order_seq_cst);
+    t = atomic_load_explicit(&worker->top, memory_order_seq_cst);
+
+    if (t > b) {
+        atomic_store_explicit(&worker->bottom, b + 1, memory_order_relaxed);
+        return NULL;
+    }
+
+    task = atomic_load_explicit(&buf->slots[(size_t)b & (buf->cap - 1)],
+                                memory_order_relaxed);
+
+    // The last task may be contended by a thief; whoever moves `top` wins.
+    if (t == b) {
+        if (!atomic_compare_exchange_strong_explicit(&worker->top, &t, t + 1,
+                                                     memory_order_seq_cst,
+                                                     memory_order_relaxed))
+            task = NULL;
+        atomic_store_explicit(&worker->bottom, b + 1, memory_order_relaxed);
+    }
+
+    return task;
+}
+
+static BeanTask* b_deque_steal(BeanWorker* worker) {
+    int64_t t = atomic_load_explicit(&worker->top, memory_order_seq_cst);
+    int64_t b = atomic_load_explicit(&worker->bottom, memory_order_seq_cst);
+    BeanDequeBuffer* buf;
+    BeanTask* task;
+
+    if (t >= b)
+        return NULL;
+
+    buf = atomic_load_explicit(&worker->buffer, memory_order_acquire);
+    task = atomic_load_explicit(&buf->slots[(size_t)t & (buf->cap - 1)],
+                                memory_order_relaxed);
+
+    if (!atomic_compare_exchange_strong_explicit(&worker->top, &t, t + 1,
+                                                 memory_order_seq_cst,
+                                                 memory_order_relaxed))
+        return NULL;
+
+    return task;
+}
+
+static BeanTask* b_threadpool_find(BeanThreadPool* pool, BeanWorker* self) {
+    BeanTask* task = NULL;
+    size_t first = 0;
+
+    if (self != NULL)
+        task = b_deque_take(self);
+
+    if (task == NULL &&
+        atomic_load_explicit(&pool->ninjected, memory_order_acquire) > 0) {
+        pthread_mutex_lock(&pool->lock);
+        if ((task = pool->injected) != NULL) {
+            pool->injected = task->next;
+            if (pool->injected == NULL)
+                pool->injected_tail = NULL;
+            atomic_fetch_sub_explicit(&pool->ninjected, 1,
+                                      memory_order_relaxed);
+        }
+        pthread_mutex_unlock(&pool->lock);
+    }
+
+    // Start stealing at a random victim so thieves spread out.
+    if (task == NULL && self != NULL) {
+        self->rng ^= self->rng << 13;
+        self->rng ^= self->rng >> 7;
+        self->rng ^= self->rng << 17;
+        first = (size_t)(self->rng % pool->nworkers);
+    }
+
+    for (size_t i = 0; task == NULL && i < pool->nworkers; i++) {
+        BeanWorker* victim = &pool->workers[(first + i) % pool->nworkers];
+
+        if (victim != self)
+            task = b_deque_steal(victim);
+    }
+
+    if (task != NULL)
+        atomic_fetch_sub_explicit(&pool->queued, 1, memory_order_relaxed);
+
+    return task;
+}
+
+static void b_threadpool_run(BeanTask* task) {
+    BeanTaskGroup* group = task->group;
+
+    task->fn(task->arg);
+    free(task);
+    atomic_fetch_sub_explicit(&group->pending, 1, memory_order_acq_rel);
+}
+
+static void* b_threadpool_worker_main(void* arg) {
+    BeanWorker* self = arg;
+    BeanThreadPool* pool = self->pool;
+    size_t spins = 0;
+
+    b_threadpool_self = self;
+
+    for (;;) {
+        BeanTask* task = b_threadpool_find(pool, self);
+
+        if (task != NULL) {
+            b_threadpool_run(task);
+            spins = 0;
+            continue;
+        }
+
+        if (atomic_load(&pool->shutdown) && atomic_load(&pool->queued) == 0)
+            break;
+
+        if (++spins < _BEAN_THREADPOOL_SPIN_ROUNDS) {
+            sched_yield();
+            continue;
+        }
+
+        // `sleeping` is raised before `queued` is checked, and spawners
+        // raise `queued` before checking `sleeping`, so one of the two
+        // always sees the other and no wakeup is lost.
+        pthread_mutex_lock(&pool->lock);
+        atomic_fetch_add(&pool->sleeping, 1);
+        while (atomic_load(&pool->queued) == 0 && !atomic_load(&pool->shutdown))
+            pthread_cond_wait(&pool->wake, &pool->lock);
+        atomic_fetch_sub(&pool->sleeping, 1);
+        pthread_mutex_unlock(&pool->lock);
+        spins = 0;
+    }
+
+    return NULL;
+}
+
+static void b_threadpool_stop(BeanThreadPool* pool, size_t started) {
+    pthread_mutex_lock(&pool->lock);
+    atomic_store(&pool->shutdown, true);
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (size_t i = 0; i < started; i++)
+        pthread_join(pool->workers[i].thread, NULL);
+
+    for (size_t i = 0; i < pool->nworkers; i++) {
+        BeanDequeBuffer* buf = atomic_load(&pool->workers[i].buffer);
+
+        while (buf != NULL) {
+            BeanDequeBuffer* prev = buf->prev;
+            free(buf);
+            buf = prev;
+        }
+    }
+
+    pthread_cond_destroy(&pool->wake);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool->workers);
+    pool->workers = NULL;
+}
+
+b_errno_t b_threadpool_init(BeanThreadPool* pool, size_t nworkers) {
+    if (nworkers == 0) {
+        long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+        nworkers = ncpus > 0 ? (size_t)ncpus : 1;
+    }
+
+    pool->workers =
+        aligned_alloc(_Alignof(BeanWorker), nworkers * sizeof(BeanWorker));
+    if (pool->workers == NULL)
+        return STATUS_FAILED_ALLOC;
+
+    pool->nworkers = nworkers;
+    pool->injected = NULL;
+    pool->injected_tail = NULL;
+    atomic_init(&pool->ninjected, 0);
+    atomic_init(&pool->queued, 0);
+    atomic_init(&pool->sleeping, 0);
+    atomic_init(&pool->shutdown, false);
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+
+    for (size_t i = 0; i < nworkers; i++) {
+        BeanWorker* worker = &pool->workers[i];
+
+        atomic_init(&worker->top, 0);
+        atomic_init(&worker->bottom, 0);
+        atomic_init(&worker->buffer,
+                    b_deque_buffer_new(_BEAN_THREADPOOL_DEQUE_CAPACITY));
+        worker->pool = pool;
+        worker->rng = 0x9E3779B97F4A7C15u * (i + 1);
+    }
+
+    for (size_t i = 0; i < nworkers; i++) {
+        BeanWorker* worker = &pool->workers[i];
+
+        if (atomic_load(&worker->buffer) == NULL ||
+            pthread_create(&worker->thread, NULL, b_threadpool_worker_main,
+                           worker) != 0) {
+            b_threadpool_stop(pool, i);
+            return STATUS_GENERIC_FAILURE;
+        }
+    }
+
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_threadpool_deinit(BeanThreadPool* pool) {
+    if (pool->workers == NULL)
+        return STATUS_INVALID_OPERATION;
+
+    b_threadpool_stop(pool, pool->nworkers);
+
+    return STATUS_SUCCESS;
+}
+
+static void b_threadpool_default_init(void) {
+    b_threadpool_default_ready =
+        b_threadpool_init(&b_threadpool_default_pool, 0) == STATUS_SUCCESS;
+}
+
+BeanThreadPool* b_threadpool_default(void) {
+    pthread_once(&b_threadpool_default_once, b_threadpool_default_init);
+
+    return b_threadpool_default_ready ? &b_threadpool_default_pool : NULL;
+}
+
+void b_taskgroup_init(BeanTaskGroup* group, BeanThreadPool* pool) {
+    group->pool = pool;
+    atomic_init(&group->pending, 0);
+}
+
+b_errno_t b_taskgroup_spawn(BeanTaskGroup* group, b_taskfn_t fn, void* arg) {
+    BeanThreadPool* pool = group->pool;
+    BeanWorker* self = b_threadpool_self;
+    BeanTask* task = malloc(sizeof(BeanTask));
+
+    if (task == NULL)
+        return STATUS_FAILED_ALLOC;
+
+    *task = (BeanTask){.fn = fn, .arg = arg, .group = group, .next = NULL};
+    atomic_fetch_add_explicit(&group->pending, 1, memory_order_relaxed);
+    atomic_fetch_add(&pool->queued, 1);
+
+    if (self == NULL || self->pool != pool ||
+        b_deque_push(self, task) != STATUS_SUCCESS) {
+        pthread_mutex_lock(&pool->lock);
+        if (pool->injected_tail != NULL)
+            pool->injected_tail->next = task;
+        else
+            pool->injected = task;
+        pool->injected_tail = task;
+        atomic_fetch_add_explicit(&pool->ninjected, 1, memory_order_release);
+        pthread_mutex_unlock(&pool->lock);
+    }
+
+    if (atomic_load(&pool->sleeping) > 0) {
+        pthread_mutex_lock(&pool->lock);
+        pthread_cond_signal(&pool->wake);
+        pthread_mutex_unlock(&pool->lock);
+    }
+
+    return STATUS_SUCCESS;
+}
+
+void b_taskgroup_wait(BeanTaskGroup* group) {
+    BeanWorker* self = b_threadpool_self;
+
+    if (self != NULL && self->pool != group->pool)
+        self = NULL;
+
+    while (atomic_load_explicit(&group->pending, memory_order_acquire) > 0) {
+        BeanTask* task = b_threadpool_find(group->pool, self);
+
+        if (task != NULL)
+            b_threadpool_run(task);
+        else
+            sched_yield();
+    }
+}
+
+static void b_threadpool_range_task(void* arg) {
+    BeanRangeTask* range = arg;
+
+    // Keep the left half and hand the right half to whoever steals it.
+    while (range->finish - range->start > range->grain) {
+        size_t mid = range->start + (range->finish - range->start) / 2;
+        BeanRangeTask* right = malloc(sizeof(BeanRangeTask));
+
+        if (right == NULL)
+            break;
+
+        *right = *range;
+        right->start = mid;
+        if (b_taskgroup_spawn(range->group, b_threadpool_range_task, right) !=
+            STATUS_SUCCESS) {
+            free(right);
+            break;
+        }
+
+        range->finish = mid;
+    }
+
+    range->fn(range->start, range->finish, range->arg);
+    free(range);
+}
+
+b_errno_t b_threadpool_parallel_for(BeanThreadPool* pool, size_t start,
+                                    size_t finish, size_t grain,
+                                    b_rangefn_t fn, void* arg) {
+    BeanTaskGroup group;
+    BeanRangeTask* root;
+    size_t len = finish > start ? finish - start : 0;
+
+    if (len == 0)
+        return STATUS_SUCCESS;
+
+    if (pool == NULL)
+        pool = b_threadpool_default();
+
+    if (grain == 0 && pool != NULL) {
+        grain = len / (pool->nworkers * _BEAN_THREADPOOL_TASKS_PER_WORKER);
+        if (grain == 0)
+            grain = 1;
+    }
+
+    if (pool == NULL || len <= grain ||
+        (root = malloc(sizeof(BeanRangeTask))) == NULL) {
+        fn(start, finish, arg);
+        return STATUS_SUCCESS;
+    }
+
+    b_taskgroup_init(&group, pool);
+    *root = (BeanRangeTask){
+        .group = &group,
+        .fn = fn,
+        .arg = arg,
+        .start = start,
+        .finish = finish,
+        .grain = grain,
+    };
+
+    b_threadpool_range_task(root);
+    b_taskgroup_wait(&group);
+
+    return STATUS_SUCCESS;
+}
+
+static void b_threadpool_view_range(size_t start, size_t finish, void* arg) {
+    BeanViewTask* task = arg;
+    task->fn(&task->view->elems[start], finish - start, task->arg);
+}
+
+b_errno_t b_threadpool_parallel_for_view(BeanThreadPool* pool,
+                                         const BeanArrayView* view,
+                                         size_t grain, b_viewfn_t fn,
+                                         void* arg) {
+    BeanViewTask task = {.view = view, .fn = fn, .arg = arg};
+
+    return b_threadpool_parallel_for(pool, 0, view->len, grain,
+                                     b_threadpool_view_range, &task);
+}
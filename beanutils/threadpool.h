@@ -0,0 +1,125 @@
+/* beanutils: Some data structure implementations and utility functions, I
+ * guess.
+ *
+ * Copyright (c) Eason Qin, 2024.
+ *
+ * NOTE: This source code form is licensed under the MIT license and comes
+ * with ABSOLUTELY NO WARRANTY. For more information, please view the
+ * `LICENSE` file at the root of the project.
+ */
+
+#pragma once
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "array.h"
+#include "common.h"
+
+#define _BEAN_THREADPOOL_DEQUE_CAPACITY 256
+#define _BEAN_THREADPOOL_SPIN_ROUNDS 64
+#define _BEAN_THREADPOOL_TASKS_PER_WORKER 8
+
+typedef struct BeanWorker BeanWorker;
+typedef struct BeanTask BeanTask;
+
+/**
+ * A task run by a `BeanThreadPool`.
+ */
+typedef void (*b_taskfn_t)(void* arg);
+
+/**
+ * Processes the indices [`start`, `finish`) of a parallel loop.
+ */
+typedef void (*b_rangefn_t)(size_t start, size_t finish, void* arg);
+
+/**
+ * Processes `len` consecutive elements of a `BeanArrayView`.
+ */
+typedef void (*b_viewfn_t)(void** elems, size_t len, void* arg);
+
+/**
+ * A fixed set of worker threads, each with its own Chase-Lev deque. Workers
+ * push and pop tasks at the bottom of their own deque and steal from the top
+ * of the others' when they run dry. Tasks spawned from outside the pool go
+ * through a shared queue.
+ */
+typedef struct {
+    BeanWorker* workers;
+    size_t nworkers;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    BeanTask* injected;
+    BeanTask* injected_tail;
+    atomic_size_t ninjected;
+    atomic_size_t queued;
+    atomic_size_t sleeping;
+    atomic_bool shutdown;
+} BeanThreadPool;
+
+/**
+ * A set of tasks that can be waited on together.
+ */
+typedef struct {
+    BeanThreadPool* pool;
+    atomic_size_t pending;
+} BeanTaskGroup;
+
+/**
+ * Initializes a new `BeanThreadPool` and starts its workers.
+ *
+ *  @param nworkers  The number of worker threads, or 0 for one per CPU.
+ */
+b_errno_t b_threadpool_init(BeanThreadPool* pool, size_t nworkers);
+
+/**
+ * Stops a `BeanThreadPool`. Tasks that were already spawned are run to
+ * completion first.
+ */
+b_errno_t b_threadpool_deinit(BeanThreadPool* pool);
+
+/**
+ * Gets the process-wide `BeanThreadPool`, starting it with one worker per CPU
+ * on first use. It lives until the process exits.
+ */
+BeanThreadPool* b_threadpool_default(void);
+
+/**
+ * Initializes a new `BeanTaskGroup` whose tasks run on `pool`.
+ */
+void b_taskgroup_init(BeanTaskGroup* group, BeanThreadPool* pool);
+
+/**
+ * Spawns `fn(arg)` as part of a `BeanTaskGroup`.
+ */
+b_errno_t b_taskgroup_spawn(BeanTaskGroup* group, b_taskfn_t fn, void* arg);
+
+/**
+ * Waits for every task spawned into a `BeanTaskGroup`, including tasks
+ * spawned by those tasks. The waiting thread runs queued tasks meanwhile, so
+ * this may be called from inside a task.
+ */
+void b_taskgroup_wait(BeanTaskGroup* group);
+
+/**
+ * Calls `fn` on pieces of the range [`start`, `finish`) in parallel and waits
+ * for all of them. The range is split in halves until pieces are at most
+ * `grain` long, so idle workers steal large pieces first.
+ *
+ *  @param grain  The largest piece handed to `fn`, or 0 to pick one from the
+ *                number of workers.
+ */
+b_errno_t b_threadpool_parallel_for(BeanThreadPool* pool, size_t start,
+                                    size_t finish, size_t grain,
+                                    b_rangefn_t fn, void* arg);
+
+/**
+ * Calls `fn` on consecutive runs of the elements of a `BeanArrayView` in
+ * parallel, like `b_threadpool_parallel_for`.
+ */
+b_errno_t b_threadpool_parallel_for_view(BeanThreadPool* pool,
+                                         const BeanArrayView* view,
+                                         size_t grain, b_viewfn_t fn,
+                                         void* arg);
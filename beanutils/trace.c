@@ -0,0 +1,174 @@
+/* beanutils: Some data structure implementations and utility functions, I
+ * guess.
+ *
+ * Copyright (c) Eason Qin, 2024.
+ *
+ * NOTE: This source code form is licensed under the MIT license and comes
+ * with ABSOLUTELY NO WARRANTY. For more information, please view the
+ * `LICENSE` file at the root of the project.
+ */
+
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "common.h"
+#include "trace.h"
+
+typedef struct {
+    const char* name;
+    uint64_t start;
+    uint64_t duration;
+} BeanTraceEvent;
+
+/*
+ * The spans of one thread. Only the owning thread appends, publishing each
+ * span by bumping `len`, so exporting never has to stop it.
+ *
+ * Buffers are never freed: spans of threads that have exited are still
+ * exported.
+ */
+typedef struct BeanTraceBuffer {
+    struct BeanTraceBuffer* next;
+    unsigned tid;
+    atomic_size_t len;
+    atomic_size_t dropped;
+    BeanTraceEvent events[_BEAN_TRACE_BUFFER_EVENTS];
+} BeanTraceBuffer;
+
+static _Atomic(BeanTraceBuffer*) b_trace_buffers;
+static atomic_uint b_trace_next_tid;
+static _Thread_local BeanTraceBuffer* b_trace_local;
+
+// Gets the calling thread's buffer, registering a new one on first use.
+static BeanTraceBuffer* b_trace_buffer(void) {
+    BeanTraceBuffer* buf = b_trace_local;
+
+    if (buf != NULL)
+        return buf;
+
+    if ((buf = malloc(sizeof(BeanTraceBuffer))) == NULL)
+        return NULL;
+
+    buf->tid = atomic_fetch_add_explicit(&b_trace_next_tid, 1,
+                                         memory_order_relaxed) +
+               1;
+    atomic_init(&buf->len, 0);
+    atomic_init(&buf->dropped, 0);
+
+    buf->next = atomic_load_explicit(&b_trace_buffers, memory_order_relaxed);
+    while (!atomic_compare_exchange_weak_explicit(&b_trace_buffers, &buf->next,
+                                                  buf, memory_order_release,
+                                                  memory_order_relaxed))
+        ;
+
+    b_trace_local = buf;
+    return buf;
+}
+
+void b_trace_record(const char* name, uint64_t start, uint64_t finish) {
+    BeanTraceBuffer* buf = b_trace_buffer();
+    size_t len;
+
+    if (buf == NULL)
+        return;
+
+    len = atomic_load_explicit(&buf->len, memory_order_relaxed);
+    if (len == _BEAN_TRACE_BUFFER_EVENTS) {
+        atomic_fetch_add_explicit(&buf->dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    buf->events[len] = (BeanTraceEvent){
+        .name = name,
+        .start = start,
+        .duration = finish > start ? finish - start : 0,
+    };
+    atomic_store_explicit(&buf->len, len + 1, memory_order_release);
+}
+
+static void b_trace_write_string(FILE* output, const char* str) {
+    fputc('"', output);
+    for (; *str != '\0'; str++) {
+        unsigned char ch = (unsigned char)*str;
+
+        if (ch == '"' || ch == '\\')
+            fprintf(output, "\\%c", ch);
+        else if (ch < 0x20)
+            fprintf(output, "\\u%04x", ch);
+        else
+            fputc(ch, output);
+    }
+    fputc('"', output);
+}
+
+b_errno_t b_trace_export(FILE* output) {
+    BeanTraceBuffer* buf =
+        atomic_load_explicit(&b_trace_buffers, memory_order_acquire);
+    long pid = (long)getpid();
+    bool first = true;
+
+    fputs("{\"displayTimeUnit\": \"ns\", \"traceEvents\": [", output);
+
+    for (; buf != NULL; buf = buf->next) {
+        size_t len = atomic_load_explicit(&buf->len, memory_order_acquire);
+
+        for (size_t i = 0; i < len; i++) {
+            const BeanTraceEvent* ev = &buf->events[i];
+
+            // Timestamps are in microseconds; keep the nanoseconds as
+            // decimals.
+            fputs(first ? "\n  {\"name\": " : ",\n  {\"name\": ", output);
+            b_trace_write_string(output, ev->name);
+            fprintf(output,
+                    ", \"ph\": \"X\", \"ts\": %" PRIu64 ".%03" PRIu64
+                    ", \"dur\": %" PRIu64 ".%03" PRIu64
+                    ", \"pid\": %ld, \"tid\": %u}",
+                    ev->start / 1000, ev->start % 1000, ev->duration / 1000,
+                    ev->duration % 1000, pid, buf->tid);
+            first = false;
+        }
+    }
+
+    fputs("\n]}\n", output);
+
+    return ferror(output) ? STATUS_GENERIC_FAILURE : STATUS_SUCCESS;
+}
+
+size_t b_trace_len(void) {
+    BeanTraceBuffer* buf =
+        atomic_load_explicit(&b_trace_buffers, memory_order_acquire);
+    size_t len = 0;
+
+    for (; buf != NULL; buf = buf->next)
+        len += atomic_load_explicit(&buf->len, memory_order_relaxed);
+
+    return len;
+}
+
+size_t b_trace_dropped(void) {
+    BeanTraceBuffer* buf =
+        atomic_load_explicit(&b_trace_buffers, memory_order_acquire);
+    size_t dropped = 0;
+
+    for (; buf != NULL; buf = buf->next)
+        dropped += atomic_load_explicit(&buf->dropped, memory_order_relaxed);
+
+    return dropped;
+}
+
+b_errno_t b_trace_clear(void) {
+    BeanTraceBuffer* buf =
+        atomic_load_explicit(&b_trace_buffers, memory_order_acquire);
+
+    for (; buf != NULL; buf = buf->next) {
+        atomic_store_explicit(&buf->len, 0, memory_order_relaxed);
+        atomic_store_explicit(&buf->dropped, 0, memory_order_relaxed);
+    }
+
+    return STATUS_SUCCESS;
+}
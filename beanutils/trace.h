@@ -0,0 +1,108 @@
+/* beanutils: Some data structure implementations and utility functions, I
+ * guess.
+ *
+ * Copyright (c) Eason Qin, 2024.
+ *
+ * NOTE: This source code form is licensed under the MIT license and comes
+ * with ABSOLUTELY NO WARRANTY. For more information, please view the
+ * `LICENSE` file at the root of the project.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "common.h"
+
+#define _BEAN_TRACE_BUFFER_EVENTS (1 << 16)
+
+#define _BEAN_TRACE_CONCAT2(a, b) a##b
+#define _BEAN_TRACE_CONCAT(a, b)  _BEAN_TRACE_CONCAT2(a, b)
+
+/*
+ * Scoped trace probes. Defining `BEAN_TRACE` when compiling turns them on;
+ * otherwise they compile to nothing. The library's own probes (file I/O and
+ * buffer reallocation) follow the flag the library was built with.
+ *
+ *   void parse(void) {
+ *       B_TRACE_FUNC();
+ *       ...
+ *       {
+ *           B_TRACE_SCOPE("tokenize");
+ *           ...
+ *       }
+ *   }
+ *
+ * Each scope records when it was entered and how long it ran into a buffer
+ * owned by the calling thread, with no locking. `b_trace_export` writes the
+ * events out in the Chrome trace format, which `chrome://tracing` and
+ * Perfetto can open.
+ */
+#ifdef BEAN_TRACE
+#define B_TRACE_SCOPE(name)                                                    \
+    BeanTraceScope _BEAN_TRACE_CONCAT(_b_trace_scope_, __LINE__)               \
+        __attribute__((cleanup(b_trace_scope_end))) =                          \
+            b_trace_scope_begin(name)
+#else
+#define B_TRACE_SCOPE(name) ((void)0)
+#endif
+
+/**
+ * Traces the rest of the enclosing function under its name.
+ */
+#define B_TRACE_FUNC() B_TRACE_SCOPE(__func__)
+
+typedef struct {
+    const char* name;
+    uint64_t start;
+} BeanTraceScope;
+
+/**
+ * Gets a `CLOCK_MONOTONIC` timestamp in nanoseconds.
+ */
+static inline uint64_t b_trace_now(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * Records a span of `name` from `start` to `finish` (from `b_trace_now`) on
+ * the calling thread. `name` has to outlive the trace, e.g. be a literal.
+ *
+ * Spans past `_BEAN_TRACE_BUFFER_EVENTS` per thread are dropped and counted.
+ */
+void b_trace_record(const char* name, uint64_t start, uint64_t finish);
+
+static inline BeanTraceScope b_trace_scope_begin(const char* name) {
+    return (BeanTraceScope){.name = name, .start = b_trace_now()};
+}
+
+static inline void b_trace_scope_end(BeanTraceScope* scope) {
+    b_trace_record(scope->name, scope->start, b_trace_now());
+}
+
+/**
+ * Writes every recorded span as Chrome trace JSON. Threads may keep tracing
+ * while this runs; their newest spans may be left out.
+ */
+b_errno_t b_trace_export(FILE* output);
+
+/**
+ * Gets the number of spans recorded so far, over all threads.
+ */
+size_t b_trace_len(void);
+
+/**
+ * Gets the number of spans dropped because a thread's buffer was full.
+ */
+size_t b_trace_dropped(void);
+
+/**
+ * Forgets every recorded span. No thread may be tracing while this runs.
+ */
+b_errno_t b_trace_clear(void);
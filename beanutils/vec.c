@@ -0,0 +1,222 @@
+/* beanutils: Some data structure implementations and utility functions, I
+ * guess.
+ *
+ * Copyright (c) Eason Qin, 2024.
+ *
+ * NOTE: This source code form is licensed under the MIT license and comes
+ * with ABSOLUTELY NO WARRANTY. For more information, please view the
+ * `LICENSE` file at the root of the project.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+#include "trace.h"
+#include "vec.h"
+
+static b_errno_t b_vec_init_from(BeanVec* vec, size_t elemsize, size_t cap,
+                                 const BeanAllocator* allocator) {
+    if (vec->cap != 0 || elemsize == 0)
+        return STATUS_INVALID_OPERATION;
+
+    if (cap == 0)
+        cap = 1;
+
+    *vec = (BeanVec){
+        .len = 0,
+        .cap = cap,
+        .elemsize = elemsize,
+        .allocator = allocator,
+    };
+    vec->data = b_calloc(vec->allocator, cap, elemsize, ALLOCTAG_VEC);
+
+    if (vec->data == NULL) {
+        vec->cap = 0;
+        return STATUS_FAILED_ALLOC;
+    }
+
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_vec_init(BeanVec* vec, size_t elemsize) {
+    return b_vec_init_with_size(vec, elemsize, _BEAN_VEC_INITIAL_CAPACITY);
+}
+
+b_errno_t b_vec_init_with_size(BeanVec* vec, size_t elemsize, size_t cap) {
+    return b_vec_init_from(vec, elemsize, cap, b_allocator_get());
+}
+
+b_errno_t b_vec_deinit(BeanVec* vec) {
+    if (vec->cap == 0)
+        return STATUS_INVALID_OPERATION;
+
+    b_free(vec->allocator, vec->data, ALLOCTAG_VEC);
+    *vec = (BeanVec){0};
+
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_vec_set_allocator(BeanVec* vec, const BeanAllocator* allocator) {
+    void* newdata;
+
+    if (vec->cap == 0)
+        return STATUS_DATA_NOT_INITIALIZED;
+
+    if (allocator == NULL)
+        allocator = b_allocator_get();
+    if (allocator == vec->allocator)
+        return STATUS_SUCCESS;
+
+    newdata = b_alloc(allocator, vec->cap * vec->elemsize, ALLOCTAG_VEC);
+    if (newdata == NULL)
+        return STATUS_FAILED_ALLOC;
+
+    memcpy(newdata, vec->data, vec->len * vec->elemsize);
+    b_free(vec->allocator, vec->data, ALLOCTAG_VEC);
+    vec->data = newdata;
+    vec->allocator = allocator;
+
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_vec_reserve(BeanVec* vec, size_t size) {
+    B_TRACE_FUNC();
+    void* newdata;
+
+    if (vec->cap == 0)
+        return STATUS_DATA_NOT_INITIALIZED;
+    else if (size <= vec->cap)
+        return STATUS_OPERATION_UNNECESSARY;
+    else if (size > SIZE_MAX / vec->elemsize)
+        return STATUS_FAILED_ALLOC;
+
+    newdata = b_realloc(vec->allocator, vec->data, size * vec->elemsize,
+                        ALLOCTAG_VEC);
+    if (newdata == NULL)
+        return STATUS_FAILED_ALLOC;
+
+    vec->data = newdata;
+    vec->cap = size;
+
+    return STATUS_SUCCESS;
+}
+
+static b_errno_t b_vec_grow_for(BeanVec* vec, size_t count) {
+    size_t newcap = vec->cap;
+
+    if (vec->len + count <= vec->cap)
+        return STATUS_SUCCESS;
+
+    while (newcap < vec->len + count)
+        newcap *= _BEAN_VEC_GROWTH_FACTOR;
+
+    return b_vec_reserve(vec, newcap);
+}
+
+b_errno_t b_vec_push(BeanVec* vec, const void* elem) {
+    b_errno_t stat;
+
+    if ((stat = b_vec_grow_for(vec, 1)) != STATUS_SUCCESS)
+        return stat;
+
+    memcpy((char*)vec->data + vec->len * vec->elemsize, elem, vec->elemsize);
+    vec->len++;
+
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_vec_pop(BeanVec* vec, void* out) {
+    if (vec->len == 0)
+        return STATUS_INVALID_OPERATION;
+
+    vec->len--;
+    if (out != NULL)
+        memcpy(out, (char*)vec->data + vec->len * vec->elemsize,
+               vec->elemsize);
+
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_vec_insert(BeanVec* vec, const void* elem, size_t index) {
+    b_errno_t stat;
+    char* slot;
+
+    if (index > vec->len)
+        return STATUS_INVALID_OPERATION;
+
+    if ((stat = b_vec_grow_for(vec, 1)) != STATUS_SUCCESS)
+        return stat;
+
+    slot = (char*)vec->data + index * vec->elemsize;
+    memmove(slot + vec->elemsize, slot, (vec->len - index) * vec->elemsize);
+    memcpy(slot, elem, vec->elemsize);
+    vec->len++;
+
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_vec_remove(BeanVec* vec, size_t index) {
+    char* slot;
+
+    if (index >= vec->len)
+        return STATUS_INVALID_OPERATION;
+
+    slot = (char*)vec->data + index * vec->elemsize;
+    memmove(slot, slot + vec->elemsize,
+            (vec->len - index - 1) * vec->elemsize);
+    vec->len--;
+
+    return STATUS_SUCCESS;
+}
+
+void* b_vec_get(const BeanVec* vec, size_t index) {
+    if (index >= vec->len)
+        return NULL;
+
+    return (char*)vec->data + index * vec->elemsize;
+}
+
+BeanVecView b_vec_get_view(const BeanVec* vec, size_t start, size_t finish) {
+    BeanVecView view = {.elemsize = vec->elemsize};
+
+    if (finish > vec->len)
+        finish = vec->len;
+    if (start > finish)
+        start = finish;
+
+    view.data = (char*)vec->data + start * vec->elemsize;
+    view.len = finish - start;
+
+    return view;
+}
+
+b_errno_t b_vec_slice(const BeanVec* vec, BeanVec* newvec, size_t start,
+                      size_t finish) {
+    b_errno_t stat;
+    BeanVec res = {0};
+    BeanVecView view = b_vec_get_view(vec, start, finish);
+
+    stat = b_vec_init_from(&res, vec->elemsize, view.len, vec->allocator);
+    if (stat != STATUS_SUCCESS)
+        return stat;
+
+    memcpy(res.data, view.data, view.len * vec->elemsize);
+    res.len = view.len;
+
+    *newvec = res;
+
+    return STATUS_SUCCESS;
+}
+
+b_errno_t b_vec_clone(const BeanVec* vec, BeanVec* newvec) {
+    return b_vec_slice(vec, newvec, 0, vec->len);
+}
+
+bool b_vecview_equal(const BeanVecView* view, const BeanVecView* rhs) {
+    if (view->len != rhs->len || view->elemsize != rhs->elemsize)
+        return false;
+
+    return memcmp(view->data, rhs->data, view->len * view->elemsize) == 0;
+}
@@ -0,0 +1,147 @@
+/* beanutils: Some data structure implementations and utility functions, I
+ * guess.
+ *
+ * Copyright (c) Eason Qin, 2024.
+ *
+ * NOTE: This source code form is licensed under the MIT license and comes
+ * with ABSOLUTELY NO WARRANTY. For more information, please view the
+ * `LICENSE` file at the root of the project.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "alloc.h"
+#include "common.h"
+
+#define _BEAN_VEC_INITIAL_CAPACITY 8
+#define _BEAN_VEC_GROWTH_FACTOR    2
+
+/**
+ * A dynamic array that stores its elements inline in one contiguous buffer.
+ *
+ * Unlike `BeanArray`, elements are copied into the vector by value, so there
+ * is no per-element allocation.
+ *
+ * The buffer comes from `allocator`, the global allocator at initialization
+ * unless changed with `b_vec_set_allocator`.
+ */
+typedef struct {
+    void* data;
+    size_t len;
+    size_t cap;
+    size_t elemsize;
+    const BeanAllocator* allocator;
+} BeanVec;
+
+/**
+ * A non-owning view over a contiguous range of a `BeanVec`.
+ */
+typedef struct {
+    void* data;
+    size_t len;
+    size_t elemsize;
+} BeanVecView;
+
+/**
+ * Declares a typed span type, e.g. `typedef B_VEC_SPAN(int) IntSpan;`.
+ */
+#define B_VEC_SPAN(T)                                                          \
+    struct {                                                                   \
+        T* data;                                                               \
+        size_t len;                                                            \
+    }
+
+/**
+ * Converts a `BeanVec` or `BeanVecView` into a span type declared with
+ * `B_VEC_SPAN`.
+ */
+#define B_VEC_AS_SPAN(vec, SpanT)                                              \
+    ((SpanT){.data = (vec).data, .len = (vec).len})
+
+/**
+ * Accesses the element at `index` of a `BeanVec` or `BeanVecView` as a `T`.
+ * No bounds checking is done.
+ */
+#define B_VEC_AT(vec, T, index) (((T*)(vec)->data)[(index)])
+
+/**
+ * Initializes a new `BeanVec` holding elements of `elemsize` bytes.
+ */
+b_errno_t b_vec_init(BeanVec* vec, size_t elemsize);
+
+/**
+ * Initializes a new `BeanVec` with the specified capacity.
+ */
+b_errno_t b_vec_init_with_size(BeanVec* vec, size_t elemsize, size_t cap);
+
+/**
+ * Deallocates the storage of a `BeanVec`.
+ */
+b_errno_t b_vec_deinit(BeanVec* vec);
+
+/**
+ * Moves the buffer of a `BeanVec` to `allocator`, or to the global allocator
+ * if it is `NULL`.
+ */
+b_errno_t b_vec_set_allocator(BeanVec* vec, const BeanAllocator* allocator);
+
+/**
+ * Ensures that a `BeanVec` can hold at least `size` elements.
+ */
+b_errno_t b_vec_reserve(BeanVec* vec, size_t size);
+
+/**
+ * Copies one element onto the end of a `BeanVec`.
+ */
+b_errno_t b_vec_push(BeanVec* vec, const void* elem);
+
+/**
+ * Pops the last element off a `BeanVec`.
+ *
+ *  @param out  If this is not `NULL`, the popped element is copied into it.
+ */
+b_errno_t b_vec_pop(BeanVec* vec, void* out);
+
+/**
+ * Copies an element into a `BeanVec` at a given index.
+ */
+b_errno_t b_vec_insert(BeanVec* vec, const void* elem, size_t index);
+
+/**
+ * Removes the element at a given index of a `BeanVec`.
+ */
+b_errno_t b_vec_remove(BeanVec* vec, size_t index);
+
+/**
+ * Gets a pointer to the element at a given index, or `NULL` if it is out of
+ * bounds.
+ */
+void* b_vec_get(const BeanVec* vec, size_t index);
+
+/**
+ * Creates a `BeanVecView` over the range [`start`, `finish`) of a `BeanVec`.
+ *
+ *  @param finish  If this is out of bounds, it will default to `vec->len`.
+ */
+BeanVecView b_vec_get_view(const BeanVec* vec, size_t start, size_t finish);
+
+/**
+ * Copies the range [`start`, `finish`) of a `BeanVec` into a new `BeanVec`.
+ *
+ *  @param finish  If this is out of bounds, it will default to `vec->len`.
+ */
+b_errno_t b_vec_slice(const BeanVec* vec, BeanVec* newvec, size_t start,
+                      size_t finish);
+
+/**
+ * Clones a `BeanVec`, including all its contents.
+ */
+b_errno_t b_vec_clone(const BeanVec* vec, BeanVec* newvec);
+
+/**
+ * Check if two `BeanVecView`s are equal.
+ */
+bool b_vecview_equal(const BeanVecView* view, const BeanVecView* rhs);
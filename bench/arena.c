@@ -0,0 +1,77 @@
+// All benchmarks are licensed under the unlicense. Do whatever you want with
+// these benchmarks
+
+#include <stdlib.h>
+
+#include "beanutils/beanutils.h"
+#include "bench.h"
+
+#define ALLOCS     (1 << 20)
+#define GROW_STEPS 64
+
+static void* ptrs[ALLOCS];
+
+// Mixed small sizes, as for nodes and short strings.
+static size_t alloc_size(size_t i) {
+    return 16 + (i * 7) % 112;
+}
+
+static void run_malloc(void* arg) {
+    (void)arg;
+    for (size_t i = 0; i < ALLOCS; i++)
+        ptrs[i] = malloc(alloc_size(i));
+    for (size_t i = 0; i < ALLOCS; i++)
+        free(ptrs[i]);
+}
+
+static void run_arena(void* arg) {
+    BeanArena* arena = arg;
+
+    for (size_t i = 0; i < ALLOCS; i++)
+        ptrs[i] = b_arena_alloc(arena, alloc_size(i));
+    b_arena_reset(arena);
+}
+
+// Grows buffers 16 bytes at a time up to 1 KiB, in place while each is the
+// last allocation in its block.
+static void run_arena_realloc(void* arg) {
+    BeanArena* arena = arg;
+
+    for (size_t i = 0; i < ALLOCS / GROW_STEPS; i++) {
+        void* ptr = b_arena_alloc(arena, 16);
+
+        for (size_t size = 16; size < 16 * GROW_STEPS; size += 16)
+            ptr = b_arena_realloc(arena, ptr, size, size + 16);
+    }
+    b_arena_reset(arena);
+}
+
+int main(int argc, char** argv) {
+    BenchSuite suite;
+    BeanArena arena;
+
+    b_bench_init(&suite, "arena", argc, argv);
+    b_arena_init(&arena);
+
+    b_bench_run(&suite, &(BenchCase){
+                            .name = "malloc/free (16-128 B)",
+                            .run = run_malloc,
+                            .ops = ALLOCS,
+                        });
+    b_bench_run(&suite, &(BenchCase){
+                            .name = "b_arena_alloc/reset (16-128 B)",
+                            .run = run_arena,
+                            .arg = &arena,
+                            .ops = ALLOCS,
+                        });
+    b_bench_run(&suite, &(BenchCase){
+                            .name = "b_arena_realloc (+16 B)",
+                            .run = run_arena_realloc,
+                            .arg = &arena,
+                            .ops = ALLOCS,
+                        });
+
+    b_arena_deinit(&arena);
+
+    return b_bench_finish(&suite);
+}
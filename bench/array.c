@@ -0,0 +1,123 @@
+// All benchmarks are licensed under the unlicense. Do whatever you want with
+// these benchmarks
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "beanutils/beanutils.h"
+#include "bench.h"
+
+#define ELEMS  (1 << 20)
+#define CHUNK  1024
+#define SHIFTS 1000
+#define OWNED  (1 << 16)
+
+static void* elems[ELEMS];
+static BeanArray filled;
+static BeanArray owned;
+
+// The elements are never dereferenced, so they need not be owned.
+static void init_borrowed(BeanArray* arr) {
+    *arr = (BeanArray){0};
+    b_array_init(arr);
+    b_array_set_free_fn(arr, b_array_free_nothing);
+}
+
+static void run_push(void* arg) {
+    BeanArray arr;
+
+    (void)arg;
+    init_borrowed(&arr);
+    for (size_t i = 0; i < ELEMS; i++)
+        b_array_push(&arr, elems[i]);
+    b_array_deinit(&arr);
+}
+
+static void run_push_many(void* arg) {
+    BeanArray arr;
+
+    (void)arg;
+    init_borrowed(&arr);
+    for (size_t i = 0; i < ELEMS; i += CHUNK)
+        b_array_push_many(&arr, &elems[i], CHUNK);
+    b_array_deinit(&arr);
+}
+
+static void fill(void* arg) {
+    (void)arg;
+    b_array_truncate(&filled, 0);
+    b_array_push_many(&filled, elems, ELEMS);
+}
+
+static void run_pop(void* arg) {
+    (void)arg;
+    for (size_t i = 0; i < ELEMS; i++)
+        b_array_pop(&filled);
+}
+
+static void fill_owned(void* arg) {
+    (void)arg;
+    for (size_t i = owned.len; i < OWNED; i++)
+        b_array_push(&owned, malloc(16));
+}
+
+// Frees every element on the way out.
+static void run_truncate(void* arg) {
+    (void)arg;
+    b_array_truncate(&owned, 0);
+}
+
+// Opens and closes a gap in the middle, moving half of the array each time.
+static void run_shift(void* arg) {
+    (void)arg;
+    for (size_t i = 0; i < SHIFTS; i++) {
+        b_array_insert_range(&filled, elems, 64, ELEMS / 2);
+        b_array_remove_range(&filled, ELEMS / 2, ELEMS / 2 + 64);
+    }
+}
+
+int main(int argc, char** argv) {
+    BenchSuite suite;
+
+    b_bench_init(&suite, "array", argc, argv);
+
+    for (size_t i = 0; i < ELEMS; i++)
+        elems[i] = (void*)(uintptr_t)(i + 1);
+    init_borrowed(&filled);
+    b_array_init(&owned);
+
+    b_bench_run(&suite, &(BenchCase){
+                            .name = "b_array_push",
+                            .run = run_push,
+                            .ops = ELEMS,
+                        });
+    b_bench_run(&suite, &(BenchCase){
+                            .name = "b_array_push_many (1024 at a time)",
+                            .run = run_push_many,
+                            .ops = ELEMS,
+                        });
+    b_bench_run(&suite, &(BenchCase){
+                            .name = "b_array_pop",
+                            .setup = fill,
+                            .run = run_pop,
+                            .ops = ELEMS,
+                        });
+    b_bench_run(&suite, &(BenchCase){
+                            .name = "b_array_truncate (owned elements)",
+                            .setup = fill_owned,
+                            .run = run_truncate,
+                            .ops = OWNED,
+                        });
+    b_bench_run(&suite, &(BenchCase){
+                            .name = "b_array_insert_range/remove_range",
+                            .setup = fill,
+                            .run = run_shift,
+                            .ops = SHIFTS * 2,
+                            .bytes = (size_t)SHIFTS * ELEMS * sizeof(void*),
+                        });
+
+    b_array_deinit(&owned);
+    b_array_deinit(&filled);
+
+    return b_bench_finish(&suite);
+}
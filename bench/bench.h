@@ -0,0 +1,223 @@
+// All benchmarks are licensed under the unlicense. Do whatever you want with
+// these benchmarks
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAVE_CYCLES 1
+#else
+#define BENCH_HAVE_CYCLES 0
+#endif
+
+#define BENCH_DEFAULT_WARMUP 2
+#define BENCH_DEFAULT_REPS   10
+
+static inline double b_bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// Time stamp counter ticks, or 0 where there is no cheap cycle counter.
+static inline uint64_t b_bench_cycles(void) {
+#if BENCH_HAVE_CYCLES
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/*
+ * A suite of benchmark cases. Every case is run `warmup` times untimed and
+ * then `reps` times timed, and is reported by the median and 99th percentile
+ * of its repetitions.
+ *
+ * Suites understand these arguments:
+ *   --json        Print one JSON document instead of text, for comparing
+ *                 runs with other tools.
+ *   --reps N      Time every case N times.
+ *   --warmup N    Run every case N times before timing it.
+ *   --filter STR  Only run cases whose name contains STR.
+ */
+typedef struct {
+    const char* name;
+    size_t warmup;
+    size_t reps;
+    const char* filter;
+    bool json;
+    size_t nresults;
+} BenchSuite;
+
+// A figure a case measures besides time, e.g. reallocations. `run` stores
+// it in `*value`, and the last repetition's value is reported.
+typedef struct {
+    const char* name;
+    const double* value;
+} BenchExtra;
+
+typedef struct {
+    const char* name;
+    // Runs before every repetition, untimed. May be `NULL`.
+    void (*setup)(void* arg);
+    void (*run)(void* arg);
+    void* arg;
+    // Operations and bytes processed by one run, for ns/op and cycles/byte.
+    // `bytes` is 0 when it does not apply.
+    size_t ops;
+    size_t bytes;
+    // Caps the suite's repetition count for slow cases if non-zero.
+    size_t reps;
+    const BenchExtra* extras;
+    size_t nextras;
+} BenchCase;
+
+static inline void b_bench_init(BenchSuite* suite, const char* name, int argc,
+                                char** argv) {
+    *suite = (BenchSuite){
+        .name = name,
+        .warmup = BENCH_DEFAULT_WARMUP,
+        .reps = BENCH_DEFAULT_REPS,
+    };
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0)
+            suite->json = true;
+        else if (strcmp(argv[i], "--reps") == 0 && i + 1 < argc)
+            suite->reps = strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc)
+            suite->warmup = strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+            suite->filter = argv[++i];
+    }
+
+    if (suite->reps == 0)
+        suite->reps = 1;
+
+    if (suite->json)
+        printf("{\"suite\": \"%s\", \"warmup\": %zu, \"results\": [", name,
+               suite->warmup);
+    else
+        printf("== %s ==\n", name);
+}
+
+static inline int b_bench_cmp_double(const void* lhs, const void* rhs) {
+    double a = *(const double*)lhs;
+    double b = *(const double*)rhs;
+    return (a > b) - (a < b);
+}
+
+// The nearest-rank percentile of sorted samples.
+static inline double b_bench_percentile(const double* sorted, size_t n,
+                                        double pct) {
+    size_t rank = (size_t)(pct * (double)n + 0.999999);
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+static inline void b_bench_print_json_string(const char* str) {
+    putchar('"');
+    for (; *str != '\0'; str++) {
+        if (*str == '"' || *str == '\\')
+            putchar('\\');
+        putchar(*str);
+    }
+    putchar('"');
+}
+
+// Whether the suite's filter lets the case named `name` run.
+static inline bool b_bench_selected(const BenchSuite* suite,
+                                    const char* name) {
+    return suite->filter == NULL || strstr(name, suite->filter) != NULL;
+}
+
+static inline void b_bench_run(BenchSuite* suite, const BenchCase* bc) {
+    size_t reps = bc->reps != 0 && bc->reps < suite->reps ? bc->reps
+                                                           : suite->reps;
+    double* secs;
+    double* cycles;
+    double median, p99, median_cycles;
+
+    if (!b_bench_selected(suite, bc->name))
+        return;
+
+    secs = malloc(reps * sizeof(double));
+    cycles = malloc(reps * sizeof(double));
+    if (secs == NULL || cycles == NULL) {
+        free(secs);
+        free(cycles);
+        return;
+    }
+
+    for (size_t i = 0; i < suite->warmup; i++) {
+        if (bc->setup != NULL)
+            bc->setup(bc->arg);
+        bc->run(bc->arg);
+    }
+
+    for (size_t i = 0; i < reps; i++) {
+        double start;
+        uint64_t startcycles;
+
+        if (bc->setup != NULL)
+            bc->setup(bc->arg);
+
+        startcycles = b_bench_cycles();
+        start = b_bench_now();
+        bc->run(bc->arg);
+        secs[i] = b_bench_now() - start;
+        cycles[i] = (double)(b_bench_cycles() - startcycles);
+    }
+
+    qsort(secs, reps, sizeof(double), b_bench_cmp_double);
+    qsort(cycles, reps, sizeof(double), b_bench_cmp_double);
+    median = b_bench_percentile(secs, reps, 0.5);
+    p99 = b_bench_percentile(secs, reps, 0.99);
+    median_cycles = b_bench_percentile(cycles, reps, 0.5);
+
+    if (suite->json) {
+        printf("%s\n  {\"name\": ", suite->nresults > 0 ? "," : "");
+        b_bench_print_json_string(bc->name);
+        printf(", \"reps\": %zu, \"ops\": %zu, \"bytes\": %zu, "
+               "\"median_ns\": %.0f, \"p99_ns\": %.0f, \"min_ns\": %.0f, "
+               "\"ns_per_op\": %.3f, \"cycles_per_byte\": ",
+               reps, bc->ops, bc->bytes, median * 1e9, p99 * 1e9,
+               secs[0] * 1e9, median * 1e9 / (double)bc->ops);
+        if (BENCH_HAVE_CYCLES && bc->bytes > 0)
+            printf("%.4f", median_cycles / (double)bc->bytes);
+        else
+            printf("null");
+        for (size_t i = 0; i < bc->nextras; i++) {
+            printf(", ");
+            b_bench_print_json_string(bc->extras[i].name);
+            printf(": %.17g", *bc->extras[i].value);
+        }
+        putchar('}');
+    } else {
+        printf("%-44s %9.3f ms  p99 %9.3f ms  %9.2f ns/op", bc->name,
+               median * 1e3, p99 * 1e3, median * 1e9 / (double)bc->ops);
+        if (BENCH_HAVE_CYCLES && bc->bytes > 0)
+            printf("  %7.3f cyc/B", median_cycles / (double)bc->bytes);
+        for (size_t i = 0; i < bc->nextras; i++)
+            printf("  %.15g %s", *bc->extras[i].value, bc->extras[i].name);
+        putchar('\n');
+    }
+
+    fflush(stdout);
+    suite->nresults++;
+    free(secs);
+    free(cycles);
+}
+
+static inline int b_bench_finish(BenchSuite* suite) {
+    if (suite->json)
+        printf("\n]}\n");
+
+    return 0;
+}
@@ -0,0 +1,231 @@
+// All benchmarks are licensed under the unlicense. Do whatever you want with
+// these benchmarks
+
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "beanutils/beanutils.h"
+#include "bench.h"
+
+#define ITEMS     (1 << 20)
+#define ROUNDS    (1 << 20)
+#define SAWTEETH  16
+
+typedef enum {
+    WORKLOAD_FILL,
+    WORKLOAD_OSCILLATE,
+    WORKLOAD_SAWTOOTH,
+} Workload;
+
+static const char* workload_names[] = {"fill", "oscillate", "sawtooth"};
+static const char* growth_names[] = {"2x", "1.5x", "page", "exact"};
+static const char* shrink_names[] = {"hysteresis", "explicit"};
+
+// Counts capacity changes, each of which is one `realloc`.
+static size_t reallocs;
+
+static void array_push(BeanArray* arr) {
+    size_t cap = arr->cap;
+
+    b_array_push(arr, NULL);
+    reallocs += arr->cap != cap;
+}
+
+static void array_pop(BeanArray* arr) {
+    size_t cap = arr->cap;
+
+    b_array_pop(arr);
+    reallocs += arr->cap != cap;
+}
+
+static size_t run_array(Workload workload, BeanGrowthPolicy policy) {
+    BeanArray arr = {0};
+    size_t ops = 0;
+
+    b_array_init(&arr);
+    b_array_set_free_fn(&arr, b_array_free_nothing);
+    b_array_set_policy(&arr, policy);
+
+    switch (workload) {
+        case WORKLOAD_FILL:
+            for (; ops < ITEMS; ops++)
+                array_push(&arr);
+            break;
+        case WORKLOAD_OSCILLATE:
+            // Fill up to a capacity boundary, then push and pop across it.
+            while (arr.len < ITEMS / 16 || arr.len < arr.cap)
+                array_push(&arr);
+            for (; ops < ROUNDS; ops += 2) {
+                array_push(&arr);
+                array_pop(&arr);
+            }
+            break;
+        case WORKLOAD_SAWTOOTH:
+            for (int i = 0; i < SAWTEETH; i++) {
+                while (arr.len < ITEMS / 4) {
+                    array_push(&arr);
+                    ops++;
+                }
+                while (arr.len > ITEMS / 64) {
+                    array_pop(&arr);
+                    ops++;
+                }
+            }
+            break;
+    }
+
+    b_array_deinit(&arr);
+
+    return ops;
+}
+
+static void string_push(BeanString* str) {
+    size_t cap = str->cap;
+
+    b_string_push(str, 'x');
+    reallocs += str->cap != cap;
+}
+
+static void string_pop(BeanString* str) {
+    size_t cap = str->cap;
+
+    b_string_remove(str, str->len - 1);
+    reallocs += str->cap != cap;
+}
+
+static size_t run_string(Workload workload, BeanGrowthPolicy policy) {
+    BeanString str = {0};
+    size_t ops = 0;
+
+    b_string_init(&str);
+    b_string_set_policy(&str, policy);
+
+    switch (workload) {
+        case WORKLOAD_FILL:
+            for (; ops < ITEMS; ops++)
+                string_push(&str);
+            break;
+        case WORKLOAD_OSCILLATE:
+            while (str.len < ITEMS / 16 || str.len < str.cap)
+                string_push(&str);
+            for (; ops < ROUNDS; ops += 2) {
+                string_push(&str);
+                string_pop(&str);
+            }
+            break;
+        case WORKLOAD_SAWTOOTH:
+            for (int i = 0; i < SAWTEETH; i++) {
+                while (str.len < ITEMS / 4) {
+                    string_push(&str);
+                    ops++;
+                }
+                while (str.len > ITEMS / 64) {
+                    string_pop(&str);
+                    ops++;
+                }
+            }
+            break;
+    }
+
+    b_string_deinit(&str);
+
+    return ops;
+}
+
+typedef struct {
+    bool string;
+    Workload workload;
+    BeanGrowthPolicy policy;
+    double reallocs;
+    double peak_rss;
+} GrowthCase;
+
+static void run_growth(void* arg) {
+    GrowthCase* gc = arg;
+    struct rusage usage;
+
+    reallocs = 0;
+    if (gc->string)
+        run_string(gc->workload, gc->policy);
+    else
+        run_array(gc->workload, gc->policy);
+
+    getrusage(RUSAGE_SELF, &usage);
+    gc->reallocs = (double)reallocs;
+    gc->peak_rss = (double)usage.ru_maxrss;
+}
+
+// The operations one run of `workload` performs.
+static size_t workload_ops(Workload workload) {
+    switch (workload) {
+        case WORKLOAD_FILL:
+            return ITEMS;
+        case WORKLOAD_OSCILLATE:
+            return ROUNDS;
+        case WORKLOAD_SAWTOOTH:
+            return ITEMS / 4 + (2 * SAWTEETH - 1) * (ITEMS / 4 - ITEMS / 64);
+    }
+
+    return 1;
+}
+
+// Each case runs in its own process, so the peak RSS is its own.
+static void run_case(BenchSuite* suite, bool string, Workload workload,
+                     BeanGrowthPolicy policy) {
+    GrowthCase gc = {.string = string, .workload = workload, .policy = policy};
+    const BenchExtra extras[] = {
+        {.name = "reallocs", .value = &gc.reallocs},
+        {.name = "peak_rss_kib", .value = &gc.peak_rss},
+    };
+    char name[64];
+    pid_t pid;
+
+    snprintf(name, sizeof(name), "%s %s (%s, %s)",
+             string ? "BeanString" : "BeanArray", workload_names[workload],
+             growth_names[policy.growth], shrink_names[policy.shrink]);
+    if (!b_bench_selected(suite, name))
+        return;
+
+    fflush(stdout);
+    if ((pid = fork()) == 0) {
+        b_bench_run(suite, &(BenchCase){
+                               .name = name,
+                               .run = run_growth,
+                               .arg = &gc,
+                               .ops = workload_ops(workload),
+                               .extras = extras,
+                               .nextras = 2,
+                           });
+        _exit(EXIT_SUCCESS);
+    }
+
+    waitpid(pid, NULL, 0);
+    suite->nresults++;
+}
+
+int main(int argc, char** argv) {
+    BenchSuite suite;
+
+    b_bench_init(&suite, "growth", argc, argv);
+
+    for (int string = 0; string < 2; string++) {
+        for (Workload w = WORKLOAD_FILL; w <= WORKLOAD_SAWTOOTH; w++) {
+            for (b_growth_t g = GROWTH_GEOMETRIC_2X; g <= GROWTH_EXACT; g++) {
+                for (b_shrink_t s = SHRINK_HYSTERESIS; s <= SHRINK_EXPLICIT;
+                     s++) {
+                    BeanGrowthPolicy policy = {.growth = g, .shrink = s};
+
+                    // Shrinking never happens while filling.
+                    if (w == WORKLOAD_FILL && s != SHRINK_HYSTERESIS)
+                        continue;
+
+                    run_case(&suite, string, w, policy);
+                }
+            }
+        }
+    }
+
+    return b_bench_finish(&suite);
+}
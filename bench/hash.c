@@ -0,0 +1,73 @@
+// All benchmarks are licensed under the unlicense. Do whatever you want with
+// these benchmarks
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "beanutils/beanutils.h"
+#include "bench.h"
+
+#define TOTAL_BYTES (64 * 1024 * 1024)
+
+typedef struct {
+    const unsigned char* data;
+    size_t len;
+} HashCase;
+
+static volatile uint64_t sink;
+
+static void run_hash(void* arg) {
+    HashCase* hc = arg;
+    size_t rounds = TOTAL_BYTES / hc->len;
+
+    for (size_t r = 0; r < rounds; r++)
+        sink += b_hash_bytes(hc->data, hc->len, r);
+}
+
+int main(int argc, char** argv) {
+    static const b_simdlevel_t levels[] = {SIMDLEVEL_SCALAR, SIMDLEVEL_AVX2};
+    static const char* levelnames[] = {"scalar", "sse2", "avx2"};
+    static const size_t lengths[] = {8,    16,   32,    64,        256,
+                                     1024, 4096, 65536, 1024 * 1024};
+    size_t maxlen = lengths[sizeof(lengths) / sizeof(lengths[0]) - 1];
+    unsigned char* data = malloc(maxlen);
+    BenchSuite suite;
+    char name[64];
+
+    b_bench_init(&suite, "hash", argc, argv);
+
+    srand(1);
+    for (size_t i = 0; i < maxlen; i++)
+        data[i] = (unsigned char)rand();
+
+    // The long path only has scalar and AVX2 kernels, and short inputs never
+    // reach it, so those are only run once.
+    for (size_t l = 0; l < sizeof(levels) / sizeof(levels[0]); l++) {
+        b_simdlevel_t level = levels[l];
+
+        b_simd_set_level(level);
+        if (b_simd_level() != level)
+            continue;
+
+        for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+            HashCase hc = {.data = data, .len = lengths[i]};
+
+            if (hc.len <= 64 && level != SIMDLEVEL_SCALAR)
+                continue;
+
+            snprintf(name, sizeof(name), "b_hash_bytes %7zu B (%s)", hc.len,
+                     levelnames[level]);
+            b_bench_run(&suite, &(BenchCase){
+                                    .name = name,
+                                    .run = run_hash,
+                                    .arg = &hc,
+                                    .ops = TOTAL_BYTES / hc.len,
+                                    .bytes = TOTAL_BYTES,
+                                });
+        }
+    }
+
+    free(data);
+
+    return b_bench_finish(&suite);
+}
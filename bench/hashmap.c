@@ -0,0 +1,110 @@
+// All benchmarks are licensed under the unlicense. Do whatever you want with
+// these benchmarks
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "beanutils/beanutils.h"
+#include "bench.h"
+
+#define KEYS   (1 << 18)
+#define KEYLEN 16
+
+static char keydata[2 * KEYS][KEYLEN];
+static BeanStringView keys[2 * KEYS];
+static BeanHashMap filled;
+static volatile uint64_t sink;
+
+static void run_insert(void* arg) {
+    BeanHashMap map = {0};
+
+    (void)arg;
+    b_hashmap_init(&map, sizeof(uint64_t));
+    for (uint64_t i = 0; i < KEYS; i++)
+        b_hashmap_insert(&map, &keys[i], &i);
+    sink += map.len;
+    b_hashmap_deinit(&map);
+}
+
+static void run_insert_reserved(void* arg) {
+    BeanHashMap map = {0};
+
+    (void)arg;
+    b_hashmap_init(&map, sizeof(uint64_t));
+    b_hashmap_reserve(&map, KEYS);
+    for (uint64_t i = 0; i < KEYS; i++)
+        b_hashmap_insert(&map, &keys[i], &i);
+    sink += map.len;
+    b_hashmap_deinit(&map);
+}
+
+// The first `KEYS` keys are in `filled` and the rest are not.
+static void run_get(void* arg) {
+    size_t offset = *(const size_t*)arg;
+    uint64_t sum = 0;
+
+    for (size_t i = 0; i < KEYS; i++) {
+        uint64_t* val = b_hashmap_get(&filled, &keys[offset + i]);
+
+        sum += val != NULL ? *val : 1;
+    }
+    sink += sum;
+}
+
+static void fill(void* arg) {
+    (void)arg;
+    for (uint64_t i = 0; i < KEYS; i++)
+        b_hashmap_insert(&filled, &keys[i], &i);
+}
+
+static void run_erase(void* arg) {
+    (void)arg;
+    for (size_t i = 0; i < KEYS; i++)
+        b_hashmap_erase(&filled, &keys[i]);
+}
+
+int main(int argc, char** argv) {
+    BenchSuite suite;
+
+    b_bench_init(&suite, "hashmap", argc, argv);
+
+    for (size_t i = 0; i < 2 * KEYS; i++) {
+        snprintf(keydata[i], KEYLEN, "key-%010zu", i);
+        keys[i] = (BeanStringView){.data = keydata[i], .len = KEYLEN - 1};
+    }
+    b_hashmap_init(&filled, sizeof(uint64_t));
+    fill(NULL);
+
+    b_bench_run(&suite, &(BenchCase){
+                            .name = "b_hashmap_insert",
+                            .run = run_insert,
+                            .ops = KEYS,
+                        });
+    b_bench_run(&suite, &(BenchCase){
+                            .name = "b_hashmap_insert (reserved)",
+                            .run = run_insert_reserved,
+                            .ops = KEYS,
+                        });
+    b_bench_run(&suite, &(BenchCase){
+                            .name = "b_hashmap_get (hit)",
+                            .run = run_get,
+                            .arg = &(size_t){0},
+                            .ops = KEYS,
+                        });
+    b_bench_run(&suite, &(BenchCase){
+                            .name = "b_hashmap_get (miss)",
+                            .run = run_get,
+                            .arg = &(size_t){KEYS},
+                            .ops = KEYS,
+                        });
+    b_bench_run(&suite, &(BenchCase){
+                            .name = "b_hashmap_erase",
+                            .setup = fill,
+                            .run = run_erase,
+                            .ops = KEYS,
+                        });
+
+    b_hashmap_deinit(&filled);
+
+    return b_bench_finish(&suite);
+}
@@ -0,0 +1,92 @@
+// All benchmarks are licensed under the unlicense. Do whatever you want with
+// these benchmarks
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include "beanutils/beanutils.h"
+#include "bench.h"
+
+#define WORDS   (1 << 17)
+#define WORDLEN 12
+#define LOOKUPS (1 << 20)
+
+static char worddata[WORDS][WORDLEN];
+static BeanStringView words[WORDS];
+static BeanInterner filled;
+static atomic_uintptr_t sink;
+
+static void run_intern_new(void* arg) {
+    BeanInterner interner = {0};
+
+    (void)arg;
+    b_interner_init(&interner);
+    for (size_t i = 0; i < WORDS; i++)
+        b_interner_intern(&interner, &words[i]);
+    b_interner_deinit(&interner);
+}
+
+// Interns words that are already there, as when parsing repeated tokens.
+static void intern_range(size_t start, size_t finish, void* arg) {
+    uintptr_t acc = 0;
+
+    (void)arg;
+    for (size_t i = start; i < finish; i++)
+        acc ^= (uintptr_t)b_interner_intern(&filled, &words[i % WORDS]);
+
+    atomic_fetch_xor_explicit(&sink, acc, memory_order_relaxed);
+}
+
+static void run_intern_hit(void* arg) {
+    (void)arg;
+    intern_range(0, LOOKUPS, NULL);
+}
+
+static void run_intern_hit_parallel(void* arg) {
+    b_threadpool_parallel_for(arg, 0, LOOKUPS, 0, intern_range, NULL);
+}
+
+int main(int argc, char** argv) {
+    long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+    BenchSuite suite;
+    BeanThreadPool pool;
+    char name[64];
+
+    b_bench_init(&suite, "interner", argc, argv);
+
+    for (size_t i = 0; i < WORDS; i++) {
+        snprintf(worddata[i], WORDLEN, "w%010zu", i);
+        words[i] = (BeanStringView){.data = worddata[i], .len = WORDLEN - 1};
+    }
+    b_interner_init(&filled);
+    intern_range(0, WORDS, NULL);
+
+    b_bench_run(&suite, &(BenchCase){
+                            .name = "b_interner_intern (miss)",
+                            .run = run_intern_new,
+                            .ops = WORDS,
+                        });
+    b_bench_run(&suite, &(BenchCase){
+                            .name = "b_interner_intern (hit)",
+                            .run = run_intern_hit,
+                            .ops = LOOKUPS,
+                        });
+
+    if (b_threadpool_init(&pool, (size_t)ncpus) != STATUS_SUCCESS)
+        return 1;
+    snprintf(name, sizeof(name), "b_interner_intern (hit, %ld workers)",
+             ncpus);
+    b_bench_run(&suite, &(BenchCase){
+                            .name = name,
+                            .run = run_intern_hit_parallel,
+                            .arg = &pool,
+                            .ops = LOOKUPS,
+                        });
+    b_threadpool_deinit(&pool);
+
+    b_interner_deinit(&filled);
+
+    return b_bench_finish(&suite);
+}
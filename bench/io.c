@@ -0,0 +1,113 @@
+// All benchmarks are licensed under the unlicense. Do whatever you want with
+// these benchmarks
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "beanutils/beanutils.h"
+#include "bench.h"
+
+static volatile uint64_t sink;
+
+// The byte-at-a-time loop `b_file_read` used to be, kept for comparison.
+static BeanString read_bytewise(FILE* file) {
+    BeanString res = {0};
+    int currch;
+
+    b_string_init(&res);
+    while ((currch = fgetc(file)) != EOF)
+        b_string_push(&res, (char)currch);
+
+    return res;
+}
+
+static uint64_t checksum(const char* data, size_t len) {
+    uint64_t sum = 0;
+
+    for (size_t i = 0; i < len; i += 64)
+        sum += (unsigned char)data[i];
+
+    return sum;
+}
+
+static void rewind_file(void* arg) {
+    rewind(arg);
+}
+
+static void run_bytewise(void* arg) {
+    BeanString str = read_bytewise(arg);
+
+    sink += checksum(b_string_data(&str), str.len);
+    b_string_deinit(&str);
+}
+
+static void run_read(void* arg) {
+    BeanString str = b_file_read(arg);
+
+    sink += checksum(b_string_data(&str), str.len);
+    b_string_deinit(&str);
+}
+
+static void run_map(void* arg) {
+    BeanMappedFile map;
+
+    b_file_map(arg, &map);
+    sink += checksum(map.data, map.len);
+    b_file_unmap(&map);
+}
+
+int main(int argc, char** argv) {
+    const size_t sizes[] = {4 * 1024, 1024 * 1024, 64 * 1024 * 1024};
+    BenchSuite suite;
+    char name[64];
+
+    b_bench_init(&suite, "io", argc, argv);
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        size_t size = sizes[i];
+        FILE* file = tmpfile();
+        char* payload = malloc(size);
+
+        for (size_t j = 0; j < size; j++)
+            payload[j] = (char)('a' + j % 26);
+        fwrite(payload, 1, size, file);
+        fflush(file);
+        free(payload);
+
+        snprintf(name, sizeof(name), "fgetc+push  %9zu bytes", size);
+        b_bench_run(&suite, &(BenchCase){
+                                .name = name,
+                                .setup = rewind_file,
+                                .run = run_bytewise,
+                                .arg = file,
+                                .ops = size,
+                                .bytes = size,
+                                .reps = 3,
+                            });
+
+        snprintf(name, sizeof(name), "b_file_read %9zu bytes", size);
+        b_bench_run(&suite, &(BenchCase){
+                                .name = name,
+                                .setup = rewind_file,
+                                .run = run_read,
+                                .arg = file,
+                                .ops = size,
+                                .bytes = size,
+                            });
+
+        snprintf(name, sizeof(name), "b_file_map  %9zu bytes", size);
+        b_bench_run(&suite, &(BenchCase){
+                                .name = name,
+                                .setup = rewind_file,
+                                .run = run_map,
+                                .arg = file,
+                                .ops = size,
+                                .bytes = size,
+                            });
+
+        fclose(file);
+    }
+
+    return b_bench_finish(&suite);
+}
@@ -0,0 +1,73 @@
+// All benchmarks are licensed under the unlicense. Do whatever you want with
+// these benchmarks
+
+#include <stdio.h>
+
+#include "beanutils/beanutils.h"
+#include "bench.h"
+
+#define MESSAGES (1 << 16)
+
+static void run_log(void* arg) {
+    (void)arg;
+    for (int i = 0; i < MESSAGES; i++)
+        b_log(LOGLEVEL_LOG, "request %d took %d us (%s)", i, i % 977, "ok");
+    b_log_flush();
+}
+
+static void run_log_deferred(void* arg) {
+    (void)arg;
+    for (int i = 0; i < MESSAGES; i++)
+        B_LOG_DEFERRED(LOGLEVEL_LOG, "request %d took %d us (%s)", i, i % 977,
+                       "ok");
+    b_log_flush();
+}
+
+int main(int argc, char** argv) {
+    BenchSuite suite;
+    FILE* sink = fopen("/dev/null", "w");
+
+    if (sink == NULL)
+        return 1;
+
+    b_bench_init(&suite, "logger", argc, argv);
+
+    // Synchronous messages go to the standard error; keep them off the
+    // terminal.
+    if (freopen("/dev/null", "w", stderr) == NULL)
+        return 1;
+
+    b_bench_run(&suite, &(BenchCase){
+                            .name = "b_log (sync)",
+                            .run = run_log,
+                            .ops = MESSAGES,
+                        });
+
+    b_log_async_start(&(BeanLogConfig){
+        .overflow = LOGOVERFLOW_BLOCK,
+        .format = LOGFORMAT_TEXT,
+        .output = sink,
+    });
+    b_bench_run(&suite, &(BenchCase){
+                            .name = "b_log (async text)",
+                            .run = run_log,
+                            .ops = MESSAGES,
+                        });
+    b_log_async_stop();
+
+    b_log_async_start(&(BeanLogConfig){
+        .overflow = LOGOVERFLOW_BLOCK,
+        .format = LOGFORMAT_BINARY,
+        .output = sink,
+    });
+    b_bench_run(&suite, &(BenchCase){
+                            .name = "B_LOG_DEFERRED (async binary)",
+                            .run = run_log_deferred,
+                            .ops = MESSAGES,
+                        });
+    b_log_async_stop();
+
+    fclose(sink);
+
+    return b_bench_finish(&suite);
+}
@@ -0,0 +1,119 @@
+// All benchmarks are licensed under the unlicense. Do whatever you want with
+// these benchmarks
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "beanutils/beanutils.h"
+#include "bench.h"
+
+#define ELEMS (1 << 20)
+#define WORK  64
+
+static uint64_t values[ELEMS];
+static void* elems[ELEMS];
+static BeanArrayView view = {.elems = elems, .len = ELEMS};
+static volatile uint64_t sink;
+
+// A fixed amount of CPU-bound work per element.
+static uint64_t churn(uint64_t x) {
+    for (int r = 0; r < WORK; r++)
+        x = x * 6364136223846793005u + 1442695040888963407u;
+    return x;
+}
+
+static void touch(void* elem, void* arg) {
+    (void)arg;
+    *(uint64_t*)elem = churn(*(uint64_t*)elem);
+}
+
+static void fold(void* acc, const void* elem, void* arg) {
+    (void)arg;
+    *(uint64_t*)acc += churn(*(const uint64_t*)elem);
+}
+
+static void combine(void* acc, const void* partial, void* arg) {
+    (void)arg;
+    *(uint64_t*)acc += *(const uint64_t*)partial;
+}
+
+static bool is_odd(const void* elem, void* arg) {
+    (void)arg;
+    return churn(*(const uint64_t*)elem) & 1;
+}
+
+static void run_for_each_serial(void* arg) {
+    (void)arg;
+    for (size_t i = 0; i < ELEMS; i++)
+        touch(elems[i], NULL);
+}
+
+static void run_for_each(void* arg) {
+    (void)arg;
+    b_arrview_for_each(&view, touch, NULL, 0);
+}
+
+static void run_reduce_serial(void* arg) {
+    uint64_t acc = 0;
+
+    (void)arg;
+    for (size_t i = 0; i < ELEMS; i++)
+        fold(&acc, elems[i], NULL);
+    sink += acc;
+}
+
+static void run_reduce(void* arg) {
+    uint64_t acc = 0;
+
+    (void)arg;
+    b_arrview_reduce(&view, &acc, sizeof(acc), fold, combine, NULL, 0);
+    sink += acc;
+}
+
+static void run_filter(void* arg) {
+    BeanArrayView out;
+
+    (void)arg;
+    b_arrview_filter(&view, &out, is_odd, NULL, 0);
+    sink += out.len;
+    free(out.elems);
+}
+
+int main(int argc, char** argv) {
+    BenchSuite suite;
+
+    b_bench_init(&suite, "parallel", argc, argv);
+
+    for (size_t i = 0; i < ELEMS; i++) {
+        values[i] = i;
+        elems[i] = &values[i];
+    }
+
+    b_bench_run(&suite, &(BenchCase){
+                            .name = "for_each (serial loop)",
+                            .run = run_for_each_serial,
+                            .ops = ELEMS,
+                        });
+    b_bench_run(&suite, &(BenchCase){
+                            .name = "b_arrview_for_each",
+                            .run = run_for_each,
+                            .ops = ELEMS,
+                        });
+    b_bench_run(&suite, &(BenchCase){
+                            .name = "reduce (serial loop)",
+                            .run = run_reduce_serial,
+                            .ops = ELEMS,
+                        });
+    b_bench_run(&suite, &(BenchCase){
+                            .name = "b_arrview_reduce",
+                            .run = run_reduce,
+                            .ops = ELEMS,
+                        });
+    b_bench_run(&suite, &(BenchCase){
+                            .name = "b_arrview_filter",
+                            .run = run_filter,
+                            .ops = ELEMS,
+                        });
+
+    return b_bench_finish(&suite);
+}
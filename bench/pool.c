@@ -0,0 +1,67 @@
+// All benchmarks are licensed under the unlicense. Do whatever you want with
+// these benchmarks
+
+#include <stdint.h>
+#include <string.h>
+
+#include "beanutils/beanutils.h"
+#include "bench.h"
+
+#define ELEMS 1000000
+
+typedef struct {
+    uint64_t id;
+    double value;
+    uint32_t flags;
+} Record;
+
+static void run(void* arg) {
+    BeanPool* pool = arg;
+    BeanArray arr = {0};
+    BeanArray clone = {0};
+
+    b_array_init_with_size(&arr, ELEMS);
+    if (pool != NULL)
+        b_array_bind_pool(&arr, pool);
+
+    for (size_t i = 0; i < ELEMS; i++) {
+        Record* rec = b_array_alloc_elem(&arr, sizeof(Record));
+        *rec = (Record){.id = i, .value = (double)i, .flags = 0};
+        b_array_push(&arr, rec);
+    }
+
+    b_array_clone(&arr, &clone, sizeof(Record));
+
+    // Churn: recycle half of the elements.
+    for (size_t i = 0; i < ELEMS / 2; i++)
+        b_array_pop(&arr);
+    for (size_t i = 0; i < ELEMS / 2; i++)
+        b_array_push(&arr, b_array_alloc_elem(&arr, sizeof(Record)));
+
+    b_array_deinit(&clone);
+    b_array_deinit(&arr);
+}
+
+int main(int argc, char** argv) {
+    BenchSuite suite;
+    BeanPool pool = {0};
+
+    b_bench_init(&suite, "pool", argc, argv);
+
+    b_bench_run(&suite, &(BenchCase){
+                            .name = "array elements via malloc",
+                            .run = run,
+                            .ops = (size_t)ELEMS * 3,
+                        });
+
+    b_pool_init(&pool, sizeof(Record));
+    b_bench_run(&suite, &(BenchCase){
+                            .name = "array elements via BeanPool",
+                            .run = run,
+                            .arg = &pool,
+                            .ops = (size_t)ELEMS * 3,
+                        });
+    b_pool_deinit(&pool);
+
+    return b_bench_finish(&suite);
+}
@@ -0,0 +1,267 @@
+// All benchmarks are licensed under the unlicense. Do whatever you want with
+// these benchmarks
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#include "beanutils/beanutils.h"
+#include "bench.h"
+
+#define ITEMS (1 << 20)
+#define CAP   1024
+#define BATCH 32
+
+// A `BeanArray` behind a mutex, as a baseline.
+typedef struct {
+    pthread_mutex_t lock;
+    BeanArray array;
+} LockedStack;
+
+typedef enum {
+    KIND_LOCKED,
+    KIND_QUEUE,
+    KIND_QUEUE_BATCH,
+    KIND_BQUEUE,
+} QueueKind;
+
+typedef struct {
+    QueueKind kind;
+    long nthreads;
+} QueueCase;
+
+typedef struct {
+    QueueKind kind;
+    LockedStack* stack;
+    BeanQueue* queue;
+    BeanBlockingQueue* bqueue;
+    size_t count;
+} Worker;
+
+static bool locked_push(LockedStack* stack, void* elem) {
+    bool pushed = false;
+
+    pthread_mutex_lock(&stack->lock);
+    if (stack->array.len < CAP)
+        pushed = b_array_push(&stack->array, elem) == STATUS_SUCCESS;
+    pthread_mutex_unlock(&stack->lock);
+
+    return pushed;
+}
+
+static bool locked_pop(LockedStack* stack, void** elem) {
+    bool popped = false;
+
+    // `b_array_pop` frees the element, so take it by hand.
+    pthread_mutex_lock(&stack->lock);
+    if (stack->array.len > 0) {
+        *elem = stack->array.data[--stack->array.len];
+        popped = true;
+    }
+    pthread_mutex_unlock(&stack->lock);
+
+    return popped;
+}
+
+static void* producer(void* arg) {
+    Worker* w = arg;
+    void* elems[BATCH];
+
+    for (size_t i = 0; i < BATCH; i++)
+        elems[i] = (void*)(uintptr_t)(i + 1);
+
+    for (size_t i = 0; i < w->count;) {
+        size_t left = w->count - i;
+        size_t prev = i;
+
+        switch (w->kind) {
+            case KIND_LOCKED:
+                i += locked_push(w->stack, elems[0]);
+                break;
+            case KIND_QUEUE:
+                i += b_queue_push(w->queue, elems[0]);
+                break;
+            case KIND_QUEUE_BATCH:
+                i += b_queue_push_many(w->queue, elems,
+                                       left < BATCH ? left : BATCH);
+                break;
+            case KIND_BQUEUE:
+                b_bqueue_push(w->bqueue, elems[0]);
+                i++;
+                break;
+        }
+
+        // Let the other side run when there are more threads than CPUs.
+        if (i == prev)
+            sched_yield();
+    }
+
+    return NULL;
+}
+
+static void* consumer(void* arg) {
+    Worker* w = arg;
+    void* elems[BATCH];
+
+    for (size_t i = 0; i < w->count;) {
+        size_t left = w->count - i;
+        size_t prev = i;
+
+        switch (w->kind) {
+            case KIND_LOCKED:
+                i += locked_pop(w->stack, elems);
+                break;
+            case KIND_QUEUE:
+                i += b_queue_pop(w->queue, elems);
+                break;
+            case KIND_QUEUE_BATCH:
+                i += b_queue_pop_many(w->queue, elems,
+                                      left < BATCH ? left : BATCH);
+                break;
+            case KIND_BQUEUE:
+                i += b_bqueue_pop_many(w->bqueue, elems,
+                                       left < BATCH ? left : BATCH);
+                break;
+        }
+
+        // Let the other side run when there are more threads than CPUs.
+        if (i == prev)
+            sched_yield();
+    }
+
+    return NULL;
+}
+
+// Runs `nthreads` producers and as many consumers, moving `ITEMS` elements
+// in total.
+static void run(void* arg) {
+    QueueCase* qc = arg;
+    long nthreads = qc->nthreads;
+    LockedStack stack = {0};
+    BeanQueue queue;
+    BeanBlockingQueue bqueue;
+    pthread_t threads[2 * nthreads];
+    Worker worker;
+
+    pthread_mutex_init(&stack.lock, NULL);
+    b_array_init_with_size(&stack.array, CAP);
+    b_queue_init(&queue, CAP);
+    b_bqueue_init(&bqueue, CAP);
+
+    worker = (Worker){
+        .kind = qc->kind,
+        .stack = &stack,
+        .queue = &queue,
+        .bqueue = &bqueue,
+        .count = ITEMS / nthreads,
+    };
+
+    for (long i = 0; i < nthreads; i++) {
+        pthread_create(&threads[2 * i], NULL, producer, &worker);
+        pthread_create(&threads[2 * i + 1], NULL, consumer, &worker);
+    }
+    for (long i = 0; i < 2 * nthreads; i++)
+        pthread_join(threads[i], NULL);
+
+    stack.array.len = 0;
+    b_array_deinit(&stack.array);
+    pthread_mutex_destroy(&stack.lock);
+    b_queue_deinit(&queue);
+    b_bqueue_deinit(&bqueue);
+}
+
+typedef struct {
+    BeanRing ring;
+    bool batch;
+} RingWorker;
+
+static void* ring_producer(void* arg) {
+    RingWorker* w = arg;
+    void* elems[BATCH] = {0};
+
+    for (size_t i = 0; i < ITEMS;) {
+        size_t left = ITEMS - i;
+        size_t n = w->batch ? b_ring_push_many(&w->ring, elems,
+                                               left < BATCH ? left : BATCH)
+                            : b_ring_push(&w->ring, elems[0]);
+
+        if (n == 0)
+            sched_yield();
+        i += n;
+    }
+
+    return NULL;
+}
+
+static void run_ring(void* arg) {
+    bool batch = *(const bool*)arg;
+    RingWorker worker = {.batch = batch};
+    pthread_t thread;
+    void* elems[BATCH];
+
+    b_ring_init(&worker.ring, CAP);
+
+    pthread_create(&thread, NULL, ring_producer, &worker);
+    for (size_t i = 0; i < ITEMS;) {
+        size_t n = batch ? b_ring_pop_many(&worker.ring, elems, BATCH)
+                         : b_ring_pop(&worker.ring, elems);
+
+        if (n == 0)
+            sched_yield();
+        i += n;
+    }
+    pthread_join(thread, NULL);
+
+    b_ring_deinit(&worker.ring);
+}
+
+int main(int argc, char** argv) {
+    static const char* names[] = {
+        "mutex + BeanArray",
+        "BeanQueue",
+        "BeanQueue (batch)",
+        "BeanBlockingQueue",
+    };
+    long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+    BenchSuite suite;
+    char name[64];
+
+    b_bench_init(&suite, "queue", argc, argv);
+
+    b_bench_run(&suite, &(BenchCase){
+                            .name = "BeanRing (1:1)",
+                            .run = run_ring,
+                            .arg = &(bool){false},
+                            .ops = ITEMS,
+                        });
+    b_bench_run(&suite, &(BenchCase){
+                            .name = "BeanRing (1:1, batch)",
+                            .run = run_ring,
+                            .arg = &(bool){true},
+                            .ops = ITEMS,
+                        });
+
+    // 1, 2, 4, ... producer/consumer pairs, up to one thread per CPU.
+    for (long n = 1;; n *= 2) {
+        if (n > (ncpus + 1) / 2)
+            n = (ncpus + 1) / 2;
+
+        for (QueueKind kind = KIND_LOCKED; kind <= KIND_BQUEUE; kind++) {
+            QueueCase qc = {.kind = kind, .nthreads = n};
+
+            snprintf(name, sizeof(name), "%s (%ld:%ld)", names[kind], n, n);
+            b_bench_run(&suite, &(BenchCase){
+                                    .name = name,
+                                    .run = run,
+                                    .arg = &qc,
+                                    .ops = ITEMS,
+                                });
+        }
+
+        if (n == (ncpus + 1) / 2)
+            break;
+    }
+
+    return b_bench_finish(&suite);
+}
@@ -0,0 +1,103 @@
+// All benchmarks are licensed under the unlicense. Do whatever you want with
+// these benchmarks
+
+#define _GNU_SOURCE
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "beanutils/beanutils.h"
+#include "bench.h"
+
+#define HAYSTACK_SIZE (16 * 1024 * 1024)
+
+static const char* needle = "the needle we are looking for";
+static BeanString hay;
+static BeanString pattern;
+static volatile size_t sink;
+
+static void run_strstr(void* arg) {
+    const char* data = b_string_data(&hay);
+
+    (void)arg;
+    sink += (size_t)(strstr(data, needle) - data);
+}
+
+static void run_memmem(void* arg) {
+    const char* data = b_string_data(&hay);
+
+    (void)arg;
+    sink += (size_t)((char*)memmem(data, hay.len, needle, pattern.len) - data);
+}
+
+static void run_find(void* arg) {
+    (void)arg;
+    sink += b_string_find(&hay, &pattern, 0);
+}
+
+static void run_find_byte(void* arg) {
+    (void)arg;
+    sink += b_string_find_byte(&hay, '!', 0);
+}
+
+int main(int argc, char** argv) {
+    static const char* levelnames[] = {"scalar", "sse2", "avx2"};
+    size_t needlelen = strlen(needle);
+    BenchSuite suite;
+    char* data;
+    char name[64];
+
+    b_bench_init(&suite, "search", argc, argv);
+
+    // Lowercase text with plenty of partial matches, and the needle at the
+    // very end.
+    b_string_init_with_capacity(&hay, HAYSTACK_SIZE);
+    data = b_string_data(&hay);
+    srand(1);
+    for (size_t i = 0; i < HAYSTACK_SIZE - needlelen; i++)
+        data[i] = (rand() % 8 == 0) ? ' ' : (char)('a' + rand() % 26);
+    memcpy(&data[HAYSTACK_SIZE - needlelen], needle, needlelen + 1);
+    hay.len = HAYSTACK_SIZE;
+    b_string_init_with_cstr(&pattern, needle);
+
+    b_bench_run(&suite, &(BenchCase){
+                            .name = "strstr",
+                            .run = run_strstr,
+                            .ops = HAYSTACK_SIZE,
+                            .bytes = HAYSTACK_SIZE,
+                        });
+    b_bench_run(&suite, &(BenchCase){
+                            .name = "memmem",
+                            .run = run_memmem,
+                            .ops = HAYSTACK_SIZE,
+                            .bytes = HAYSTACK_SIZE,
+                        });
+
+    for (int level = SIMDLEVEL_SCALAR; level <= SIMDLEVEL_AVX2; level++) {
+        b_simd_set_level((b_simdlevel_t)level);
+        if ((int)b_simd_level() != level)
+            continue;
+
+        snprintf(name, sizeof(name), "b_string_find (%s)", levelnames[level]);
+        b_bench_run(&suite, &(BenchCase){
+                                .name = name,
+                                .run = run_find,
+                                .ops = HAYSTACK_SIZE,
+                                .bytes = HAYSTACK_SIZE,
+                            });
+
+        snprintf(name, sizeof(name), "b_string_find_byte (%s)",
+                 levelnames[level]);
+        b_bench_run(&suite, &(BenchCase){
+                                .name = name,
+                                .run = run_find_byte,
+                                .ops = HAYSTACK_SIZE,
+                                .bytes = HAYSTACK_SIZE,
+                            });
+    }
+
+    b_string_deinit(&hay);
+    b_string_deinit(&pattern);
+
+    return b_bench_finish(&suite);
+}
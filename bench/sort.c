@@ -0,0 +1,99 @@
+// All benchmarks are licensed under the unlicense. Do whatever you want with
+// these benchmarks
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "beanutils/beanutils.h"
+#include "bench.h"
+
+#define RECORDS (1024 * 1024)
+
+typedef struct {
+    uint64_t key;
+    uint64_t payload;
+} Record;
+
+static Record* records;
+static BeanArray array;
+
+static int cmp_records(const void* lhs, const void* rhs) {
+    const Record* a = lhs;
+    const Record* b = rhs;
+    return (a->key > b->key) - (a->key < b->key);
+}
+
+// qsort hands over pointers into the `void*` buffer.
+static int cmp_records_qsort(const void* lhs, const void* rhs) {
+    return cmp_records(*(void* const*)lhs, *(void* const*)rhs);
+}
+
+static uint64_t record_key(const void* elem) {
+    return ((const Record*)elem)->key;
+}
+
+static void reset(void* arg) {
+    (void)arg;
+    for (size_t i = 0; i < RECORDS; i++)
+        array.data[i] = &records[i];
+    array.len = RECORDS;
+}
+
+static void run_qsort(void* arg) {
+    (void)arg;
+    qsort(array.data, array.len, sizeof(void*), cmp_records_qsort);
+}
+
+static void run_sort(void* arg) {
+    (void)arg;
+    b_array_sort(&array, cmp_records);
+}
+
+static void run_sort_parallel(void* arg) {
+    (void)arg;
+    b_array_sort_parallel(&array, cmp_records, NULL);
+}
+
+static void run_radix_sort(void* arg) {
+    (void)arg;
+    b_array_radix_sort(&array, record_key);
+}
+
+int main(int argc, char** argv) {
+    static const struct {
+        const char* name;
+        void (*run)(void* arg);
+    } cases[] = {
+        {"qsort", run_qsort},
+        {"b_array_sort", run_sort},
+        {"b_array_sort_parallel", run_sort_parallel},
+        {"b_array_radix_sort", run_radix_sort},
+    };
+    BenchSuite suite;
+
+    b_bench_init(&suite, "sort", argc, argv);
+
+    records = malloc(RECORDS * sizeof(Record));
+    srand(1);
+    for (size_t i = 0; i < RECORDS; i++)
+        records[i] = (Record){
+            .key = ((uint64_t)rand() << 31) ^ (uint64_t)rand(),
+            .payload = i,
+        };
+    b_array_init_with_size(&array, RECORDS);
+    b_array_set_free_fn(&array, b_array_free_nothing);
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+        b_bench_run(&suite, &(BenchCase){
+                                .name = cases[i].name,
+                                .setup = reset,
+                                .run = cases[i].run,
+                                .ops = RECORDS,
+                            });
+
+    b_array_deinit(&array);
+    free(records);
+
+    return b_bench_finish(&suite);
+}
@@ -0,0 +1,138 @@
+// All benchmarks are licensed under the unlicense. Do whatever you want with
+// these benchmarks
+
+#include <string.h>
+
+#include "beanutils/beanutils.h"
+#include "bench.h"
+
+#define CHARS  (1 << 22)
+#define WORD   "sixteen chars!!\n"
+#define CLONES (1 << 16)
+
+static BeanString text;
+static volatile size_t sink;
+
+static void run_push(void* arg) {
+    BeanString str = {0};
+
+    (void)arg;
+    b_string_init(&str);
+    for (size_t i = 0; i < CHARS; i++)
+        b_string_push(&str, (char)('a' + i % 26));
+    sink += str.len;
+    b_string_deinit(&str);
+}
+
+static void run_push_cstr(void* arg) {
+    BeanString str = {0};
+
+    (void)arg;
+    b_string_init(&str);
+    for (size_t i = 0; i < CHARS; i += strlen(WORD))
+        b_string_push_cstr(&str, WORD);
+    sink += str.len;
+    b_string_deinit(&str);
+}
+
+static void run_builder(void* arg) {
+    BeanStringBuilder sb;
+    BeanString str = {0};
+
+    (void)arg;
+    b_strbuilder_init(&sb);
+    for (size_t i = 0; i < CHARS; i += strlen(WORD))
+        b_strbuilder_append_cstr(&sb, WORD);
+    b_strbuilder_finalize(&sb, &str);
+    sink += str.len;
+    b_string_deinit(&str);
+    b_strbuilder_deinit(&sb);
+}
+
+// Shares the buffer of `text` and lets go of it.
+static void run_clone(void* arg) {
+    (void)arg;
+    for (size_t i = 0; i < CLONES; i++) {
+        BeanString clone = b_string_clone(&text);
+
+        sink += clone.len;
+        b_string_deinit(&clone);
+    }
+}
+
+// Every clone is written to, so every clone copies the buffer.
+static void run_clone_write(void* arg) {
+    (void)arg;
+    for (size_t i = 0; i < CLONES / 64; i++) {
+        BeanString clone = b_string_clone(&text);
+
+        b_string_push(&clone, '!');
+        sink += clone.len;
+        b_string_deinit(&clone);
+    }
+}
+
+static void run_replace(void* arg) {
+    BeanString str = b_string_clone(&text);
+    BeanString needle = {0};
+    BeanString repl = {0};
+
+    (void)arg;
+    b_string_init_with_cstr(&needle, "chars");
+    b_string_init_with_cstr(&repl, "characters");
+    b_string_replace_all(&str, &needle, &repl);
+    sink += str.len;
+    b_string_deinit(&repl);
+    b_string_deinit(&needle);
+    b_string_deinit(&str);
+}
+
+int main(int argc, char** argv) {
+    BenchSuite suite;
+
+    b_bench_init(&suite, "string", argc, argv);
+
+    b_string_init(&text);
+    while (text.len < CHARS)
+        b_string_push_cstr(&text, WORD);
+
+    b_bench_run(&suite, &(BenchCase){
+                            .name = "b_string_push",
+                            .run = run_push,
+                            .ops = CHARS,
+                            .bytes = CHARS,
+                        });
+    b_bench_run(&suite, &(BenchCase){
+                            .name = "b_string_push_cstr (16 B)",
+                            .run = run_push_cstr,
+                            .ops = CHARS / strlen(WORD),
+                            .bytes = CHARS,
+                        });
+    b_bench_run(&suite, &(BenchCase){
+                            .name = "b_strbuilder_append_cstr (16 B)",
+                            .run = run_builder,
+                            .ops = CHARS / strlen(WORD),
+                            .bytes = CHARS,
+                        });
+    b_bench_run(&suite, &(BenchCase){
+                            .name = "b_string_clone (4 MiB, shared)",
+                            .run = run_clone,
+                            .ops = CLONES,
+                        });
+    b_bench_run(&suite, &(BenchCase){
+                            .name = "b_string_clone (4 MiB, written)",
+                            .run = run_clone_write,
+                            .ops = CLONES / 64,
+                            .bytes = (size_t)CLONES / 64 * CHARS,
+                        });
+    b_bench_run(&suite, &(BenchCase){
+                            .name = "b_string_replace_all",
+                            .run = run_replace,
+                            .ops = 1,
+                            .bytes = CHARS,
+                        });
+
+    b_string_deinit(&text);
+
+    return b_bench_finish(&suite);
+}
@@ -0,0 +1,78 @@
+// All benchmarks are licensed under the unlicense. Do whatever you want with
+// these benchmarks
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#include "beanutils/beanutils.h"
+#include "bench.h"
+
+#define ITEMS (1 << 18)
+#define WORK  200
+
+static atomic_uint_fast64_t sink;
+
+// A fixed amount of CPU-bound work per index.
+static void spin_range(size_t start, size_t finish, void* arg) {
+    uint64_t acc = 0;
+
+    (void)arg;
+    for (size_t i = start; i < finish; i++) {
+        uint64_t x = i;
+
+        for (int r = 0; r < WORK; r++)
+            x = x * 6364136223846793005u + 1442695040888963407u;
+        acc += x;
+    }
+
+    atomic_fetch_add_explicit(&sink, acc, memory_order_relaxed);
+}
+
+static void run_serial(void* arg) {
+    (void)arg;
+    spin_range(0, ITEMS, NULL);
+}
+
+static void run_parallel(void* arg) {
+    b_threadpool_parallel_for(arg, 0, ITEMS, 0, spin_range, NULL);
+}
+
+int main(int argc, char** argv) {
+    long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+    BenchSuite suite;
+    char name[64];
+
+    b_bench_init(&suite, "threadpool", argc, argv);
+
+    b_bench_run(&suite, &(BenchCase){
+                            .name = "serial",
+                            .run = run_serial,
+                            .ops = ITEMS,
+                        });
+
+    // 1, 2, 4, ... workers, and finally one per CPU.
+    for (long n = 1;; n *= 2) {
+        BeanThreadPool pool;
+
+        if (n > ncpus)
+            n = ncpus;
+
+        if (b_threadpool_init(&pool, (size_t)n) != STATUS_SUCCESS)
+            return 1;
+
+        snprintf(name, sizeof(name), "parallel_for (%ld workers)", n);
+        b_bench_run(&suite, &(BenchCase){
+                                .name = name,
+                                .run = run_parallel,
+                                .arg = &pool,
+                                .ops = ITEMS,
+                            });
+
+        b_threadpool_deinit(&pool);
+        if (n == ncpus)
+            break;
+    }
+
+    return b_bench_finish(&suite);
+}
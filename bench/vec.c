@@ -0,0 +1,97 @@
+// All benchmarks are licensed under the unlicense. Do whatever you want with
+// these benchmarks
+
+#include <stdint.h>
+
+#include "beanutils/beanutils.h"
+#include "bench.h"
+
+#define ELEMS   (1 << 20)
+#define INSERTS 1000
+
+static BeanVec filled;
+static volatile uint64_t sink;
+
+static void run_push(void* arg) {
+    BeanVec vec = {0};
+
+    (void)arg;
+    b_vec_init(&vec, sizeof(uint64_t));
+    for (uint64_t i = 0; i < ELEMS; i++)
+        b_vec_push(&vec, &i);
+    b_vec_deinit(&vec);
+}
+
+static void fill(void* arg) {
+    (void)arg;
+    for (uint64_t i = filled.len; i < ELEMS; i++)
+        b_vec_push(&filled, &i);
+}
+
+static void run_pop(void* arg) {
+    uint64_t elem, sum = 0;
+
+    (void)arg;
+    while (b_vec_pop(&filled, &elem) == STATUS_SUCCESS)
+        sum += elem;
+    sink += sum;
+}
+
+static void run_get(void* arg) {
+    uint64_t sum = 0;
+
+    (void)arg;
+    for (size_t i = 0; i < filled.len; i++)
+        sum += *(uint64_t*)b_vec_get(&filled, i);
+    sink += sum;
+}
+
+// Opens and closes a gap in the middle, moving half of the vector each time.
+static void run_insert_remove(void* arg) {
+    uint64_t elem = 42;
+
+    (void)arg;
+    for (size_t i = 0; i < INSERTS; i++) {
+        b_vec_insert(&filled, &elem, ELEMS / 2);
+        b_vec_remove(&filled, ELEMS / 2);
+    }
+}
+
+int main(int argc, char** argv) {
+    BenchSuite suite;
+
+    b_bench_init(&suite, "vec", argc, argv);
+    b_vec_init(&filled, sizeof(uint64_t));
+
+    b_bench_run(&suite, &(BenchCase){
+                            .name = "b_vec_push (8 B)",
+                            .run = run_push,
+                            .ops = ELEMS,
+                            .bytes = ELEMS * sizeof(uint64_t),
+                        });
+    b_bench_run(&suite, &(BenchCase){
+                            .name = "b_vec_pop (8 B)",
+                            .setup = fill,
+                            .run = run_pop,
+                            .ops = ELEMS,
+                            .bytes = ELEMS * sizeof(uint64_t),
+                        });
+    b_bench_run(&suite, &(BenchCase){
+                            .name = "b_vec_get (8 B)",
+                            .setup = fill,
+                            .run = run_get,
+                            .ops = ELEMS,
+                            .bytes = ELEMS * sizeof(uint64_t),
+                        });
+    b_bench_run(&suite, &(BenchCase){
+                            .name = "b_vec_insert/remove (middle)",
+                            .setup = fill,
+                            .run = run_insert_remove,
+                            .ops = INSERTS * 2,
+                            .bytes = (size_t)INSERTS * ELEMS * sizeof(uint64_t),
+                        });
+
+    b_vec_deinit(&filled);
+
+    return b_bench_finish(&suite);
+}
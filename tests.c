@@ -2,7 +2,9 @@
 // tests
 
 #include <assert.h>
+#include <pthread.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "beanutils/beanutils.h"
 
@@ -19,7 +21,1603 @@ void Test_reallocPointerAddresses(void) {
     assert(firstptr == secptr);
 }
 
+void Test_vecContiguous(void) {
+    typedef B_VEC_SPAN(int) IntSpan;
+    BeanVec vec = {0};
+    BeanVec clone = {0};
+    BeanVec slice = {0};
+
+    assert(b_vec_init(&vec, sizeof(int)) == STATUS_SUCCESS);
+    for (int i = 0; i < 100; i++)
+        assert(b_vec_push(&vec, &i) == STATUS_SUCCESS);
+
+    int val = -1;
+    assert(b_vec_insert(&vec, &val, 0) == STATUS_SUCCESS);
+    assert(b_vec_remove(&vec, 50) == STATUS_SUCCESS);
+    assert(vec.len == 100);
+    assert(B_VEC_AT(&vec, int, 0) == -1);
+    assert(B_VEC_AT(&vec, int, 50) == 50);
+
+    assert(b_vec_clone(&vec, &clone) == STATUS_SUCCESS);
+    BeanVecView lhs = b_vec_get_view(&vec, 0, vec.len);
+    BeanVecView rhs = b_vec_get_view(&clone, 0, clone.len);
+    assert(b_vecview_equal(&lhs, &rhs));
+
+    assert(b_vec_slice(&vec, &slice, 10, 20) == STATUS_SUCCESS);
+    IntSpan span = B_VEC_AS_SPAN(slice, IntSpan);
+    assert(span.len == 10 && span.data[0] == 9 && span.data[9] == 18);
+
+    b_vec_deinit(&vec);
+    b_vec_deinit(&clone);
+    b_vec_deinit(&slice);
+}
+
+void Test_arenaContainers(void) {
+    BeanArena arena = {0};
+    BeanString str = {0};
+    BeanArray arr = {0};
+    BeanArray clone = {0};
+
+    assert(b_arena_init_with_size(&arena, 256) == STATUS_SUCCESS);
+
+    for (int round = 0; round < 3; round++) {
+        assert(b_string_init_in(&str, &arena) == STATUS_SUCCESS);
+        for (int i = 0; i < 1000; i++)
+            assert(b_string_push(&str, 'a' + i % 26) == STATUS_SUCCESS);
+        assert(str.len == 1000 && b_string_data(&str)[25] == 'z');
+
+        assert(b_array_init_in(&arr, &arena) == STATUS_SUCCESS);
+        for (int i = 0; i < 100; i++) {
+            int* elem = b_arena_alloc(&arena, sizeof(int));
+            *elem = i;
+            assert(b_array_push(&arr, elem) == STATUS_SUCCESS);
+        }
+        assert(b_array_clone(&arr, &clone, sizeof(int)) == STATUS_SUCCESS);
+        assert(clone.arena == &arena && *(int*)clone.data[99] == 99);
+
+        b_string_deinit(&str);
+        b_array_deinit(&arr);
+        b_array_deinit(&clone);
+        assert(b_arena_reset(&arena) == STATUS_SUCCESS);
+    }
+
+    b_arena_deinit(&arena);
+}
+
+void Test_poolBackedArray(void) {
+    BeanPool pool = {0};
+    BeanArray arr = {0};
+    BeanArray copy = {0};
+
+    assert(b_pool_init(&pool, sizeof(long)) == STATUS_SUCCESS);
+    assert(b_array_init(&arr) == STATUS_SUCCESS);
+    assert(b_array_bind_pool(&arr, &pool) == STATUS_SUCCESS);
+
+    long* first = b_array_alloc_elem(&arr, sizeof(long));
+    *first = 42;
+    assert(b_array_push(&arr, first) == STATUS_SUCCESS);
+    assert(b_array_pop(&arr) == STATUS_SUCCESS);
+
+    // A released element is recycled before the slab grows.
+    assert(b_array_alloc_elem(&arr, sizeof(long)) == first);
+    assert(b_array_alloc_elem(&arr, sizeof(long) * 64) == NULL);
+
+    // A clone that runs out of elements leaves nothing behind.
+    assert(b_array_push(&arr, first) == STATUS_SUCCESS);
+    assert(b_array_clone(&arr, &copy, sizeof(long) * 64) ==
+           STATUS_FAILED_ALLOC);
+
+    b_array_deinit(&arr);
+    b_pool_deinit(&pool);
+}
+
+void Test_stringSmallBuffer(void) {
+    BeanString str = {0};
+    BeanString clone = {0};
+
+    assert(b_string_init_with_cstr(&str, "short key") == STATUS_SUCCESS);
+    assert(b_string_is_inline(&str));
+
+    clone = b_string_clone(&str);
+    assert(b_string_is_inline(&clone) && b_string_simplecmp(&str, &clone));
+
+    // Growing past the inline buffer moves the string to the heap.
+    assert(b_string_concat(&str, &str) == STATUS_SUCCESS);
+    assert(b_string_push_cstr(&str, "!!") == STATUS_SUCCESS);
+    assert(strcmp(b_string_data(&str), "short keyshort key!!") == 0);
+    assert(b_string_concat(&str, &clone) == STATUS_SUCCESS);
+    assert(!b_string_is_inline(&str));
+    assert(strcmp(b_string_data(&str), "short keyshort key!!short key") == 0);
+
+    assert(b_string_insert(&str, '_', 5) == STATUS_SUCCESS);
+    assert(strncmp(b_string_data(&str), "short_ key", 10) == 0);
+
+    // Removing characters shrinks it back inline.
+    while (str.len > 4)
+        assert(b_string_remove(&str, str.len - 1) == STATUS_SUCCESS);
+    assert(b_string_is_inline(&str));
+
+    char* cstr = b_string_clone_into_cstr(&str);
+    assert(strcmp(cstr, "shor") == 0);
+    free(cstr);
+
+    b_string_deinit(&str);
+    b_string_deinit(&clone);
+}
+
+void Test_stringBuilder(void) {
+    BeanStringBuilder sb = {0};
+    BeanString piece = {0};
+    BeanString res = {0};
+    char buf[64] = {0};
+
+    assert(b_strbuilder_init(&sb) == STATUS_SUCCESS);
+    assert(b_string_init_with_cstr(&piece, "bean") == STATUS_SUCCESS);
+
+    for (int i = 0; i < 10000; i++) {
+        assert(b_strbuilder_append_string(&sb, &piece) == STATUS_SUCCESS);
+        assert(b_strbuilder_append_char(&sb, ',') == STATUS_SUCCESS);
+    }
+    assert(b_strbuilder_append_cstr(&sb, "end") == STATUS_SUCCESS);
+
+    assert(b_strbuilder_finalize(&sb, &res) == STATUS_SUCCESS);
+    assert(res.len == 50003 && res.cap == res.len && sb.len == 0);
+    assert(strncmp(b_string_data(&res), "bean,bean,", 10) == 0);
+    assert(strcmp(&b_string_data(&res)[49995], "bean,end") == 0);
+
+    FILE* file = tmpfile();
+    assert(file != NULL);
+    assert(b_strbuilder_append_bytes(&sb, "raw\0bytes", 9) == STATUS_SUCCESS);
+    assert(b_strbuilder_flush(&sb, file) == STATUS_SUCCESS);
+    rewind(file);
+    assert(fread(buf, 1, sizeof(buf), file) == 9);
+    assert(memcmp(buf, "raw\0bytes", 9) == 0);
+    fclose(file);
+
+    b_strbuilder_deinit(&sb);
+    b_string_deinit(&piece);
+    b_string_deinit(&res);
+}
+
+void Test_fileReadAndMap(void) {
+    FILE* file = tmpfile();
+    BeanMappedFile map;
+
+    assert(file != NULL);
+    for (int i = 0; i < 100000; i++)
+        fputs("line\n", file);
+    fflush(file);
+
+    rewind(file);
+    BeanString contents = b_file_read(file);
+    assert(contents.len == 500000);
+    assert(strncmp(b_string_data(&contents), "line\nline\n", 10) == 0);
+
+    assert(b_file_map(file, &map) == STATUS_SUCCESS);
+    assert(map.len == contents.len);
+    assert(memcmp(map.data, b_string_data(&contents), map.len) == 0);
+    assert(b_file_unmap(&map) == STATUS_SUCCESS);
+
+    b_string_deinit(&contents);
+    fclose(file);
+}
+
+void Test_lineReader(void) {
+    const char* expected[] = {"short", "",
+                              "a line that is longer than the buffer",
+                              "no newline at the end"};
+    FILE* file = tmpfile();
+    BeanLineReader reader = {0};
+    const char* line;
+    size_t len;
+    size_t count = 0;
+
+    assert(file != NULL);
+    for (size_t i = 0; i < 4; i++)
+        fprintf(file, i < 3 ? "%s\n" : "%s", expected[i]);
+    rewind(file);
+
+    assert(b_linereader_init_with_size(&reader, file, 8) == STATUS_SUCCESS);
+    while (b_linereader_next(&reader, &line, &len) == STATUS_SUCCESS) {
+        assert(count < 4);
+        assert(len == strlen(expected[count]));
+        assert(memcmp(line, expected[count], len) == 0);
+        count++;
+    }
+    assert(count == 4);
+    assert(b_linereader_next(&reader, &line, &len) == STATUS_END_OF_FILE);
+
+    rewind(file);
+    BeanString first = b_file_read_line(file);
+    assert(strcmp(b_string_data(&first), "short") == 0);
+
+    b_string_deinit(&first);
+    b_linereader_deinit(&reader);
+    fclose(file);
+
+    // A read error is reported, not taken for the end of the file.
+    if ((file = fopen(".", "r")) != NULL) {
+        assert(b_linereader_init(&reader, file) == STATUS_SUCCESS);
+        assert(b_linereader_next(&reader, &line, &len) ==
+               STATUS_GENERIC_FAILURE);
+        assert(ferror(file));
+        b_linereader_deinit(&reader);
+        fclose(file);
+    }
+}
+
+void Test_fileWriteMany(void) {
+    enum { COUNT = 3000 };
+    BeanString strs[COUNT];
+    BeanString* ptrs[COUNT];
+    FILE* file = tmpfile();
+    char expected[16];
+
+    assert(file != NULL);
+    for (int i = 0; i < COUNT; i++) {
+        snprintf(expected, sizeof(expected), "record %d\n", i);
+        assert(b_string_init_with_cstr(&strs[i], expected) == STATUS_SUCCESS);
+        ptrs[i] = &strs[i];
+    }
+
+    assert(b_file_write_many(fileno(file), ptrs, COUNT) == STATUS_SUCCESS);
+    b_file_write(file, &strs[0]);
+    fflush(file);
+
+    rewind(file);
+    BeanString contents = b_file_read(file);
+    assert(strncmp(b_string_data(&contents), "record 0\nrecord 1\n", 18) == 0);
+    assert(strcmp(&b_string_data(&contents)[contents.len - 21],
+                  "record 2999\nrecord 0\n") == 0);
+
+    for (int i = 0; i < COUNT; i++)
+        b_string_deinit(&strs[i]);
+    b_string_deinit(&contents);
+    fclose(file);
+}
+
+static void* asyncLogWorker(void* arg) {
+    for (int i = 0; i < 1000; i++)
+        b_log(LOGLEVEL_WARN, "worker %d message %d", *(int*)arg, i);
+    return NULL;
+}
+
+void Test_asyncLogger(void) {
+    pthread_t threads[4];
+    int ids[4] = {0, 1, 2, 3};
+    FILE* file = tmpfile();
+    BeanLogConfig config = {
+        .capacity = 64,
+        .overflow = LOGOVERFLOW_BLOCK,
+        .output = file,
+    };
+
+    assert(file != NULL);
+    assert(b_log_async_start(&config) == STATUS_SUCCESS);
+    for (int i = 0; i < 4; i++)
+        pthread_create(&threads[i], NULL, asyncLogWorker, &ids[i]);
+    for (int i = 0; i < 4; i++)
+        pthread_join(threads[i], NULL);
+    assert(b_log_flush() == STATUS_SUCCESS);
+    assert(b_log_async_stop() == STATUS_SUCCESS);
+    assert(b_log_dropped() == 0);
+
+    rewind(file);
+    BeanLineReader reader = {0};
+    const char* line;
+    size_t len;
+    size_t count = 0;
+
+    assert(b_linereader_init(&reader, file) == STATUS_SUCCESS);
+    while (b_linereader_next(&reader, &line, &len) == STATUS_SUCCESS) {
+        assert(strncmp(line, "[WARN] worker ", 14) == 0);
+        count++;
+    }
+    assert(count == 4000);
+
+    b_linereader_deinit(&reader);
+    fclose(file);
+}
+
+static void* floodLogWorker(void* arg) {
+    atomic_bool* stop = arg;
+
+    for (int i = 0; !atomic_load(stop); i++)
+        b_log(LOGLEVEL_LOG, "flood %d", i);
+    return NULL;
+}
+
+void Test_logFlushUnderLoad(void) {
+    pthread_t thread;
+    atomic_bool stop = false;
+    FILE* file = tmpfile();
+    BeanLogConfig config = {
+        .capacity = 64,
+        .overflow = LOGOVERFLOW_BLOCK,
+        .output = file,
+    };
+
+    assert(file != NULL);
+    assert(b_log_async_start(&config) == STATUS_SUCCESS);
+    pthread_create(&thread, NULL, floodLogWorker, &stop);
+
+    // The ring never runs empty, so each flush has to return on its own.
+    for (int i = 0; i < 8; i++)
+        assert(b_log_flush() == STATUS_SUCCESS);
+
+    atomic_store(&stop, true);
+    pthread_join(thread, NULL);
+    assert(b_log_async_stop() == STATUS_SUCCESS);
+    fclose(file);
+}
+
+void Test_binaryLogger(void) {
+    FILE* file = tmpfile();
+    FILE* decoded = tmpfile();
+    BeanLogConfig config = {
+        .overflow = LOGOVERFLOW_BLOCK,
+        .format = LOGFORMAT_BINARY,
+        .output = file,
+    };
+    char buf[256] = {0};
+    char format[32];
+
+    assert(file != NULL && decoded != NULL);
+    assert(b_log_async_start(&config) == STATUS_SUCCESS);
+    for (int i = 0; i < 3; i++)
+        B_LOG_DEFERRED(LOGLEVEL_LOG, "id=%d name=%s ratio=%.2f size=%zu", i,
+                       "bean", 0.5, (size_t)42);
+    b_log(LOGLEVEL_ERROR, "%5s|%-4lld|%*d|100%%", "ab", 7LL, 3, 9);
+
+    // A format buffer reused at the same address keeps its own text.
+    strcpy(format, "first %d");
+    b_log(LOGLEVEL_WARN, format, 1);
+    strcpy(format, "second %s");
+    b_log(LOGLEVEL_WARN, format, "two");
+    memset(format, 0, sizeof(format));
+    assert(b_log_async_stop() == STATUS_SUCCESS);
+
+    rewind(file);
+    assert(b_log_decode(file, decoded) == STATUS_SUCCESS);
+    rewind(decoded);
+
+    for (int i = 0; i < 3; i++) {
+        char expected[64];
+
+        assert(fgets(buf, sizeof(buf), decoded) != NULL);
+        snprintf(expected, sizeof(expected),
+                 "[INFO] id=%d name=bean ratio=0.50 size=42\n", i);
+        assert(strstr(buf, expected) != NULL);
+    }
+    assert(fgets(buf, sizeof(buf), decoded) != NULL);
+    assert(strstr(buf, "[ERROR]    ab|7   |  9|100%\n") != NULL);
+    assert(fgets(buf, sizeof(buf), decoded) != NULL);
+    assert(strstr(buf, "[WARN] first 1\n") != NULL);
+    assert(fgets(buf, sizeof(buf), decoded) != NULL);
+    assert(strstr(buf, "[WARN] second two\n") != NULL);
+    assert(fgets(buf, sizeof(buf), decoded) == NULL);
+
+    fclose(file);
+    fclose(decoded);
+}
+
+void Test_stringSearch(void) {
+    const b_simdlevel_t levels[] = {SIMDLEVEL_SCALAR, SIMDLEVEL_SSE2,
+                                    SIMDLEVEL_AVX2};
+    b_simdlevel_t detected = b_simd_level();
+    BeanString hay = {0};
+    BeanString needle = {0};
+    BeanString comma = {0};
+    BeanString repl = {0};
+
+    // Long enough to go through the vector loops and their scalar tails.
+    assert(b_string_init(&hay) == STATUS_SUCCESS);
+    for (int i = 0; i < 100; i++)
+        assert(b_string_push_cstr(&hay, "abc,defg,") == STATUS_SUCCESS);
+    assert(b_string_push_cstr(&hay, "needle!") == STATUS_SUCCESS);
+    assert(b_string_init_with_cstr(&needle, "needle") == STATUS_SUCCESS);
+    assert(b_string_init_with_cstr(&comma, ",") == STATUS_SUCCESS);
+    assert(b_string_init_with_cstr(&repl, ";;") == STATUS_SUCCESS);
+
+    for (size_t i = 0; i < 3; i++) {
+        b_simd_set_level(levels[i]);
+        assert(b_string_find(&hay, &needle, 0) == 900);
+        assert(b_string_find(&hay, &needle, 901) == B_STRING_NPOS);
+        assert(b_string_find_byte(&hay, '!', 0) == 906);
+        assert(b_string_find_byte(&hay, 'd', 5) == 13);
+        assert(b_string_count(&hay, &comma) == 200);
+        assert(b_string_equal(&hay, &hay) && !b_string_equal(&hay, &needle));
+    }
+    b_simd_set_level(detected);
+
+    assert(b_string_replace_all(&hay, &comma, &repl) == STATUS_SUCCESS);
+    assert(hay.len == 1107 && b_string_count(&hay, &comma) == 0);
+    assert(strncmp(b_string_data(&hay), "abc;;defg;;abc", 14) == 0);
+
+    b_string_deinit(&hay);
+    b_string_deinit(&needle);
+    b_string_deinit(&comma);
+    b_string_deinit(&repl);
+}
+
+void Test_stringView(void) {
+    BeanString bs = {0};
+    BeanString copy = {0};
+    BeanStringSplit split;
+    BeanStringView field;
+    BeanStringView comma = b_strview_from_cstr(",");
+    BeanStringView arrow = b_strview_from_cstr("->");
+    BeanStringView blanks = b_strview_from_cstr(" \t");
+    BeanStringView view;
+    const char* fields[] = {"a", "", "bc", ""};
+    size_t i = 0;
+
+    assert(b_string_init_with_cstr(&bs, "  key = value\t") == STATUS_SUCCESS);
+    view = b_strview_trim(&(BeanStringView){b_string_data(&bs), bs.len});
+    assert(view.len == 11 && strncmp(view.data, "key = value", 11) == 0);
+    assert(b_strview_starts_with(&view, &(BeanStringView){"key", 3}));
+    assert(b_strview_ends_with(&view, &(BeanStringView){"value", 5}));
+    assert(b_strview_find(&view, &(BeanStringView){"=", 1}) == 4);
+
+    view = b_string_get_view(&bs, 2, 5);
+    assert(b_string_init_with_view(&copy, &view) == STATUS_SUCCESS);
+    assert(copy.len == 3 && strcmp(b_string_data(&copy), "key") == 0);
+    assert(b_strview_cmp(&view, &(BeanStringView){"kez", 3}) < 0);
+    assert(b_strview_cmp(&view, &(BeanStringView){"ke", 2}) > 0);
+    assert(b_strview_equal(&view, &(BeanStringView){"key", 3}));
+
+    view = b_strview_from_cstr("a,,bc,");
+    b_strview_split_init(&split, &view, &comma);
+    while (b_strview_split_next(&split, &field)) {
+        assert(field.len == strlen(fields[i]));
+        assert(strncmp(field.data, fields[i], field.len) == 0);
+        i++;
+    }
+    assert(i == 4);
+
+    view = b_strview_from_cstr("x->y");
+    b_strview_split_init(&split, &view, &arrow);
+    assert(b_strview_split_next(&split, &field) && field.data[0] == 'x');
+    assert(b_strview_split_next(&split, &field) && field.data[0] == 'y');
+    assert(!b_strview_split_next(&split, &field));
+
+    view = b_strview_from_cstr(" \t one  two\tthree ");
+    b_strview_tokenize_init(&split, &view, &blanks);
+    for (i = 0; b_strview_split_next(&split, &field); i++)
+        assert(field.len == 3 || field.len == 5);
+    assert(i == 3 && strncmp(field.data, "three", 5) == 0);
+
+    b_string_deinit(&bs);
+    b_string_deinit(&copy);
+}
+
+void Test_hashMap(void) {
+    BeanHashMap map = {0};
+    BeanHashMapIter it;
+    const BeanString* key;
+    void* val;
+    char buf[32];
+    size_t seen = 0;
+
+    assert(b_hashmap_init(&map, sizeof(int)) == STATUS_SUCCESS);
+    assert(b_hashmap_get(&map, &(BeanStringView){"missing", 7}) == NULL);
+
+    for (int i = 0; i < 1000; i++) {
+        BeanStringView view = {buf, (size_t)sprintf(buf, "key-%d", i)};
+        assert(b_hashmap_insert(&map, &view, &i) == STATUS_SUCCESS);
+    }
+    assert(map.len == 1000 && map.cap >= 1000);
+
+    // Overwrite every other value and erase the rest.
+    for (int i = 0; i < 1000; i++) {
+        BeanStringView view = {buf, (size_t)sprintf(buf, "key-%d", i)};
+        int neg = -i;
+
+        assert(*(int*)b_hashmap_get(&map, &view) == i);
+        if (i % 2 == 0)
+            assert(b_hashmap_insert(&map, &view, &neg) == STATUS_SUCCESS);
+        else
+            assert(b_hashmap_erase(&map, &view) == STATUS_SUCCESS);
+    }
+    assert(map.len == 500);
+    assert(b_hashmap_erase(&map, &(BeanStringView){"key-1", 5}) ==
+           STATUS_INVALID_OPERATION);
+
+    b_hashmap_iter_init(&it, &map);
+    while (b_hashmap_iter_next(&it, &key, &val)) {
+        assert(strncmp(b_string_data(key), "key-", 4) == 0);
+        assert(*(int*)val == -atoi(b_string_data(key) + 4));
+        seen++;
+    }
+    assert(seen == 500);
+
+    // Reserving rehashes and drops the tombstones.
+    assert(b_hashmap_reserve(&map, 4000) == STATUS_SUCCESS);
+    assert(map.tombstones == 0 && map.cap >= 4000);
+    assert(*(int*)b_hashmap_get(&map, &(BeanStringView){"key-998", 7}) ==
+           -998);
+    assert(b_hashmap_get(&map, &(BeanStringView){"key-999", 7}) == NULL);
+
+    b_hashmap_deinit(&map);
+}
+
+void Test_hashing(void) {
+    const b_simdlevel_t levels[] = {SIMDLEVEL_SCALAR, SIMDLEVEL_AVX2};
+    b_simdlevel_t detected = b_simd_level();
+    size_t sizes[] = {0, 1, 3, 4, 8, 16, 17, 63, 64, 65, 128, 1024, 5000};
+    unsigned char* data = malloc(5000);
+    BeanString bs = {0};
+    BeanHasher hasher;
+    FILE* file = tmpfile();
+
+    for (size_t i = 0; i < 5000; i++)
+        data[i] = (unsigned char)(i * 131 + 7);
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        size_t len = sizes[i];
+        uint64_t hash = b_hash_bytes(data, len, 42);
+
+        // Every level and every way of splitting the input agrees.
+        for (size_t l = 0; l < 2; l++) {
+            b_simd_set_level(levels[l]);
+            assert(b_hash_bytes(data, len, 42) == hash);
+
+            for (size_t step = 1; step < 200; step += 37) {
+                b_hasher_init(&hasher, 42);
+                for (size_t off = 0; off < len; off += step)
+                    b_hasher_update(&hasher, data + off,
+                                    len - off < step ? len - off : step);
+                assert(b_hasher_finish(&hasher) == hash);
+            }
+        }
+        b_simd_set_level(detected);
+
+        assert(b_hash_bytes(data, len, 43) != hash);
+        if (len > 0) {
+            data[len - 1] ^= 1;
+            assert(b_hash_bytes(data, len, 42) != hash);
+            data[len - 1] ^= 1;
+        }
+    }
+
+    assert(b_string_init_with_cstr(&bs, "hash me") == STATUS_SUCCESS);
+    assert(b_hash_string(&bs, 0) ==
+           b_hash_strview(&(BeanStringView){"hash me", 7}, 0));
+
+    assert(fwrite(data, 1, 5000, file) == 5000);
+    rewind(file);
+    b_hasher_init(&hasher, 7);
+    assert(b_hasher_update_file(&hasher, file) == STATUS_SUCCESS);
+    assert(b_hasher_finish(&hasher) == b_hash_bytes(data, 5000, 7));
+
+    fclose(file);
+    b_string_deinit(&bs);
+    free(data);
+}
+
+void* internWorker(void* arg) {
+    BeanInterner* interner = arg;
+    const BeanStringView** handles = malloc(sizeof(*handles) * 1000);
+    char buf[32];
+
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < 1000; i++) {
+            sprintf(buf, "token-%d", i);
+            handles[i] = b_interner_intern_cstr(interner, buf);
+            assert(handles[i] != NULL);
+        }
+    }
+
+    return handles;
+}
+
+void Test_interner(void) {
+    BeanInterner interner = {0};
+    BeanString owned = {0};
+    pthread_t threads[4];
+    const BeanStringView** handles[4];
+    const BeanStringView* a;
+
+    assert(b_interner_init(&interner) == STATUS_SUCCESS);
+
+    a = b_interner_intern_cstr(&interner, "ident");
+    assert(a != NULL && strcmp(a->data, "ident") == 0);
+    assert(b_string_init_with_cstr(&owned, "ident") == STATUS_SUCCESS);
+    assert(b_interner_intern(&interner,
+                             &(BeanStringView){b_string_data(&owned),
+                                               owned.len}) == a);
+    assert(b_interner_lookup(&interner, &(BeanStringView){"iden", 4}) == NULL);
+
+    // Threads racing on the same strings all get the same handles.
+    for (int i = 0; i < 4; i++)
+        pthread_create(&threads[i], NULL, internWorker, &interner);
+    for (int i = 0; i < 4; i++)
+        pthread_join(threads[i], (void**)&handles[i]);
+
+    for (int i = 0; i < 1000; i++) {
+        assert(handles[0][i] == handles[1][i]);
+        assert(handles[1][i] == handles[2][i]);
+        assert(handles[2][i] == handles[3][i]);
+    }
+    assert(b_interner_len(&interner) == 1001);
+    assert(b_interner_lookup(&interner, &(BeanStringView){"ident", 5}) == a);
+
+    for (int i = 0; i < 4; i++)
+        free(handles[i]);
+    b_string_deinit(&owned);
+    b_interner_deinit(&interner);
+}
+
+typedef struct {
+    uint32_t key;
+    uint32_t seq;
+} SortRecord;
+
+int cmpRecords(const void* lhs, const void* rhs) {
+    const SortRecord* a = lhs;
+    const SortRecord* b = rhs;
+    return (a->key > b->key) - (a->key < b->key);
+}
+
+uint64_t recordKey(const void* elem) { return ((const SortRecord*)elem)->key; }
+
+void checkSorted(const BeanArray* array, bool stable) {
+    for (size_t i = 1; i < array->len; i++) {
+        const SortRecord* a = array->data[i - 1];
+        const SortRecord* b = array->data[i];
+
+        assert(a->key <= b->key);
+        if (stable && a->key == b->key)
+            assert(a->seq < b->seq);
+    }
+}
+
+void Test_arraySort(void) {
+    const size_t len = 300000;
+    SortRecord* records = malloc(len * sizeof(SortRecord));
+    BeanArray array = {0};
+    SortRecord probe = {.key = 500};
+    BeanThreadPool pool;
+    size_t i;
+
+    assert(b_array_init_with_size(&array, len) == STATUS_SUCCESS);
+    for (i = 0; i < len; i++) {
+        records[i] = (SortRecord){.key = (uint32_t)(i * 2654435761u) % 1000,
+                                  .seq = (uint32_t)i};
+        b_array_push(&array, &records[i]);
+    }
+
+    assert(b_array_sort(&array, cmpRecords) == STATUS_SUCCESS);
+    checkSorted(&array, false);
+
+    // Sorted and reversed inputs are the classic quicksort worst cases.
+    for (i = 0; i < len / 2; i++) {
+        void* tmp = array.data[i];
+        array.data[i] = array.data[len - 1 - i];
+        array.data[len - 1 - i] = tmp;
+    }
+    assert(b_array_sort(&array, cmpRecords) == STATUS_SUCCESS);
+    checkSorted(&array, false);
+
+    for (i = 0; i < len; i++)
+        array.data[i] = &records[i];
+    assert(b_threadpool_init(&pool, 3) == STATUS_SUCCESS);
+    assert(b_array_sort_parallel(&array, cmpRecords, &pool) == STATUS_SUCCESS);
+    checkSorted(&array, true);
+    b_threadpool_deinit(&pool);
+
+    for (i = 0; i < len; i++)
+        array.data[i] = &records[i];
+    assert(b_array_radix_sort(&array, recordKey) == STATUS_SUCCESS);
+    checkSorted(&array, true);
+
+    i = b_array_lower_bound(&array, &probe, cmpRecords);
+    assert(((SortRecord*)array.data[i])->key == 500);
+    assert(((SortRecord*)array.data[i - 1])->key == 499);
+    assert(b_array_bsearch(&array, &probe, cmpRecords) != NULL);
+    probe.key = 1000;
+    assert(b_array_lower_bound(&array, &probe, cmpRecords) == len);
+    assert(b_array_bsearch(&array, &probe, cmpRecords) == NULL);
+
+    // The records are not owned by the array.
+    array.len = 0;
+    b_array_deinit(&array);
+    free(records);
+}
+
+typedef struct {
+    BeanTaskGroup* group;
+    atomic_int* leaves;
+    int depth;
+} TreeTask;
+
+void treeTask(void* arg) {
+    TreeTask* task = arg;
+    TreeTask children[2];
+    BeanTaskGroup group;
+
+    if (task->depth == 0) {
+        atomic_fetch_add(task->leaves, 1);
+        return;
+    }
+
+    // Every level waits on its own group from inside a task.
+    b_taskgroup_init(&group, task->group->pool);
+    for (int i = 0; i < 2; i++) {
+        children[i] = (TreeTask){&group, task->leaves, task->depth - 1};
+        assert(b_taskgroup_spawn(&group, treeTask, &children[i]) ==
+               STATUS_SUCCESS);
+    }
+    b_taskgroup_wait(&group);
+}
+
+void markRange(size_t start, size_t finish, void* arg) {
+    atomic_int* hits = arg;
+
+    for (size_t i = start; i < finish; i++)
+        atomic_fetch_add(&hits[i], 1);
+}
+
+void sumElems(void** elems, size_t len, void* arg) {
+    long sum = 0;
+
+    for (size_t i = 0; i < len; i++)
+        sum += *(int*)elems[i];
+    atomic_fetch_add((atomic_long*)arg, sum);
+}
+
+void Test_threadPool(void) {
+    const size_t len = 100000;
+    BeanThreadPool pool;
+    BeanTaskGroup group;
+    atomic_int leaves = 0;
+    atomic_int* hits = calloc(len, sizeof(atomic_int));
+    atomic_long sum = 0;
+    int* values = malloc(len * sizeof(int));
+    void** elems = malloc(len * sizeof(void*));
+    BeanArrayView view = {.elems = elems, .len = len};
+    TreeTask root;
+
+    assert(b_threadpool_init(&pool, 4) == STATUS_SUCCESS);
+    assert(pool.nworkers == 4);
+
+    b_taskgroup_init(&group, &pool);
+    root = (TreeTask){&group, &leaves, 10};
+    assert(b_taskgroup_spawn(&group, treeTask, &root) == STATUS_SUCCESS);
+    b_taskgroup_wait(&group);
+    assert(atomic_load(&leaves) == 1024);
+
+    assert(b_threadpool_parallel_for(&pool, 0, len, 0, markRange, hits) ==
+           STATUS_SUCCESS);
+    assert(b_threadpool_parallel_for(&pool, 10, 20, 100, markRange, hits) ==
+           STATUS_SUCCESS);
+    for (size_t i = 0; i < len; i++)
+        assert(atomic_load(&hits[i]) == 1 + (i >= 10 && i < 20));
+
+    for (size_t i = 0; i < len; i++) {
+        values[i] = (int)i % 7;
+        elems[i] = &values[i];
+    }
+    assert(b_threadpool_parallel_for_view(&pool, &view, 1000, sumElems,
+                                          &sum) == STATUS_SUCCESS);
+    assert(atomic_load(&sum) == 299995);
+
+    assert(b_threadpool_deinit(&pool) == STATUS_SUCCESS);
+    assert(b_threadpool_deinit(&pool) == STATUS_INVALID_OPERATION);
+
+    free(hits);
+    free(values);
+    free(elems);
+}
+
+void doubleInPlace(void* elem, void* arg) {
+    (void)arg;
+    *(int*)elem *= 2;
+}
+
+void* boxedNegation(const void* elem, void* arg) {
+    int* res = malloc(sizeof(int));
+
+    (void)arg;
+    if (res != NULL)
+        *res = -*(const int*)elem;
+
+    return res;
+}
+
+bool isMultipleOf(const void* elem, void* arg) {
+    return *(const int*)elem % *(int*)arg == 0;
+}
+
+void addInt(void* acc, const void* elem, void* arg) {
+    (void)arg;
+    *(long*)acc += *(const int*)elem;
+}
+
+void addLong(void* acc, const void* partial, void* arg) {
+    (void)arg;
+    *(long*)acc += *(const long*)partial;
+}
+
+void Test_parallelAlgorithms(void) {
+    const size_t len = 50000;
+    int* values = malloc(len * sizeof(int));
+    void** elems = malloc(len * sizeof(void*));
+    BeanArrayView view = {.elems = elems, .len = len};
+    BeanArrayView small = {.elems = elems, .len = 10};
+    BeanArrayView matches;
+    BeanArray negated = {0};
+    long sum = 0;
+    int divisor = 3;
+
+    for (size_t i = 0; i < len; i++) {
+        values[i] = (int)i;
+        elems[i] = &values[i];
+    }
+
+    // Both the threaded path and the inline path for small views.
+    assert(b_arrview_for_each(&view, doubleInPlace, NULL, 1000) ==
+           STATUS_SUCCESS);
+    assert(b_arrview_for_each(&small, doubleInPlace, NULL, 0) ==
+           STATUS_SUCCESS);
+    assert(values[5] == 20 && values[10] == 20 && values[len - 1] ==
+                                                       (int)(len - 1) * 2);
+
+    assert(b_arrview_reduce(&view, &sum, sizeof(sum), addInt, addLong, NULL,
+                            1000) == STATUS_SUCCESS);
+    assert(sum == (long)len * (long)(len - 1) + 2 * 45);
+
+    assert(b_arrview_filter(&view, &matches, isMultipleOf, &divisor, 777) ==
+           STATUS_SUCCESS);
+    assert(matches.len == (len + 2) / 3);
+    // The first ten values were doubled twice.
+    for (size_t i = 5; i < matches.len; i++)
+        assert(*(int*)matches.elems[i] - *(int*)matches.elems[i - 1] == 6);
+    free(matches.elems);
+
+    assert(b_array_init(&negated) == STATUS_SUCCESS);
+    assert(b_arrview_map(&small, &negated, boxedNegation, NULL, 0) ==
+           STATUS_SUCCESS);
+    assert(b_arrview_map(&view, &negated, boxedNegation, NULL, 512) ==
+           STATUS_SUCCESS);
+    assert(negated.len == len + 10);
+    assert(*(int*)negated.data[3] == -12 && *(int*)negated.data[13] == -12);
+    b_array_deinit(&negated);
+
+    divisor = 4999;
+    assert(b_arrview_find(&view, isMultipleOf, &divisor, 100) == 0);
+    values[0] = 1;
+    assert(b_arrview_find(&view, isMultipleOf, &divisor, 100) == 4999);
+    assert(b_arrview_any(&view, isMultipleOf, &divisor, 100));
+    divisor = 1;
+    assert(b_arrview_all(&view, isMultipleOf, &divisor, 100));
+    divisor = 2;
+    assert(!b_arrview_all(&view, isMultipleOf, &divisor, 100));
+    divisor = 100003;
+    assert(b_arrview_find(&view, isMultipleOf, &divisor, 100) ==
+           B_ARRVIEW_NPOS);
+
+    free(values);
+    free(elems);
+}
+
+#define QUEUE_PRODUCERS 3
+#define QUEUE_CONSUMERS 3
+#define QUEUE_ITEMS     20000
+
+typedef struct {
+    BeanQueue* queue;
+    BeanBlockingQueue* bqueue;
+    BeanRing* ring;
+    size_t first;
+    size_t count;
+    size_t sum;
+    size_t popped;
+    atomic_size_t* remaining;
+} QueueWorker;
+
+static void* queueProducer(void* arg) {
+    QueueWorker* w = arg;
+
+    for (size_t i = w->first; i < w->first + w->count; i++) {
+        void* elem = (void*)(uintptr_t)(i + 1);
+
+        if (w->bqueue != NULL) {
+            assert(b_bqueue_push(w->bqueue, elem));
+        } else {
+            while (!b_queue_push(w->queue, elem))
+                ;
+        }
+    }
+
+    return NULL;
+}
+
+static void* queueConsumer(void* arg) {
+    QueueWorker* w = arg;
+    void* elems[8];
+    size_t n;
+
+    if (w->bqueue != NULL) {
+        while ((n = b_bqueue_pop_many(w->bqueue, elems, 8)) > 0) {
+            for (size_t i = 0; i < n; i++)
+                w->sum += (uintptr_t)elems[i];
+            w->popped += n;
+        }
+        return NULL;
+    }
+
+    while (atomic_load(w->remaining) > 0) {
+        n = b_queue_pop_many(w->queue, elems, 8);
+        for (size_t i = 0; i < n; i++)
+            w->sum += (uintptr_t)elems[i];
+        w->popped += n;
+        atomic_fetch_sub(w->remaining, n);
+    }
+
+    return NULL;
+}
+
+static void* ringProducer(void* arg) {
+    QueueWorker* w = arg;
+    void* elems[5];
+
+    for (size_t i = 0; i < w->count;) {
+        size_t n = 0;
+
+        while (n < 5 && i + n < w->count) {
+            elems[n] = (void*)(uintptr_t)(i + n + 1);
+            n++;
+        }
+        i += b_ring_push_many(w->ring, elems, n);
+    }
+
+    return NULL;
+}
+
+// Runs the producers and consumers and checks that every element arrived
+// exactly once.
+static void runQueueWorkers(BeanQueue* queue, BeanBlockingQueue* bqueue) {
+    pthread_t threads[QUEUE_PRODUCERS + QUEUE_CONSUMERS];
+    QueueWorker workers[QUEUE_PRODUCERS + QUEUE_CONSUMERS];
+    atomic_size_t remaining = QUEUE_PRODUCERS * QUEUE_ITEMS;
+    size_t total = QUEUE_PRODUCERS * QUEUE_ITEMS;
+    size_t sum = 0;
+    size_t popped = 0;
+
+    for (size_t i = 0; i < QUEUE_PRODUCERS + QUEUE_CONSUMERS; i++) {
+        workers[i] = (QueueWorker){
+            .queue = queue,
+            .bqueue = bqueue,
+            .first = i * QUEUE_ITEMS,
+            .count = QUEUE_ITEMS,
+            .remaining = &remaining,
+        };
+        pthread_create(&threads[i], NULL,
+                       i < QUEUE_PRODUCERS ? queueProducer : queueConsumer,
+                       &workers[i]);
+    }
+
+    for (size_t i = 0; i < QUEUE_PRODUCERS; i++)
+        pthread_join(threads[i], NULL);
+    if (bqueue != NULL)
+        b_bqueue_close(bqueue);
+
+    for (size_t i = QUEUE_PRODUCERS; i < QUEUE_PRODUCERS + QUEUE_CONSUMERS;
+         i++) {
+        pthread_join(threads[i], NULL);
+        sum += workers[i].sum;
+        popped += workers[i].popped;
+    }
+
+    assert(popped == total);
+    assert(sum == total * (total + 1) / 2);
+}
+
+void Test_queues(void) {
+    BeanQueue queue;
+    BeanBlockingQueue bqueue;
+    BeanRing ring;
+    QueueWorker producer;
+    pthread_t thread;
+    void* elems[16];
+    void* elem;
+    size_t sum = 0;
+
+    // Single-threaded behaviour: capacity, ordering and batches.
+    assert(b_queue_init(&queue, 5) == STATUS_SUCCESS);
+    for (uintptr_t i = 1; i <= 8; i++)
+        assert(b_queue_push(&queue, (void*)i));
+    assert(!b_queue_push(&queue, (void*)9));
+    assert(b_queue_pop(&queue, &elem) && elem == (void*)1);
+    assert(b_queue_pop_many(&queue, elems, 16) == 7);
+    assert(elems[0] == (void*)2 && elems[6] == (void*)8);
+    assert(!b_queue_pop(&queue, &elem));
+
+    for (uintptr_t i = 0; i < 16; i++)
+        elems[i] = (void*)(i + 100);
+    assert(b_queue_push_many(&queue, elems, 3) == 3);
+    assert(b_queue_push_many(&queue, &elems[3], 16) == 5);
+    assert(b_queue_pop_many(&queue, elems, 16) == 8);
+    assert(elems[0] == (void*)100 && elems[7] == (void*)107);
+
+    // Empty batches return at once, whether the queue is empty or not.
+    assert(b_queue_push_many(&queue, elems, 0) == 0);
+    assert(b_queue_pop_many(&queue, elems, 0) == 0);
+    assert(b_queue_push(&queue, elems[0]));
+    assert(b_queue_push_many(&queue, elems, 0) == 0);
+    assert(b_queue_pop_many(&queue, elems, 0) == 0);
+    assert(b_queue_pop(&queue, &elem) && elem == (void*)100);
+    assert(b_queue_deinit(&queue) == STATUS_SUCCESS);
+    assert(b_queue_deinit(&queue) == STATUS_INVALID_OPERATION);
+
+    assert(b_queue_init(&queue, 64) == STATUS_SUCCESS);
+    runQueueWorkers(&queue, NULL);
+    b_queue_deinit(&queue);
+
+    // A tiny capacity makes producers and consumers sleep often.
+    assert(b_bqueue_init(&bqueue, 4) == STATUS_SUCCESS);
+    assert(b_bqueue_pop_many(&bqueue, elems, 0) == 0);
+    runQueueWorkers(NULL, &bqueue);
+    assert(!b_bqueue_push(&bqueue, (void*)1));
+    assert(!b_bqueue_pop(&bqueue, &elem));
+    b_bqueue_deinit(&bqueue);
+
+    // The ring wraps around many times with odd batch sizes.
+    assert(b_ring_init(&ring, 16) == STATUS_SUCCESS);
+    producer = (QueueWorker){.ring = &ring, .count = QUEUE_ITEMS};
+    pthread_create(&thread, NULL, ringProducer, &producer);
+
+    for (size_t expected = 1; expected <= QUEUE_ITEMS;) {
+        size_t n = b_ring_pop_many(&ring, elems, 7);
+
+        for (size_t i = 0; i < n; i++)
+            assert(elems[i] == (void*)(uintptr_t)expected++);
+        sum += n;
+    }
+
+    pthread_join(thread, NULL);
+    assert(sum == QUEUE_ITEMS);
+    assert(!b_ring_pop(&ring, &elem));
+    assert(b_ring_push(&ring, (void*)1) && b_ring_pop(&ring, &elem));
+    assert(elem == (void*)1);
+    b_ring_deinit(&ring);
+}
+
+#define COW_THREADS 4
+
+static void* cowWorker(void* arg) {
+    const BeanString* shared = arg;
+
+    for (int i = 0; i < 1000; i++) {
+        BeanString clone = b_string_clone(shared);
+
+        assert(b_string_data(&clone) == b_string_data(shared));
+        assert(b_string_push(&clone, 'x') == STATUS_SUCCESS);
+        assert(b_string_data(&clone) != b_string_data(shared));
+        assert(clone.len == shared->len + 1);
+        b_string_deinit(&clone);
+    }
+
+    return NULL;
+}
+
+void Test_stringCopyOnWrite(void) {
+    const char* text = "a string far too long to be stored inline";
+    BeanString str = {0};
+    BeanString clones[6];
+    BeanString needle = {0};
+    BeanString repl = {0};
+    BeanString arenastr = {0};
+    BeanString arenaclone;
+    BeanArena arena = {0};
+    pthread_t threads[COW_THREADS];
+
+    assert(b_string_init_with_cstr(&str, text) == STATUS_SUCCESS);
+    assert(!b_string_is_shared(&str));
+
+    for (size_t i = 0; i < 6; i++) {
+        clones[i] = b_string_clone(&str);
+        assert(b_string_data(&clones[i]) == b_string_data(&str));
+    }
+    assert(b_string_is_shared(&str) && b_string_is_shared(&clones[0]));
+
+    // Every mutator copies the shared buffer and leaves the others alone.
+    assert(b_string_push(&clones[0], '!') == STATUS_SUCCESS);
+    assert(b_string_push_cstr(&clones[1], "??") == STATUS_SUCCESS);
+    assert(b_string_insert(&clones[2], '_', 0) == STATUS_SUCCESS);
+    assert(b_string_remove(&clones[3], 0) == STATUS_SUCCESS);
+    assert(b_string_concat(&clones[4], &str) == STATUS_SUCCESS);
+    assert(b_string_reserve(&clones[5], 100) == STATUS_SUCCESS);
+
+    b_string_init_with_cstr(&needle, "string");
+    b_string_init_with_cstr(&repl, "rope");
+    assert(b_string_replace_all(&str, &needle, &repl) == STATUS_SUCCESS);
+    assert(strcmp(b_string_data(&str),
+                  "a rope far too long to be stored inline") == 0);
+
+    for (size_t i = 0; i < 6; i++) {
+        const char* data = b_string_data(&clones[i]);
+
+        assert(!b_string_is_shared(&clones[i]));
+        assert(strstr(data, "string far too long") != NULL);
+    }
+    assert(strcmp(b_string_data(&clones[0]) + strlen(text), "!") == 0);
+    assert(b_string_data(&clones[2])[0] == '_');
+    assert(b_string_data(&clones[3])[0] == ' ');
+    assert(clones[4].len == 2 * strlen(text));
+    assert(strcmp(b_string_data(&clones[5]), text) == 0);
+
+    for (size_t i = 0; i < 6; i++)
+        b_string_deinit(&clones[i]);
+    assert(!b_string_is_shared(&str));
+
+    // Shrinking a shared string back inline leaves the others intact.
+    clones[0] = b_string_clone(&str);
+    while (clones[0].len > 6)
+        assert(b_string_remove(&clones[0], clones[0].len - 1) ==
+               STATUS_SUCCESS);
+    assert(b_string_is_inline(&clones[0]));
+    assert(strcmp(b_string_data(&clones[0]), "a rope") == 0);
+    assert(strcmp(b_string_data(&str),
+                  "a rope far too long to be stored inline") == 0);
+    b_string_deinit(&clones[0]);
+
+    // Clones are handed out and modified concurrently.
+    for (size_t i = 0; i < COW_THREADS; i++)
+        pthread_create(&threads[i], NULL, cowWorker, &str);
+    for (size_t i = 0; i < COW_THREADS; i++)
+        pthread_join(threads[i], NULL);
+    assert(!b_string_is_shared(&str));
+
+    // Arena-backed strings are still copied eagerly.
+    assert(b_arena_init(&arena) == STATUS_SUCCESS);
+    assert(b_string_init_with_cstr_in(&arenastr, text, &arena) ==
+           STATUS_SUCCESS);
+    arenaclone = b_string_clone(&arenastr);
+    assert(b_string_data(&arenaclone) != b_string_data(&arenastr));
+    assert(b_string_equal(&arenaclone, &arenastr));
+    assert(!b_string_is_shared(&arenastr));
+    b_arena_deinit(&arena);
+
+    b_string_deinit(&str);
+    b_string_deinit(&needle);
+    b_string_deinit(&repl);
+}
+
+static size_t freedElems = 0;
+
+static void countFree(void* elem) {
+    (void)elem;
+    freedElems++;
+}
+
+void Test_arrayRanges(void) {
+    BeanArray arr = {0};
+    BeanArray other = {0};
+    int values[100];
+    void* elems[100];
+    int* owned;
+
+    for (int i = 0; i < 100; i++) {
+        values[i] = i;
+        elems[i] = &values[i];
+    }
+
+    // The elements are borrowed, so nothing may be freed.
+    assert(b_array_init(&arr) == STATUS_SUCCESS);
+    assert(b_array_set_free_fn(&arr, b_array_free_nothing) == STATUS_SUCCESS);
+
+    assert(b_array_pop(&arr) == STATUS_INVALID_OPERATION);
+    assert(b_array_push_many(&arr, elems, 10) == STATUS_SUCCESS);
+    assert(arr.len == 10 && arr.cap >= 10);
+    assert(b_array_push_many(&arr, &elems[50], 50) == STATUS_SUCCESS);
+    assert(arr.len == 60 && arr.data[10] == elems[50]);
+
+    // [0, 10) ++ [20, 30) ++ [50, 100)
+    assert(b_array_insert_range(&arr, &elems[20], 10, 10) == STATUS_SUCCESS);
+    assert(arr.len == 70);
+    assert(arr.data[9] == elems[9] && arr.data[10] == elems[20]);
+    assert(arr.data[19] == elems[29] && arr.data[20] == elems[50]);
+    assert(arr.data[69] == elems[99]);
+    assert(b_array_insert_range(&arr, elems, 1, 71) ==
+           STATUS_INVALID_OPERATION);
+
+    assert(b_array_insert(&arr, elems[10], 10) == STATUS_SUCCESS);
+    assert(b_array_insert(&arr, elems[0], 71) == STATUS_SUCCESS);
+    assert(arr.len == 72 && arr.data[10] == elems[10]);
+    assert(arr.data[11] == elems[20] && arr.data[71] == elems[0]);
+
+    assert(b_array_remove_range(&arr, 11, 21) == STATUS_SUCCESS);
+    assert(arr.len == 62 && arr.data[11] == elems[50]);
+    assert(b_array_remove(&arr, 61) == STATUS_SUCCESS);
+    assert(b_array_remove(&arr, 0) == STATUS_SUCCESS);
+    assert(arr.len == 60 && arr.data[0] == elems[1]);
+    assert(b_array_remove_range(&arr, 10, 61) == STATUS_INVALID_OPERATION);
+
+    for (size_t i = 1; i < arr.len; i++)
+        assert(*(int*)arr.data[i] > *(int*)arr.data[i - 1]);
+
+    assert(b_array_truncate(&arr, 5) == STATUS_SUCCESS);
+    assert(arr.len == 5 && *(int*)arr.data[4] == 5);
+    assert(b_array_truncate(&arr, 6) == STATUS_INVALID_OPERATION);
+
+    // Appending moves every element of `other` in one go.
+    assert(b_array_init(&other) == STATUS_SUCCESS);
+    assert(b_array_push_many(&other, elems, 100) == STATUS_SUCCESS);
+    assert(b_array_append(&arr, &other) == STATUS_SUCCESS);
+    assert(arr.len == 105 && arr.data[5] == elems[0]);
+    assert(other.cap == 0);
+    b_array_deinit(&arr);
+
+    // A custom destructor sees every removed element exactly once.
+    arr = (BeanArray){0};
+    assert(b_array_init(&arr) == STATUS_SUCCESS);
+    assert(b_array_set_free_fn(&arr, countFree) == STATUS_SUCCESS);
+    assert(b_array_push_many(&arr, elems, 100) == STATUS_SUCCESS);
+    assert(b_array_remove_range(&arr, 0, 10) == STATUS_SUCCESS);
+    assert(freedElems == 10);
+    assert(b_array_pop(&arr) == STATUS_SUCCESS && freedElems == 11);
+    assert(b_array_truncate(&arr, 50) == STATUS_SUCCESS && freedElems == 50);
+    b_array_deinit(&arr);
+    assert(freedElems == 100);
+
+    // Without one, elements are still freed.
+    arr = (BeanArray){0};
+    assert(b_array_init(&arr) == STATUS_SUCCESS);
+    owned = malloc(sizeof(int));
+    assert(b_array_push(&arr, owned) == STATUS_SUCCESS);
+    assert(b_array_truncate(&arr, 0) == STATUS_SUCCESS);
+    b_array_deinit(&arr);
+}
+
+void Test_growthPolicies(void) {
+    BeanGrowthPolicy policy = {0};
+    BeanArray arr = {0};
+    BeanString str = {0};
+    int value = 0;
+    size_t reallocs = 0;
+    size_t cap;
+
+    assert(b_growth_next(&policy, 8, 9, 8) == 16);
+    assert(b_growth_next(&policy, 8, 100, 8) == 100);
+    assert(b_growth_next(&policy, 8, 8, 8) == 8);
+    policy.growth = GROWTH_GEOMETRIC_1_5X;
+    assert(b_growth_next(&policy, 8, 9, 8) == 12);
+    assert(b_growth_next(&policy, 1, 2, 8) == 2);
+    policy.growth = GROWTH_EXACT;
+    assert(b_growth_next(&policy, 8, 9, 8) == 9);
+
+    // Large buffers grow by half, rounded up to whole pages.
+    policy.growth = GROWTH_PAGE_ROUNDED;
+    assert(b_growth_next(&policy, 64, 65, 8) == 128);
+    cap = b_growth_next(&policy, 30000, 30001, 3);
+    assert(cap >= 45000 && cap * 3 % _BEAN_GROWTH_PAGE_SIZE < 3);
+    assert((cap - 1) * 3 < 45000 * 3 + _BEAN_GROWTH_PAGE_SIZE);
+
+    assert(b_growth_shrink(&policy, 3, 16, 8) == 8);
+    assert(b_growth_shrink(&policy, 4, 16, 8) == 16);
+    assert(b_growth_shrink(&policy, 0, 16, 12) == 12);
+    policy.shrink = SHRINK_EXPLICIT;
+    assert(b_growth_shrink(&policy, 0, 16, 8) == 16);
+
+    // A push/pop loop across a capacity boundary settles after one growth.
+    assert(b_array_init(&arr) == STATUS_SUCCESS);
+    assert(b_array_set_free_fn(&arr, b_array_free_nothing) == STATUS_SUCCESS);
+    while (arr.len < 64)
+        assert(b_array_push(&arr, &value) == STATUS_SUCCESS);
+    assert(arr.cap == 64);
+
+    for (int i = 0; i < 1000; i++) {
+        cap = arr.cap;
+        assert(b_array_push(&arr, &value) == STATUS_SUCCESS);
+        assert(b_array_pop(&arr) == STATUS_SUCCESS);
+        reallocs += arr.cap != cap;
+    }
+    assert(reallocs == 1 && arr.cap == 128);
+
+    // Hysteresis only gives memory back well below the boundary.
+    while (arr.len > 32)
+        assert(b_array_pop(&arr) == STATUS_SUCCESS);
+    assert(arr.cap == 128);
+    assert(b_array_truncate(&arr, 31) == STATUS_SUCCESS);
+    assert(b_array_pop(&arr) == STATUS_SUCCESS && arr.cap == 64);
+
+    // Explicit-only shrinking keeps the buffer until asked.
+    policy = (BeanGrowthPolicy){.shrink = SHRINK_EXPLICIT};
+    assert(b_array_set_policy(&arr, policy) == STATUS_SUCCESS);
+    while (arr.len > 0)
+        assert(b_array_pop(&arr) == STATUS_SUCCESS);
+    assert(arr.cap == 64);
+    assert(b_array_push(&arr, &value) == STATUS_SUCCESS);
+    assert(b_array_shrink(&arr) == STATUS_SUCCESS && arr.cap == 1);
+    assert(b_array_shrink(&arr) == STATUS_OPERATION_UNNECESSARY);
+    b_array_deinit(&arr);
+
+    // Strings follow their own policy once they leave the inline buffer.
+    assert(b_string_init(&str) == STATUS_SUCCESS);
+    policy = (BeanGrowthPolicy){.growth = GROWTH_GEOMETRIC_1_5X};
+    assert(b_string_set_policy(&str, policy) == STATUS_SUCCESS);
+    while (str.len <= _BEAN_STRING_INLINE_CAPACITY)
+        assert(b_string_push(&str, 'a') == STATUS_SUCCESS);
+    assert(str.cap == _BEAN_STRING_INLINE_CAPACITY * 3 / 2);
+
+    policy.growth = GROWTH_EXACT;
+    assert(b_string_set_policy(&str, policy) == STATUS_SUCCESS);
+    assert(b_string_push_cstr(&str, "0123456789abcdef") == STATUS_SUCCESS);
+    assert(str.cap == str.len);
+    assert(b_string_shrink(&str) == STATUS_OPERATION_UNNECESSARY);
+    b_string_deinit(&str);
+}
+
+void Test_allocatorStats(void) {
+    const char* longkey = "a key that is too long to be stored inline";
+    BeanStringView key = {.data = longkey, .len = strlen(longkey)};
+    BeanStatsAllocator stats;
+    BeanAllocStats s;
+    BeanArray arr = {0};
+    BeanArray copy = {0};
+    BeanString str = {0};
+    BeanString clone;
+    BeanVec vec = {0};
+    BeanVec slice;
+    BeanHashMap map;
+    BeanArena arena;
+    BeanPool pool;
+    BeanStringBuilder sb;
+    BeanLineReader reader;
+    BeanQueue queue;
+    BeanRing ring;
+    BeanInterner interner;
+    FILE* file = tmpfile();
+    const char* line;
+    size_t len;
+    int value = 7;
+
+    assert(b_allocator_get() == b_allocator_libc());
+    assert(b_stats_allocator_init(&stats, NULL) == STATUS_SUCCESS);
+
+    // Per container: the buffer and the elements are counted separately.
+    assert(b_array_init(&arr) == STATUS_SUCCESS);
+    assert(b_array_set_allocator(&arr, &stats.allocator) == STATUS_SUCCESS);
+    assert(b_array_set_elem_allocator(&arr, &stats.allocator) ==
+           STATUS_SUCCESS);
+    for (int i = 0; i < 100; i++) {
+        int* elem = b_array_alloc_elem(&arr, sizeof(int));
+
+        assert(elem != NULL);
+        *elem = i;
+        assert(b_array_push(&arr, elem) == STATUS_SUCCESS);
+    }
+
+    s = b_stats_allocator_get(&stats, ALLOCTAG_ARRAY);
+    assert(s.allocs == 1 && s.reallocs == 4 && s.moves <= s.reallocs);
+    assert(s.live == 128 * sizeof(void*) && s.peak == s.live);
+    s = b_stats_allocator_get(&stats, ALLOCTAG_ARRAY_ELEM);
+    assert(s.allocs == 100 && s.live == 100 * sizeof(int));
+    assert(b_array_set_allocator(&arr, NULL) == STATUS_INVALID_OPERATION);
+    assert(b_array_set_elem_allocator(&arr, NULL) ==
+           STATUS_INVALID_OPERATION);
+
+    assert(b_array_truncate(&arr, 50) == STATUS_SUCCESS);
+    s = b_stats_allocator_get(&stats, ALLOCTAG_ARRAY_ELEM);
+    assert(s.frees == 50 && s.live == 50 * sizeof(int));
+    assert(s.peak == 100 * sizeof(int));
+
+    // Clones allocate from the source's allocator alone.
+    assert(b_array_clone(&arr, &copy, sizeof(int)) == STATUS_SUCCESS);
+    assert(copy.allocator == &stats.allocator && copy.len == 50);
+    assert(b_stats_allocator_get(&stats, ALLOCTAG_ARRAY).allocs == 2);
+    assert(b_stats_allocator_get(&stats, ALLOCTAG_ARRAY_ELEM).allocs == 150);
+    b_array_deinit(&copy);
+    b_array_deinit(&arr);
+    assert(b_stats_allocator_get(&stats, ALLOCTAG_ARRAY).live == 0);
+    assert(b_stats_allocator_get(&stats, ALLOCTAG_ARRAY_ELEM).live == 0);
+
+    // Globally: containers initialized from now on pick it up.
+    assert(b_allocator_set(&stats.allocator) == STATUS_SUCCESS);
+
+    // Elements pushed from `malloc` still go back to `free`.
+    assert(b_array_init(&arr) == STATUS_SUCCESS);
+    assert(arr.allocator == &stats.allocator);
+    assert(arr.elem_allocator == b_allocator_libc());
+    for (int i = 0; i < 10; i++)
+        assert(b_array_push(&arr, malloc(sizeof(int))) == STATUS_SUCCESS);
+    assert(b_array_pop(&arr) == STATUS_SUCCESS);
+    b_array_deinit(&arr);
+    assert(b_stats_allocator_get(&stats, ALLOCTAG_ARRAY).live == 0);
+    s = b_stats_allocator_get(&stats, ALLOCTAG_ARRAY_ELEM);
+    assert(s.allocs == 150 && s.frees == s.allocs);
+
+    assert(b_string_init_with_cstr(&str, "x") == STATUS_SUCCESS);
+    assert(str.allocator == &stats.allocator);
+    assert(b_stats_allocator_get(&stats, ALLOCTAG_STRING).allocs == 0);
+    for (int i = 0; i < 40; i++)
+        assert(b_string_push(&str, 'x') == STATUS_SUCCESS);
+    s = b_stats_allocator_get(&stats, ALLOCTAG_STRING);
+    assert(s.allocs == 1 && s.live > 41);
+
+    // Clones share the buffer until one of them is written to.
+    clone = b_string_clone(&str);
+    assert(b_stats_allocator_get(&stats, ALLOCTAG_STRING).allocs == 1);
+    assert(b_string_push(&clone, 'y') == STATUS_SUCCESS);
+    assert(b_stats_allocator_get(&stats, ALLOCTAG_STRING).allocs == 2);
+    b_string_deinit(&clone);
+    b_string_deinit(&str);
+    assert(b_stats_allocator_get(&stats, ALLOCTAG_STRING).live == 0);
+
+    assert(b_vec_init(&vec, sizeof(int)) == STATUS_SUCCESS);
+    for (int i = 0; i < 100; i++)
+        assert(b_vec_push(&vec, &i) == STATUS_SUCCESS);
+    s = b_stats_allocator_get(&stats, ALLOCTAG_VEC);
+    assert(s.allocs == 1 && s.reallocs == 4 && s.live == 128 * sizeof(int));
+    b_vec_deinit(&vec);
+
+    // A slice of a vec on another allocator never touches the global one.
+    assert(b_vec_init(&vec, sizeof(int)) == STATUS_SUCCESS);
+    assert(b_vec_set_allocator(&vec, b_allocator_libc()) == STATUS_SUCCESS);
+    for (int i = 0; i < 10; i++)
+        assert(b_vec_push(&vec, &i) == STATUS_SUCCESS);
+    s = b_stats_allocator_get(&stats, ALLOCTAG_VEC);
+    assert(b_vec_slice(&vec, &slice, 2, 8) == STATUS_SUCCESS);
+    assert(slice.allocator == b_allocator_libc() && slice.len == 6);
+    assert(b_stats_allocator_get(&stats, ALLOCTAG_VEC).allocs == s.allocs);
+    b_vec_deinit(&slice);
+    b_vec_deinit(&vec);
+
+    // Map keys come from the map's allocator too.
+    assert(b_hashmap_init(&map, sizeof(int)) == STATUS_SUCCESS);
+    assert(b_hashmap_insert(&map, &key, &value) == STATUS_SUCCESS);
+    assert(*(int*)b_hashmap_get(&map, &key) == 7);
+    assert(b_stats_allocator_get(&stats, ALLOCTAG_HASHMAP).allocs == 1);
+    assert(b_stats_allocator_get(&stats, ALLOCTAG_STRING).allocs == 3);
+    b_hashmap_deinit(&map);
+    assert(b_stats_allocator_get(&stats, ALLOCTAG_HASHMAP).live == 0);
+    assert(b_stats_allocator_get(&stats, ALLOCTAG_STRING).live == 0);
+
+    assert(b_arena_init(&arena) == STATUS_SUCCESS);
+    assert(b_arena_alloc(&arena, 100) != NULL);
+    assert(b_arena_set_allocator(&arena, NULL) == STATUS_INVALID_OPERATION);
+    assert(b_stats_allocator_get(&stats, ALLOCTAG_ARENA).allocs == 1);
+    b_arena_deinit(&arena);
+
+    assert(b_pool_init(&pool, sizeof(int)) == STATUS_SUCCESS);
+    assert(b_pool_alloc(&pool) != NULL);
+    assert(b_stats_allocator_get(&stats, ALLOCTAG_POOL).allocs == 1);
+    b_pool_deinit(&pool);
+
+    // Builders, line readers, queues, rings and interners too.
+    assert(b_strbuilder_init(&sb) == STATUS_SUCCESS);
+    assert(b_strbuilder_append_cstr(&sb, longkey) == STATUS_SUCCESS);
+    assert(b_stats_allocator_get(&stats, ALLOCTAG_BUILDER).allocs == 1);
+    b_strbuilder_deinit(&sb);
+
+    assert(file != NULL && fputs(longkey, file) >= 0);
+    rewind(file);
+    assert(b_linereader_init_with_size(&reader, file, 8) == STATUS_SUCCESS);
+    assert(b_linereader_next(&reader, &line, &len) == STATUS_SUCCESS);
+    assert(len == strlen(longkey));
+    s = b_stats_allocator_get(&stats, ALLOCTAG_LINEREADER);
+    assert(s.allocs == 1 && s.reallocs > 0);
+    b_linereader_deinit(&reader);
+    fclose(file);
+
+    assert(b_queue_init(&queue, 8) == STATUS_SUCCESS);
+    assert(b_ring_init(&ring, 8) == STATUS_SUCCESS);
+    assert((uintptr_t)queue.cells % _BEAN_QUEUE_CACHE_LINE == 0);
+    assert(b_stats_allocator_get(&stats, ALLOCTAG_QUEUE).allocs == 2);
+    b_ring_deinit(&ring);
+    b_queue_deinit(&queue);
+
+    assert(b_interner_init(&interner) == STATUS_SUCCESS);
+    assert(b_interner_intern_cstr(&interner, longkey) != NULL);
+    assert(b_stats_allocator_get(&stats, ALLOCTAG_INTERNER).allocs ==
+           1 + _BEAN_INTERNER_SHARDS);
+    b_interner_deinit(&interner);
+
+    for (int tag = ALLOCTAG_BUILDER; tag <= ALLOCTAG_INTERNER; tag++)
+        assert(b_stats_allocator_get(&stats, (b_alloctag_t)tag).live == 0);
+
+    assert(b_allocator_set(NULL) == STATUS_SUCCESS);
+    assert(b_allocator_get() == b_allocator_libc());
+
+    s = b_stats_allocator_total(&stats);
+    assert(s.live == 0 && s.allocs == s.frees);
+    assert(strcmp(b_alloctag_name(ALLOCTAG_HASHMAP), "hashmap") == 0);
+    b_stats_allocator_dump(&stats, LOGLEVEL_LOG);
+}
+
+void* traceWorker(void* arg) {
+    size_t count = *(size_t*)arg;
+
+    for (size_t i = 0; i < count; i++) {
+        uint64_t now = b_trace_now();
+        b_trace_record("worker span", now, now + 1500);
+    }
+
+    return NULL;
+}
+
+void Test_trace(void) {
+    size_t count = 3;
+    size_t overflow = _BEAN_TRACE_BUFFER_EVENTS + 5;
+    pthread_t thread;
+    FILE* file = tmpfile();
+    BeanString json;
+    const char* data;
+    size_t spans = 0;
+    size_t len;
+    uint64_t start;
+
+    assert(file != NULL);
+    assert(b_trace_clear() == STATUS_SUCCESS);
+    assert(b_trace_len() == 0);
+
+    start = b_trace_now();
+    {
+        // Recorded only when built with `BEAN_TRACE`.
+        B_TRACE_SCOPE("test scope");
+        b_trace_record("a \"quoted\" span", start, start + 2000);
+    }
+    assert(b_trace_now() >= start);
+
+    pthread_create(&thread, NULL, traceWorker, &count);
+    pthread_join(thread, NULL);
+    assert((len = b_trace_len()) >= 4 && b_trace_dropped() == 0);
+
+    // Reading the export back is traced too, so count before.
+    assert(b_trace_export(file) == STATUS_SUCCESS);
+    rewind(file);
+    json = b_file_read(file);
+    data = b_string_data(&json);
+
+    // One complete event per span, with names escaped.
+    assert(strncmp(data, "{\"displayTimeUnit\": \"ns\"", 24) == 0);
+    for (const char* p = data; (p = strstr(p, "\"ph\": \"X\"")) != NULL; p++)
+        spans++;
+    assert(spans == len);
+    assert(strstr(data, "\"name\": \"a \\\"quoted\\\" span\"") != NULL);
+    assert(strstr(data, "\"dur\": 2.000") != NULL);
+    assert(strstr(data, "\"dur\": 1.500") != NULL);
+    assert(strcmp(&data[json.len - 4], "\n]}\n") == 0);
+    b_string_deinit(&json);
+    fclose(file);
+
+    // Spans past a thread's buffer are counted, not recorded.
+    assert(b_trace_clear() == STATUS_SUCCESS);
+    pthread_create(&thread, NULL, traceWorker, &overflow);
+    pthread_join(thread, NULL);
+    assert(b_trace_dropped() == 5);
+    assert(b_trace_len() >= _BEAN_TRACE_BUFFER_EVENTS);
+    assert(b_trace_clear() == STATUS_SUCCESS);
+}
+
 int main(void) {
     RUNTEST("Are tests working", Test_areTestsWorking);
     RUNTEST("realloc pointer addresses", Test_reallocPointerAddresses);
+    RUNTEST("contiguous vector", Test_vecContiguous);
+    RUNTEST("arena-backed containers", Test_arenaContainers);
+    RUNTEST("pool-backed array", Test_poolBackedArray);
+    RUNTEST("small string optimization", Test_stringSmallBuffer);
+    RUNTEST("chunked string builder", Test_stringBuilder);
+    RUNTEST("bulk and mapped file reads", Test_fileReadAndMap);
+    RUNTEST("buffered line reader", Test_lineReader);
+    RUNTEST("vectored writes", Test_fileWriteMany);
+    RUNTEST("asynchronous logger", Test_asyncLogger);
+    RUNTEST("log flush under load", Test_logFlushUnderLoad);
+    RUNTEST("binary logger", Test_binaryLogger);
+    RUNTEST("string search kernels", Test_stringSearch);
+    RUNTEST("string views and splitting", Test_stringView);
+    RUNTEST("swiss table hash map", Test_hashMap);
+    RUNTEST("seeded and streaming hashing", Test_hashing);
+    RUNTEST("concurrent string interning", Test_interner);
+    RUNTEST("array sorting and searching", Test_arraySort);
+    RUNTEST("work-stealing thread pool", Test_threadPool);
+    RUNTEST("parallel view algorithms", Test_parallelAlgorithms);
+    RUNTEST("lock-free queues", Test_queues);
+    RUNTEST("copy-on-write string clones", Test_stringCopyOnWrite);
+    RUNTEST("array range operations", Test_arrayRanges);
+    RUNTEST("growth and shrink policies", Test_growthPolicies);
+    RUNTEST("allocator hooks and statistics", Test_allocatorStats);
+    RUNTEST("scoped tracing", Test_trace);
 }
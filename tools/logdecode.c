@@ -0,0 +1,42 @@
+/* beanutils: Some data structure implementations and utility functions, I
+ * guess.
+ *
+ * Copyright (c) Eason Qin, 2024.
+ *
+ * NOTE: This source code form is licensed under the MIT license and comes
+ * with ABSOLUTELY NO WARRANTY. For more information, please view the
+ * `LICENSE` file at the root of the project.
+ */
+
+// Turns a binary log written with `LOGFORMAT_BINARY` back into text.
+//
+// usage: beanutils_logdecode [FILE]
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "beanutils/beanutils.h"
+
+int main(int argc, char** argv) {
+    FILE* input = stdin;
+    b_errno_t stat;
+
+    if (argc > 2) {
+        fprintf(stderr, "usage: %s [FILE]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (argc == 2 && (input = fopen(argv[1], "rb")) == NULL) {
+        perror(argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    stat = b_log_decode(input, stdout);
+    if (stat != STATUS_SUCCESS)
+        fprintf(stderr, "%s: not a valid binary log\n", argv[0]);
+
+    if (input != stdin)
+        fclose(input);
+
+    return stat == STATUS_SUCCESS ? EXIT_SUCCESS : EXIT_FAILURE;
+}